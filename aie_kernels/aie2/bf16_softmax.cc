@@ -1,4 +1,5 @@
 #include <aie_api/aie.hpp>
+#include <lut_based_ops.h>
 #include <stdint.h>
 
 void softmax_simple_bf16(bfloat16 *restrict input_vector,
@@ -50,11 +51,84 @@ void softmax_simple_bf16(bfloat16 *restrict input_vector,
   return;
 }
 
+// Vectorized softmax of `vector_size` elements, a multiple of 16. The maximum
+// is subtracted before exponentiating for numerical stability, the exponent
+// is taken from the lookup tables of lut_based_ops and the exponentials are
+// scaled by the reciprocal of their sum.
+void softmax_vec_bf16(bfloat16 *restrict input_vector,
+                      bfloat16 *restrict output_vector,
+                      const int32_t vector_size) {
+  constexpr int vec_len = 16;
+
+  aie::vector<bfloat16, vec_len> max_vec = aie::load_v<vec_len>(input_vector);
+  for (int32_t i = vec_len; i < vector_size; i += vec_len)
+    chess_prepare_for_pipelining chess_loop_range(1, ) {
+      max_vec = aie::max(max_vec, aie::load_v<vec_len>(input_vector + i));
+    }
+  aie::vector<bfloat16, vec_len> max_bcast =
+      aie::broadcast<bfloat16, vec_len>(aie::reduce_max(max_vec));
+
+  // First pass: exp(x - max), accumulating the sum
+  aie::accum<accfloat, vec_len> sum_acc = aie::zeros<accfloat, vec_len>();
+  for (int32_t i = 0; i < vector_size; i += vec_len)
+    chess_prepare_for_pipelining chess_loop_range(1, ) {
+      aie::accum<accfloat, vec_len> x;
+      x.from_vector(aie::load_v<vec_len>(input_vector + i));
+      x = aie::sub(x, max_bcast);
+      aie::accum<accfloat, vec_len> exp_acc =
+          getExpBf16(x.to_vector<bfloat16>());
+      aie::vector<bfloat16, vec_len> exp_vec = exp_acc.to_vector<bfloat16>();
+      aie::store_v(output_vector + i, exp_vec);
+      sum_acc = aie::add(sum_acc, exp_vec);
+    }
+
+  // Second pass: normalize. The maximum contributes exp(0) = 1 to the sum,
+  // so the sum is never zero.
+  float sum = aie::reduce_add(sum_acc.to_vector<float>());
+  bfloat16 inv_sum = (bfloat16)(1.0f / sum);
+  for (int32_t i = 0; i < vector_size; i += vec_len)
+    chess_prepare_for_pipelining chess_loop_range(1, ) {
+      aie::vector<bfloat16, vec_len> exp_vec =
+          aie::load_v<vec_len>(output_vector + i);
+      aie::store_v(output_vector + i,
+                   aie::mul(exp_vec, inv_sum).to_vector<bfloat16>());
+    }
+  return;
+}
+
+// Softmax of each of the `num_rows` rows of `row_size` elements of a row-major
+// matrix, e.g. the attention scores of a block of queries.
+void softmax_rows_vec_bf16(bfloat16 *restrict input,
+                           bfloat16 *restrict output, const int32_t num_rows,
+                           const int32_t row_size) {
+  for (int32_t r = 0; r < num_rows; r++)
+    softmax_vec_bf16(input + r * row_size, output + r * row_size, row_size);
+  return;
+}
+
 extern "C" {
 
 void softmax_bf16(bfloat16 *restrict input, bfloat16 *restrict output,
                   const int32_t input_size) {
+  if (input_size % 16 == 0)
+    softmax_vec_bf16(input, output, input_size);
+  else
+    softmax_simple_bf16(input, output, input_size);
+}
+
+void softmax_scalar_bf16(bfloat16 *restrict input, bfloat16 *restrict output,
+                         const int32_t input_size) {
   softmax_simple_bf16(input, output, input_size);
 }
 
+void softmax_rows_bf16(bfloat16 *restrict input, bfloat16 *restrict output,
+                       const int32_t num_rows, const int32_t row_size) {
+  if (row_size % 16 == 0)
+    softmax_rows_vec_bf16(input, output, num_rows, row_size);
+  else
+    for (int32_t r = 0; r < num_rows; r++)
+      softmax_simple_bf16(input + r * row_size, output + r * row_size,
+                          row_size);
+}
+
 } // extern "C"
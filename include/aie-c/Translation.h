@@ -36,6 +36,11 @@ aieTranslateToCDODirect(MlirOperation moduleOp, MlirStringRef workDirPath,
                         bool aieSim, bool xaieDebug, bool enableCores);
 MLIR_CAPI_EXPORTED MlirOperation aieTranslateBinaryToTxn(MlirContext ctx,
                                                          MlirStringRef binary);
+// Decode the trace words of `trace`, in little endian, of the design
+// `moduleOp` into a Chrome/Perfetto JSON trace written to `outputFilename`.
+MLIR_CAPI_EXPORTED MlirLogicalResult
+aieDecodeTrace(MlirOperation moduleOp, MlirStringRef trace,
+               MlirStringRef outputFilename, int colShift);
 
 struct AieRtControl {
   void *ptr;
@@ -26,6 +26,9 @@ createConvertAIEToTransactionPass();
 std::unique_ptr<mlir::OperationPass<xilinx::AIE::DeviceOp>>
 createConvertAIEToControlPacketsPass();
 
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
+createConvertAIEToTransactionDeltaPass();
+
 std::optional<mlir::ModuleOp>
 convertTransactionBinaryToMLIR(mlir::MLIRContext *ctx,
                                std::vector<uint8_t> &binary);
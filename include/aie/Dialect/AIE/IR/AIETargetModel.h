@@ -217,6 +217,10 @@ public:
   virtual bool isBdChannelAccessible(int col, int row, uint32_t bd_id,
                                      int channel) const = 0;
 
+  /// Return the number of tasks the task queue of a DMA channel in the given
+  /// tile holds, or 0 if the channels have no task queue.
+  virtual uint32_t getDMATaskQueueDepth(int col, int row) const = 0;
+
   virtual uint32_t getNumMemTileRows() const = 0;
   /// Return the size (in bytes) of a MemTile.
   virtual uint32_t getMemTileSize() const = 0;
@@ -310,6 +314,9 @@ public:
                              int channel) const override {
     return true;
   }
+  uint32_t getDMATaskQueueDepth(int col, int row) const override {
+    return 0;
+  }
   uint32_t getNumMemTileRows() const override { return 0; }
   uint32_t getMemTileSize() const override { return 0; }
   uint32_t getNumBanks(int col, int row) const override { return 4; }
@@ -394,6 +401,10 @@ public:
     }
   }
 
+  uint32_t getDMATaskQueueDepth(int col, int row) const override {
+    return 4;
+  }
+
   uint32_t getMemTileSize() const override { return 0x00080000; }
 
   uint32_t getNumBanks(int col, int row) const override {
@@ -0,0 +1,70 @@
+//===- AIEBufferAccessAnalysis.h --------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef AIE_BUFFER_ACCESS_ANALYSIS_H
+#define AIE_BUFFER_ACCESS_ANALYSIS_H
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+
+namespace xilinx::AIE {
+
+// Finds the buffers that may be accessed at the same time by different
+// agents of the array: the cores and the DMA channels. Two such buffers
+// stall each other when they share a memory bank.
+//
+// A core accesses a buffer wherever it uses it inside its body; a DMA
+// channel accesses the buffers of the dma_bds it runs. Each access is
+// guarded by the locks acquired around it (use_lock acquires preceding it
+// in the core body, or in the block of the dma_bd). Accesses by the same
+// agent are sequential. Accesses by two agents are concurrent unless they
+// share a guard lock that excludes them, which is only the case for the
+// binary locks of AIE1: AIE2 locks are semaphores that a producer and a
+// consumer acquire on separate locks.
+class BufferAccessAnalysis {
+public:
+  BufferAccessAnalysis(DeviceOp device);
+
+  // Returns the number of pairs of concurrent accesses to `a` and `b`, or 0
+  // if the two buffers are never accessed at the same time.
+  int getConflictWeight(BufferOp a, BufferOp b) const;
+
+  bool mayConflict(BufferOp a, BufferOp b) const {
+    return getConflictWeight(a, b) > 0;
+  }
+
+  // Returns the pairs of buffers of `tile` that are placed in the same bank
+  // and may be accessed at the same time. The bank of a buffer is derived
+  // from its address.
+  llvm::SmallVector<std::pair<BufferOp, BufferOp>>
+  getBankConflicts(TileOp tile) const;
+
+private:
+  struct Access {
+    // the core or the DMA channel (dma_start or aie.dma op) accessing
+    mlir::Operation *agent;
+    llvm::SmallVector<LockOp, 2> guards;
+  };
+
+  void addCoreAccesses(CoreOp core);
+  void addDMAAccesses(DMABDOp bd, mlir::Operation *channel);
+  bool areConcurrent(const Access &a, const Access &b) const;
+
+  DeviceOp device;
+  // whether a lock held by one agent excludes every other agent
+  bool binaryLocks;
+  llvm::DenseMap<BufferOp, llvm::SmallVector<Access>> accesses;
+};
+
+} // namespace xilinx::AIE
+
+#endif
@@ -16,7 +16,9 @@
 
 #include <algorithm>
 #include <iostream>
+#include <limits>
 #include <list>
+#include <optional>
 #include <set>
 
 namespace xilinx::AIE {
@@ -27,6 +29,7 @@ namespace xilinx::AIE {
 #define DEMAND_BASE 1.0
 #define MAX_CIRCUIT_STREAM_CAPACITY 1
 #define MAX_PACKET_STREAM_CAPACITY 32
+#define ASTAR_INITIAL_MARGIN 1
 
 enum class Connectivity { INVALID = 0, AVAILABLE = 1 };
 
@@ -69,16 +72,20 @@ using SwitchboxConnect = struct SwitchboxConnect {
                       std::vector<bool>(dstPorts.size(), false));
   }
 
+  // demand of a Channel from its history and congestion alone, without the
+  // bumps within an iteration, which make the channels of priority flows
+  // infinitely expensive
+  double getBaseDemand(size_t i, size_t j) const {
+    double history = DEMAND_BASE + OVER_CAPACITY_COEFF * overCapacity[i][j];
+    double congestion = DEMAND_BASE + USED_CAPACITY_COEFF * usedCapacity[i][j];
+    return history * congestion;
+  }
+
   // update demand at the beginning of each dijkstraShortestPaths iteration
   void updateDemand() {
-    for (size_t i = 0; i < srcPorts.size(); i++) {
-      for (size_t j = 0; j < dstPorts.size(); j++) {
-        double history = DEMAND_BASE + OVER_CAPACITY_COEFF * overCapacity[i][j];
-        double congestion =
-            DEMAND_BASE + USED_CAPACITY_COEFF * usedCapacity[i][j];
-        demand[i][j] = history * congestion;
-      }
-    }
+    for (size_t i = 0; i < srcPorts.size(); i++)
+      for (size_t j = 0; j < dstPorts.size(); j++)
+        demand[i][j] = getBaseDemand(i, j);
   }
 
   // Inside each dijkstraShortestPaths interation, bump demand when exceeds
@@ -122,6 +129,55 @@ using PathEndPoint = struct PathEndPoint {
   }
 };
 
+// A dense, index-based view of the routing graph used by the shortest path
+// search. Every (tile, port) end point is numbered once, in PathEndPoint order,
+// and the channels leaving each end point are stored in CSR form. Each channel
+// keeps the SwitchboxConnect matrix entry holding its demand and capacity, so
+// relaxing an edge needs neither a map lookup nor a port search.
+using RoutingGraph = struct RoutingGraph {
+  using NodeID = uint32_t;
+  static constexpr size_t NO_CHANNEL = std::numeric_limits<size_t>::max();
+
+  using Channel = struct Channel {
+    NodeID src, dst;
+    // the channel is sb->srcPorts[i] -> sb->dstPorts[j]
+    SwitchboxConnect *sb;
+    uint32_t i, j;
+  };
+
+  // end points, sorted, indexed by NodeID
+  std::vector<PathEndPoint> nodes;
+  // channels leaving nodes[n] are channels[offsets[n]] to
+  // channels[offsets[n + 1] - 1], sorted by destination
+  std::vector<size_t> offsets;
+  std::vector<Channel> channels;
+
+  size_t numNodes() const { return nodes.size(); }
+
+  std::optional<NodeID> lookup(const PathEndPoint &endPoint) const {
+    auto it = std::lower_bound(nodes.begin(), nodes.end(), endPoint);
+    if (it == nodes.end() || !(*it == endPoint))
+      return std::nullopt;
+    return static_cast<NodeID>(std::distance(nodes.begin(), it));
+  }
+
+  llvm::ArrayRef<Channel> outgoing(NodeID n) const {
+    return llvm::ArrayRef<Channel>(channels).slice(
+        offsets[n], offsets[n + 1] - offsets[n]);
+  }
+
+  // Index of the channel from src to dst, if there is one
+  std::optional<size_t> findChannel(NodeID src, NodeID dst) const {
+    auto out = outgoing(src);
+    auto it = std::lower_bound(
+        out.begin(), out.end(), dst,
+        [](const Channel &channel, NodeID n) { return channel.dst < n; });
+    if (it == out.end() || it->dst != dst)
+      return std::nullopt;
+    return offsets[src] + std::distance(out.begin(), it);
+  }
+};
+
 using Flow = struct Flow {
   int packetGroupId;
   bool isPriorityFlow;
@@ -129,6 +185,76 @@ using Flow = struct Flow {
   std::vector<PathEndPoint> dsts;
 };
 
+// A flow together with the channels of its route, in the order they were
+// traced back from its destinations. A route to self is recorded as
+// std::nullopt. Used to seed incremental routing with a previous solution.
+using RoutedFlow = struct RoutedFlow {
+  using RoutedChannel = std::pair<PathEndPoint, PathEndPoint>;
+  PathEndPoint src;
+  std::vector<PathEndPoint> dsts;
+  std::vector<std::optional<RoutedChannel>> channels;
+};
+
+// Congestion statistics of the last findPaths, written out as the routing
+// report of aie-create-pathfinder-flows.
+using RoutingReport = struct RoutingReport {
+  // The state of the negotiation at the end of one iteration
+  using Iteration = struct Iteration {
+    // channels used beyond their capacity
+    int overCapacityChannels = 0;
+    // sum of the over capacity history of all channels
+    int overCapacityHistory = 0;
+    // largest base demand of a channel used by a flow
+    double maxDemand = 0.0;
+    // channels between switchboxes used by all flows
+    int pathLength = 0;
+  };
+
+  // A channel used by the final routing, and the flows through it
+  using ChannelUsage = struct ChannelUsage {
+    PathEndPoint src, dst;
+    // base demand, see SwitchboxConnect::getBaseDemand
+    double demand = 0.0;
+    int overCapacity = 0;
+    int circuitFlows = 0;
+    // packet flows sharing the channel by arbitration, and their groups
+    int packetFlows = 0;
+    int packetGroups = 0;
+  };
+
+  // Ports of one switchbox used by the final routing
+  using SwitchboxUsage = struct SwitchboxUsage {
+    TileID coords;
+    // output ports of the switchbox and how many of them are used
+    int numPorts = 0;
+    int usedPorts = 0;
+    // channels to the neighboring switchboxes and how many of them are used
+    int numLinks = 0;
+    int usedLinks = 0;
+    // most packet flows sharing one of its channels
+    int maxPacketSharing = 0;
+    // sum of the over capacity history of its channels
+    int overCapacity = 0;
+  };
+
+  using FlowLength = struct FlowLength {
+    PathEndPoint src;
+    bool isPacketFlow = false;
+    // the flow kept its route from the previous routing solution
+    bool reused = false;
+    // channels between switchboxes used by the flow, shared by its
+    // destinations
+    int hops = 0;
+    // channels between switchboxes from the source to each destination
+    std::vector<std::pair<PathEndPoint, int>> dsts;
+  };
+
+  std::vector<Iteration> iterations;
+  std::vector<SwitchboxUsage> switchboxes;
+  std::vector<ChannelUsage> channels;
+  std::vector<FlowLength> flows;
+};
+
 // A SwitchSetting defines the required settings for a Switchbox for a flow
 // SwitchSetting.srcs is the fanin
 // SwitchSetting.dsts is the fanout
@@ -194,6 +320,22 @@ public:
   virtual bool addFixedConnection(SwitchboxOp switchboxOp) = 0;
   virtual std::optional<std::map<PathEndPoint, SwitchSettings>>
   findPaths(int maxIterations) = 0;
+  // Route independent flows concurrently on the thread pool of context,
+  // with the same result as routing serially. Routers without a parallel
+  // mode ignore this.
+  virtual void enableParallelRouting(mlir::MLIRContext *context) {}
+  // Route with an A* search restricted to a bounding box around each flow.
+  // Routers without an A* mode ignore this.
+  virtual void enableAStarRouting() {}
+  // Seed incremental routing: a flow with the same source and destinations
+  // as a prior flow starts out on its route, and is only rerouted if that
+  // route is no longer available or conflicts with other flows.
+  virtual void addPriorRoute(const RoutedFlow &routedFlow) {}
+  // The routes found by the last successful findPaths.
+  virtual std::vector<RoutedFlow> getRoutedFlows() const { return {}; }
+  // Congestion statistics of the last findPaths. The channels, switchboxes
+  // and flows are only filled in if it succeeded.
+  virtual RoutingReport getRoutingReport() const { return {}; }
 };
 
 class Pathfinder : public Router {
@@ -207,9 +349,59 @@ public:
   bool addFixedConnection(SwitchboxOp switchboxOp) override;
   std::optional<std::map<PathEndPoint, SwitchSettings>>
   findPaths(int maxIterations) override;
-  std::map<PathEndPoint, PathEndPoint> dijkstraShortestPaths(PathEndPoint src);
+  void enableParallelRouting(mlir::MLIRContext *context) override {
+    parallelContext = context;
+  }
+  void enableAStarRouting() override { aStarRouting = true; }
+  void addPriorRoute(const RoutedFlow &routedFlow) override {
+    priorRoutes[{routedFlow.src, routedFlow.dsts}] = routedFlow;
+  }
+  std::vector<RoutedFlow> getRoutedFlows() const override {
+    return routedFlows;
+  }
+  RoutingReport getRoutingReport() const override { return report; }
+  // Number the end points of `graph` and build its CSR adjacency.
+  void buildRoutingGraph();
+  // Returns, for every node, the index of the channel used to reach it on the
+  // shortest path from src (RoutingGraph::NO_CHANNEL if unreached).
+  std::vector<size_t> dijkstraShortestPaths(RoutingGraph::NodeID src) const;
+  // Returns the predecessor channels of an A* search from src towards dst
+  // (RoutingGraph::NO_CHANNEL if unreached). searchMargin bounds the search
+  // and is widened until dst is reached.
+  std::vector<size_t> aStarShortestPath(RoutingGraph::NodeID src,
+                                        RoutingGraph::NodeID dst,
+                                        int &searchMargin) const;
+  int widenSearchMargin(int searchMargin) const;
 
 private:
+  // The channels used by a flow, in the order they are traced back from its
+  // destinations. A route to self is recorded as RoutingGraph::NO_CHANNEL.
+  using Route = std::vector<size_t>;
+  std::optional<Route> findRoute(const Flow &flow, int &searchMargin) const;
+  SwitchSettings commitRoute(const Flow &flow, const Route &route);
+  // The route of the prior flow matching flow, if all its channels exist
+  std::optional<Route> findPriorRoute(const Flow &flow) const;
+  RoutedFlow toRoutedFlow(const Flow &flow, const Route &route) const;
+  // Fill in the report from the final routes of the flows, and whether they
+  // are still pinned to their prior route
+  void reportRoutes(const std::vector<const Flow *> &flows,
+                    const std::vector<Route> &routes,
+                    const std::vector<std::optional<Route>> &pinnedRoutes);
+
+  // Routes of a previous solution, keyed by flow source and destinations
+  std::map<std::pair<PathEndPoint, std::vector<PathEndPoint>>, RoutedFlow>
+      priorRoutes;
+  // Routes of the last successful findPaths
+  std::vector<RoutedFlow> routedFlows;
+  // Congestion statistics of the last findPaths
+  RoutingReport report;
+
+  // Set when flows with disjoint search boxes are routed in parallel
+  mlir::MLIRContext *parallelContext = nullptr;
+  // Use A* instead of Dijkstra's shortest path search
+  bool aStarRouting = false;
+  // The largest tile coordinates of the array
+  TileID maxCoords = {0, 0};
   // Flows to be routed
   std::vector<Flow> flows;
   // Represent all routable paths as a graph
@@ -218,11 +410,9 @@ private:
   // switchbox otherwise, it represents connections (South, North, West, East)
   // accross two switchboxes
   std::map<std::pair<TileID, TileID>, SwitchboxConnect> graph;
-  // Channels available in the network
-  // The key is a PathEndPoint representing the start of a path
-  // The value is a vector of PathEndPoints representing the possible ends of
-  // the path
-  std::map<PathEndPoint, std::vector<PathEndPoint>> channels;
+  // Channels available in the network, indexed by end point; rebuilt from
+  // graph at the start of findPaths
+  RoutingGraph routingGraph;
 };
 
 // DynamicTileAnalysis integrates the Pathfinder class into the MLIR
@@ -235,6 +425,16 @@ public:
   std::shared_ptr<Router> pathfinder;
   std::map<PathEndPoint, SwitchSettings> flowSolutions;
   std::map<PathEndPoint, bool> processedFlows;
+  // Route flows with disjoint search boxes in parallel
+  bool parallelRouting = false;
+  // Route with A* search instead of Dijkstra's algorithm
+  bool aStarRouting = false;
+  // If set, flows are seeded from the solution of the device in this file,
+  // and the new solution of the device is written back to it
+  std::string routingSolutionFile;
+  // If set, the routing report is written to this file, even if routing
+  // fails
+  std::string routingReportFile;
 
   llvm::DenseMap<TileID, TileOp> coordToTile;
   llvm::DenseMap<TileID, SwitchboxOp> coordToSwitchbox;
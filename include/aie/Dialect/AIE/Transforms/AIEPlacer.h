@@ -0,0 +1,125 @@
+//===- AIEPlacer.h ----------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef AIE_PLACER_H
+#define AIE_PLACER_H
+
+#include "aie/Dialect/AIE/IR/AIETargetModel.h"
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+
+#include <map>
+
+namespace xilinx::AIE {
+
+enum class PlacementTileKind { Core, Mem, ShimNOC, ShimPL };
+
+// A tile of the design. Nodes are placed on distinct tiles of their kind.
+struct PlacementNode {
+  PlacementTileKind kind;
+  TileID tile;
+  bool fixed = false;
+  // Bytes of memory used on the tile besides the buffers of the nets, e.g.
+  // by the stack of its core.
+  uint64_t memory = 0;
+};
+
+// A stream from one node to one or more others, e.g. an objectFifo.
+struct PlacementNet {
+  struct Endpoint {
+    unsigned node;
+    // Bytes of the buffers of the net on the node.
+    uint64_t memory = 0;
+    // Whether the endpoint uses a DMA channel of the node.
+    bool usesDMA = true;
+  };
+  Endpoint source;
+  llvm::SmallVector<Endpoint, 1> dests;
+  // Whether the net uses the memory of its source shared with its single
+  // destination instead of the DMAs and a stream when the two nodes are
+  // adjacent core tiles.
+  bool mayShareMemory = false;
+};
+
+struct PlacementCost {
+  // Sum of the half perimeters of the bounding boxes of the streams.
+  unsigned wirelength = 0;
+  // Number of DMA channels used beyond those of the tiles.
+  unsigned channelOverflow = 0;
+  // Bytes used beyond the memory of the tiles.
+  uint64_t memoryOverflow = 0;
+  // Number of streams estimated to go through a switchbox port beyond its
+  // connections.
+  unsigned congestionOverflow = 0;
+
+  double total() const;
+  // A placement is legal if it fits in the DMA channels and the memory of the
+  // tiles. Congestion only makes routing harder.
+  bool isLegal() const { return channelOverflow == 0 && memoryOverflow == 0; }
+};
+
+// Places the nodes of a design by simulated annealing, moving one node to a
+// tile of its kind or swapping two nodes at a time. The cost of a placement
+// combines the wirelength of the streams with penalties for the DMA channels,
+// memory and switchbox connections they need beyond those of the target.
+class TilePlacer {
+public:
+  TilePlacer(const AIETargetModel &targetModel,
+             llvm::SmallVector<PlacementNode> nodes,
+             llvm::SmallVector<PlacementNet> nets);
+
+  // Search `iterations` moves from the current tiles of the nodes for the
+  // placement of the non-fixed nodes of least cost, and keep the best one
+  // found. The search only depends on `seed`.
+  void place(unsigned iterations, unsigned seed);
+
+  llvm::ArrayRef<PlacementNode> getNodes() const { return nodes; }
+
+  PlacementCost evaluate() const;
+
+private:
+  // The resources used by a placement and the resulting cost, which are
+  // updated net by net as nodes move.
+  struct Usage {
+    llvm::SmallVector<unsigned> mm2s, s2mm;
+    llvm::SmallVector<uint64_t> memory;
+    std::map<std::pair<TileID, WireBundle>, unsigned> demand;
+    PlacementCost cost;
+  };
+
+  // Returns true if the net is a stream between adjacent core tiles that
+  // may instead use their shared memory.
+  bool isSharedMemory(const PlacementNet &net) const;
+  // Add the DMA channels and memory of `node` beyond those of its tile to
+  // the cost, or remove them if `remove`.
+  void addNodeOverflow(Usage &usage, unsigned node, bool remove) const;
+  // Add the resources used by net `net` at the current tiles of its nodes,
+  // or remove them if `remove`.
+  void addNet(Usage &usage, unsigned net, bool remove) const;
+  Usage computeUsage() const;
+  // Move `node` to `tile`, swapping it with the node there if any.
+  void move(unsigned node, TileID tile);
+  // Move `node` to `tile` as above and update `usage` from the nets of the
+  // moved nodes only.
+  void move(Usage &usage, unsigned node, TileID tile);
+
+  const AIETargetModel &targetModel;
+  llvm::SmallVector<PlacementNode> nodes;
+  llvm::SmallVector<PlacementNet> nets;
+  llvm::DenseMap<TileID, unsigned> nodeAt;
+  // The nets of each node.
+  llvm::SmallVector<llvm::SmallVector<unsigned>> netsOf;
+};
+
+} // namespace xilinx::AIE
+
+#endif
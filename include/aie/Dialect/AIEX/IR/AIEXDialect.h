@@ -32,6 +32,14 @@ void getHardwareStridesWraps(const AIE::AIETargetModel &targetModel,
                              llvm::SmallVector<int64_t, 4> inputStrides,
                              llvm::SmallVector<int64_t, 4> &sizes,
                              llvm::SmallVector<int64_t, 4> &strides);
+// Returns the widths of the wrap, step and iteration fields of the BDs of the
+// DMA of tile (tileCol, tileRow), or failure for tiles without such a DMA.
+mlir::LogicalResult getStridesWrapsFieldWidths(
+    const AIE::AIETargetModel &targetModel, int tileCol, int tileRow,
+    uint32_t &wrapBits, uint32_t &stepBits, uint32_t &iterBits);
+// Verifies that the access pattern can be expressed in a BD of the DMA of
+// tile (tileCol, tileRow). With skipRangeChecks, only the properties that
+// hold for any split of the pattern into several BDs are verified.
 mlir::LogicalResult
 verifyStridesWraps(mlir::Operation *forOp, mlir::MemRefType referencedBufType,
                    int tileCol, int tileRow,
@@ -39,7 +47,8 @@ verifyStridesWraps(mlir::Operation *forOp, mlir::MemRefType referencedBufType,
                    llvm::SmallVector<int64_t, 4> inputStrides,
                    llvm::SmallVector<int64_t, 4> hardwareSizes,
                    llvm::SmallVector<int64_t, 4> hardwareStrides,
-                   bool skipTransformationChecks = false);
+                   bool skipTransformationChecks = false,
+                   bool skipRangeChecks = false);
 
 } // namespace AIEX
 } // namespace xilinx
@@ -42,6 +42,12 @@ std::unique_ptr<mlir::OperationPass<AIE::DeviceOp>>
 createAIECtrlPacketToDmaPass();
 std::unique_ptr<mlir::OperationPass<AIE::DeviceOp>>
 createAIECtrlPacketInferTilesPass();
+std::unique_ptr<mlir::OperationPass<AIE::DeviceOp>>
+createAIEOptimizeNpuWritesPass();
+std::unique_ptr<mlir::OperationPass<AIE::DeviceOp>>
+createAIEScheduleRuntimeSequencePass();
+std::unique_ptr<mlir::OperationPass<AIE::DeviceOp>>
+createAIESplitAccessPatternsPass();
 
 /// Generate the code for registering passes.
 #define GEN_PASS_REGISTRATION
@@ -211,6 +211,7 @@ struct AIERTControl {
   mlir::LogicalResult initLocks(DeviceOp &targetOp);
   mlir::LogicalResult initBuffers(DeviceOp &targetOp);
   mlir::LogicalResult configureSwitches(DeviceOp &targetOp);
+  mlir::LogicalResult configureDMAs(DeviceOp &targetOp);
   mlir::LogicalResult addInitConfig(DeviceOp &targetOp);
   mlir::LogicalResult addCoreEnable(DeviceOp &targetOp);
   mlir::LogicalResult configureLocksInBdBlock(XAie_DmaDesc &dmaTileBd,
@@ -218,9 +219,13 @@ struct AIERTControl {
                                               XAie_LocType &tileLoc);
   mlir::LogicalResult addAieElf(uint8_t col, uint8_t row,
                                 const mlir::StringRef elfPath, bool aieSim);
+  mlir::LogicalResult addAieElf(CoreOp coreOp, const mlir::StringRef elfPath,
+                                bool aieSim);
   mlir::LogicalResult addAieElfs(DeviceOp &targetOp,
                                  const mlir::StringRef workDirPath,
                                  bool aieSim);
+  mlir::LogicalResult resetTile(uint8_t col, uint8_t row);
+  mlir::LogicalResult resetLocks(uint8_t col, uint8_t row);
   void startTransaction();
   void dmaUpdateBdAddr(int col, int row, size_t addr, size_t bdId);
   void exportSerializedTransaction();
@@ -39,6 +39,9 @@ mlir::LogicalResult AIETranslateToNPU(mlir::ModuleOp module,
                                       llvm::StringRef sequenceName = "");
 mlir::LogicalResult AIETranslateToNPU(mlir::ModuleOp, std::vector<uint32_t> &,
                                       llvm::StringRef sequenceName = "");
+mlir::LogicalResult AIETranslateToNPUBinary(mlir::ModuleOp module,
+                                            llvm::raw_ostream &output,
+                                            llvm::StringRef sequenceName = "");
 mlir::LogicalResult
 AIETranslateControlPacketsToUI32Vec(mlir::ModuleOp module,
                                     llvm::raw_ostream &output,
@@ -0,0 +1,119 @@
+//===- AIETraceDecoder.h ----------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc. All rights reserved.
+//
+//===----------------------------------------------------------------------===//
+//
+// A streaming decoder of AIE2 hardware trace packets into Chrome/Perfetto
+// trace events, as programming_examples/utils/parse_trace.py does, that
+// writes its output as it goes instead of holding the whole trace.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef AIE_TARGETS_AIETRACEDECODER_H
+#define AIE_TARGETS_AIETRACEDECODER_H
+
+#include "aie/Dialect/AIE/IR/AIETargetModel.h"
+
+#include "mlir/IR/BuiltinOps.h"
+
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <array>
+#include <optional>
+#include <set>
+
+namespace xilinx::AIE {
+
+// The packet type in the header of a trace packet, i.e. the module traced.
+enum class TracePacketType {
+  Core,
+  Mem,
+  Shim,
+  MemTile,
+};
+constexpr unsigned kNumTracePacketTypes = 4;
+
+// Number of events a trace unit records at once.
+constexpr unsigned kNumTraceSlots = 8;
+
+// The name of an AIE2 trace event as in python/utils/trace_events_enum.py,
+// or "Unknown".
+llvm::StringRef getTraceEventName(TracePacketType type, uint32_t code);
+
+class TraceDecoder {
+public:
+  // Write the trace events as a JSON array to `os`.
+  TraceDecoder(llvm::raw_ostream &os) : json(os) {}
+
+  // Record the events traced by a tile from a write to one of its trace event
+  // registers. Returns false if `address` is not one.
+  bool configure(int col, int row, uint32_t address, uint32_t value);
+  // Record the events configured by the npu.write32 ops of `module`, adding
+  // `colShift` to their columns.
+  void configure(mlir::ModuleOp module, int colShift = 0);
+
+  // Decode the next word of the trace. The first word also writes the names
+  // of the tiles and events configured.
+  void decode(uint32_t word);
+  void decode(llvm::ArrayRef<uint32_t> words) {
+    for (uint32_t word : words)
+      decode(word);
+  }
+  // Close the JSON array. Commands cut off by the end of the trace are
+  // dropped.
+  void finish();
+
+  uint64_t getNumPackets() const { return numPackets; }
+  uint64_t getNumEvents() const { return numEvents; }
+  // The tiles and packet types that sent packets without trace events
+  // configured, which are not decoded.
+  const std::set<std::pair<TracePacketType, TileID>> &
+  getUnconfiguredStreams() const {
+    return unconfiguredStreams;
+  }
+
+private:
+  // The trace of one module of one tile.
+  struct Stream {
+    TracePacketType type;
+    TileID tile;
+    unsigned pid = 0;
+    std::array<uint8_t, kNumTraceSlots> events{};
+    std::array<llvm::StringRef, kNumTraceSlots> eventNames;
+    // Bytes of a command not yet complete.
+    llvm::SmallVector<uint8_t, 8> pending;
+    uint64_t timer = 0;
+    // The events begun and not ended yet, one bit per slot.
+    uint32_t active = 0;
+  };
+
+  void writeMetadata();
+  void decodeByte(Stream &stream, uint8_t byte);
+  // Update the events of `stream` for a command recording the slots of
+  // `events` after `cycles` cycles.
+  void record(Stream &stream, uint32_t events, uint32_t cycles);
+  void writeEvent(const Stream &stream, unsigned slot, const char *phase);
+
+  llvm::json::OStream json;
+  std::array<llvm::MapVector<TileID, Stream>, kNumTracePacketTypes> streams;
+  std::set<std::pair<TracePacketType, TileID>> unconfiguredStreams;
+  // The stream of the last packet header, if it was configured.
+  Stream *current = nullptr;
+  uint64_t numWords = 0;
+  uint64_t numPackets = 0;
+  uint64_t numEvents = 0;
+  bool started = false;
+};
+
+} // namespace xilinx::AIE
+
+#endif // AIE_TARGETS_AIETRACEDECODER_H
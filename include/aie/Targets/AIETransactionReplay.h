@@ -0,0 +1,108 @@
+//===- AIETransactionReplay.h -----------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc. All rights reserved.
+//
+//===----------------------------------------------------------------------===//
+//
+// A register-level functional model of an NPU, replaying transaction binaries
+// such as the instruction streams of AIETranslateToNPU or the configurations
+// of convert-aie-to-transaction without a device.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef AIE_TARGETS_AIETRANSACTIONREPLAY_H
+#define AIE_TARGETS_AIETRANSACTIONREPLAY_H
+
+#include "aie/Dialect/AIE/IR/AIETargetModel.h"
+
+#include "mlir/Support/LogicalResult.h"
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <array>
+#include <map>
+#include <optional>
+
+namespace xilinx::AIE {
+
+enum class TransactionOpcode {
+  Write,
+  BlockWrite,
+  MaskWrite,
+  Sync,
+  AddressPatch,
+};
+constexpr unsigned kNumTransactionOpcodes = 5;
+
+struct TransactionHeader {
+  uint8_t major, minor;
+  uint8_t numRows, numCols;
+  uint32_t numOps;
+  uint32_t size;
+};
+
+// Parse the header of a transaction binary, or return std::nullopt if `data`
+// is too short to hold one.
+std::optional<TransactionHeader>
+parseTransactionHeader(llvm::ArrayRef<uint8_t> data);
+
+class TransactionReplay {
+public:
+  struct OpcodeCount {
+    uint64_t ops = 0;
+    uint64_t bytes = 0;
+  };
+
+  // The value of a register, and which of its bits were written.
+  struct Register {
+    uint32_t value = 0;
+    uint32_t known = 0;
+  };
+  using TileRegisters = std::map<uint32_t, Register>;
+
+  TransactionReplay(const AIETargetModel &targetModel)
+      : targetModel(targetModel) {}
+
+  // Replay the transaction binary `data` on the registers as the previous
+  // binaries left them. Return failure if the binary is malformed.
+  mlir::LogicalResult replay(llvm::ArrayRef<uint8_t> data);
+
+  // The registers written, by tile and by offset in the tile.
+  const std::map<TileID, TileRegisters> &getRegisters() const {
+    return registers;
+  }
+  const OpcodeCount &getCount(TransactionOpcode opcode) const {
+    return counts[static_cast<unsigned>(opcode)];
+  }
+  // Number of 32-bit register writes, block writes counting for one per word.
+  uint64_t getNumRegisterWrites() const { return numRegisterWrites; }
+  // Number of register writes leaving the register unchanged.
+  uint64_t getNumRedundantWrites() const { return numRedundantWrites; }
+  // Number of register writes all the bits of which are written again.
+  uint64_t getNumOverwrittenWrites() const { return numOverwrittenWrites; }
+
+  // Print the statistics, then the registers of each tile with the BDs and
+  // the locks decoded.
+  void print(llvm::raw_ostream &os) const;
+
+private:
+  void write(uint64_t address, uint32_t value, uint32_t mask);
+
+  const AIETargetModel &targetModel;
+  std::map<TileID, TileRegisters> registers;
+  // The bits of the last write to each register not written again since.
+  std::map<uint64_t, uint32_t> pendingBits;
+  std::array<OpcodeCount, kNumTransactionOpcodes> counts;
+  uint64_t numRegisterWrites = 0;
+  uint64_t numRedundantWrites = 0;
+  uint64_t numOverwrittenWrites = 0;
+};
+
+} // namespace xilinx::AIE
+
+#endif // AIE_TARGETS_AIETRANSACTIONREPLAY_H
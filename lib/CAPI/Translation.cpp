@@ -14,6 +14,7 @@
 #include "aie/Dialect/AIE/IR/AIETargetModel.h"
 #include "aie/Targets/AIERT.h"
 #include "aie/Targets/AIETargets.h"
+#include "aie/Targets/AIETraceDecoder.h"
 
 #include "mlir-c/IR.h"
 #include "mlir-c/Support.h"
@@ -30,6 +31,7 @@
 #include "llvm/Support/raw_ostream.h"
 
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -92,6 +94,31 @@ MlirOperation aieTranslateBinaryToTxn(MlirContext ctx, MlirStringRef binary) {
   return wrap(mod->getOperation());
 }
 
+MlirLogicalResult aieDecodeTrace(MlirOperation moduleOp, MlirStringRef trace,
+                                 MlirStringRef outputFilename, int colShift) {
+  ModuleOp mod = llvm::cast<ModuleOp>(unwrap(moduleOp));
+  std::string errorMessage;
+  auto output = openOutputFile(
+      llvm::StringRef(outputFilename.data, outputFilename.length),
+      &errorMessage);
+  if (!output) {
+    std::cerr << errorMessage << "\n";
+    return wrap(failure());
+  }
+
+  TraceDecoder decoder(output->os());
+  decoder.configure(mod, colShift);
+  for (size_t i = 0; i + sizeof(uint32_t) <= trace.length;
+       i += sizeof(uint32_t)) {
+    uint32_t word;
+    std::memcpy(&word, trace.data + i, sizeof(word));
+    decoder.decode(word);
+  }
+  decoder.finish();
+  output->keep();
+  return wrap(success());
+}
+
 MlirStringRef aieTranslateToNPU(MlirOperation moduleOp) {
   std::string npu;
   llvm::raw_string_ostream os(npu);
@@ -14,7 +14,12 @@
 #include "aie/Targets/AIERT.h"
 
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
 
+#include <array>
+#include <list>
+#include <map>
+#include <set>
 #include <vector>
 
 #define DEBUG_TYPE "aie-convert-to-config"
@@ -39,6 +44,9 @@ struct TransactionBinaryOperation {
     cmd.Size = size;
   }
 };
+
+// Maximum number of data words carried by a control packet.
+constexpr size_t kMaxControlPacketWords = 4;
 } // namespace
 
 // Parse a TXN binary blob. On success return the number of columns from the
@@ -270,8 +278,10 @@ emitControlPacketOps(OpBuilder &builder,
       auto blockWriteDataValues = blockWriteData.getValues<int32_t>();
       // Split block write data into beats of 4 or less, in int32_t.
       int currAddr = op.cmd.RegOff;
-      for (size_t i = 0; i < blockWriteDataValues.size(); i += 4) {
-        auto last = std::min(blockWriteDataValues.size(), i + 4);
+      for (size_t i = 0; i < blockWriteDataValues.size();
+           i += kMaxControlPacketWords) {
+        auto last = std::min(blockWriteDataValues.size(),
+                             i + kMaxControlPacketWords);
         SmallVector<int32_t> splitData =
             SmallVector<int32_t>(blockWriteDataValues.begin() + i,
                                  blockWriteDataValues.begin() + last);
@@ -339,13 +349,88 @@ LogicalResult orConsecutiveWritesOnSameAddr(Block *body) {
   return success();
 }
 
+static std::pair<uint32_t, uint32_t> getTile(AIEX::NpuControlPacketOp op) {
+  return {op.getColumnFromAddr(), op.getRowFromAddr()};
+}
+
+// Group the control packets of `body` by tile, keeping the order of the
+// packets of each tile. Other ops are not moved, nor are packets moved across
+// them.
+static void sortControlPacketsByTile(Block *body) {
+  SmallVector<AIEX::NpuControlPacketOp> segment;
+  auto flush = [&](Operation *before) {
+    llvm::stable_sort(segment, [](auto a, auto b) {
+      return getTile(a) < getTile(b);
+    });
+    for (auto op : segment)
+      op->moveBefore(body, before ? before->getIterator() : body->end());
+    segment.clear();
+  };
+  for (Operation &op : llvm::make_early_inc_range(*body)) {
+    if (auto ctrlPkt = dyn_cast<AIEX::NpuControlPacketOp>(op))
+      segment.push_back(ctrlPkt);
+    else
+      flush(&op);
+  }
+  flush(nullptr);
+}
+
+// Pack runs of consecutive control packets writing contiguous addresses of a
+// tile into as few packets as possible.
+static void packControlPacketBursts(Block *body) {
+  auto isWrite = [](AIEX::NpuControlPacketOp op) {
+    return op.getOpcode() == 0 && op.getData() && !op.getLength();
+  };
+
+  SmallVector<SmallVector<AIEX::NpuControlPacketOp>> runs;
+  AIEX::NpuControlPacketOp prev;
+  for (Operation &op : *body) {
+    auto ctrlPkt = dyn_cast<AIEX::NpuControlPacketOp>(op);
+    if (!ctrlPkt || !isWrite(ctrlPkt)) {
+      prev = nullptr;
+      continue;
+    }
+    bool contiguous =
+        prev && prev.getStreamId() == ctrlPkt.getStreamId() &&
+        getTile(prev) == getTile(ctrlPkt) &&
+        prev.getAddress() + prev.getData()->size() * sizeof(int32_t) ==
+            ctrlPkt.getAddress();
+    if (!contiguous)
+      runs.emplace_back();
+    runs.back().push_back(ctrlPkt);
+    prev = ctrlPkt;
+  }
+
+  for (auto &run : runs) {
+    SmallVector<int32_t> data;
+    for (auto op : run)
+      llvm::append_range(data, *op.getData());
+    size_t numPackets = llvm::divideCeil(data.size(), kMaxControlPacketWords);
+    if (numPackets == run.size())
+      continue;
+    OpBuilder builder(run.front());
+    uint32_t addr = run.front().getAddress();
+    for (size_t i = 0; i < data.size(); i += kMaxControlPacketWords) {
+      ArrayRef<int32_t> words = ArrayRef(data).slice(
+          i, std::min(kMaxControlPacketWords, data.size() - i));
+      builder.create<AIEX::NpuControlPacketOp>(
+          run.front().getLoc(), builder.getUI32IntegerAttr(addr), nullptr,
+          run.front().getOpcodeAttr(), run.front().getStreamIdAttr(),
+          builder.getDenseI32ArrayAttr(words));
+      addr += words.size() * sizeof(int32_t);
+    }
+    for (auto op : run)
+      op.erase();
+  }
+}
+
 // an enum to represent the output type of the transaction binary
 enum OutputType {
   Transaction,
   ControlPacket,
 };
 
-static LogicalResult convertTransactionOpsToMLIR(
+static FailureOr<AIEX::RuntimeSequenceOp> convertTransactionOpsToMLIR(
     OpBuilder builder, AIE::DeviceOp device, OutputType outputType,
     std::vector<TransactionBinaryOperation> &operations) {
 
@@ -399,7 +484,7 @@ static LogicalResult convertTransactionOpsToMLIR(
     llvm_unreachable("bad output type");
   }
 
-  return success();
+  return seq;
 }
 
 // Convert (disassemble) a transaction binary to MLIR. On success return a new
@@ -443,9 +528,9 @@ xilinx::AIE::convertTransactionBinaryToMLIR(mlir::MLIRContext *ctx,
   return module;
 }
 
-static LogicalResult convertAIEToConfiguration(AIE::DeviceOp device,
-                                               StringRef clElfDir,
-                                               OutputType outputType) {
+static FailureOr<AIEX::RuntimeSequenceOp>
+convertAIEToConfiguration(AIE::DeviceOp device, StringRef clElfDir,
+                          OutputType outputType) {
 
   const BaseNPUTargetModel &targetModel =
       (const BaseNPUTargetModel &)device.getTargetModel();
@@ -483,10 +568,220 @@ static LogicalResult convertAIEToConfiguration(AIE::DeviceOp device,
   OpBuilder builder(device.getBodyRegion());
 
   // convert the parsed ops to MLIR
-  if (failed(
-          convertTransactionOpsToMLIR(builder, device, outputType, operations)))
+  return convertTransactionOpsToMLIR(builder, device, outputType, operations);
+}
+
+// Record the transaction operations `generate` adds to a new AIERTControl.
+// The data of the block writes points into the binary the operations are
+// parsed from, which is appended to `binaries` to keep it alive.
+static LogicalResult
+recordTransactions(const BaseNPUTargetModel &targetModel,
+                   llvm::function_ref<LogicalResult(AIERTControl &)> generate,
+                   std::list<std::vector<uint8_t>> &binaries,
+                   std::vector<TransactionBinaryOperation> &operations) {
+  AIERTControl ctl(targetModel);
+  if (failed(ctl.setIOBackend(/*aieSim=*/false, /*xaieDebug=*/false)))
     return failure();
 
+  XAie_StartTransaction(&ctl.devInst, XAIE_TRANSACTION_DISABLE_AUTO_FLUSH);
+  if (failed(generate(ctl)))
+    return failure();
+
+  uint8_t *txn_ptr = XAie_ExportSerializedTransaction(&ctl.devInst, 0, 0);
+  XAie_TxnHeader *hdr = (XAie_TxnHeader *)txn_ptr;
+  std::vector<uint8_t> &txn_data =
+      binaries.emplace_back(txn_ptr, txn_ptr + hdr->TxnSize);
+  if (!parseTransactionBinary(txn_data, operations)) {
+    llvm::errs() << "Failed to parse binary\n";
+    return failure();
+  }
+  return success();
+}
+
+namespace {
+
+// The steps configuring a design, in the order they are applied.
+enum ConfigurationStep {
+  LoadElf,
+  InitLocks,
+  InitBuffers,
+  ConfigureDMAs,
+  ConfigureSwitches,
+  EnableCore,
+  NumConfigurationSteps
+};
+
+using TileConfiguration =
+    std::array<std::vector<TransactionBinaryOperation>, NumConfigurationSteps>;
+
+// The transaction operations configuring a design, by tile.
+struct DesignConfiguration {
+  std::map<TileID, TileConfiguration> tiles;
+  std::list<std::vector<uint8_t>> binaries;
+};
+
+} // namespace
+
+static LogicalResult getDesignConfiguration(DeviceOp device, StringRef elfDir,
+                                            DesignConfiguration &config) {
+  const BaseNPUTargetModel &targetModel =
+      (const BaseNPUTargetModel &)device.getTargetModel();
+
+  auto record = [&](ConfigurationStep step,
+                    llvm::function_ref<LogicalResult(AIERTControl &)> generate,
+                    std::optional<TileID> tile = std::nullopt) {
+    std::vector<TransactionBinaryOperation> operations;
+    if (failed(recordTransactions(targetModel, generate, config.binaries,
+                                  operations)))
+      return failure();
+    for (auto &op : operations) {
+      uint64_t addr = op.cmd.RegOff;
+      TileID opTile = {
+          static_cast<int>((addr >> targetModel.getColumnShift()) & 0x1f),
+          static_cast<int>((addr >> targetModel.getRowShift()) & 0x1f)};
+      config.tiles[tile.value_or(opTile)][step].push_back(op);
+    }
+    return success();
+  };
+
+  // The data of an ELF may be loaded into the memories of the neighbours of
+  // its core, so the ELF is attributed to the tile of the core as a whole.
+  for (auto coreOp : device.getOps<CoreOp>()) {
+    TileID tile = {coreOp.colIndex(), coreOp.rowIndex()};
+    config.tiles[tile];
+    if (elfDir.empty())
+      continue;
+    if (failed(record(
+            LoadElf,
+            [&](AIERTControl &ctl) {
+              return ctl.addAieElf(coreOp, elfDir, /*aieSim=*/false);
+            },
+            tile)))
+      return failure();
+  }
+
+  auto recordDesign = [&](ConfigurationStep step,
+                          LogicalResult (AIERTControl::*generate)(DeviceOp &)) {
+    return record(step, [&](AIERTControl &ctl) {
+      return (ctl.*generate)(device);
+    });
+  };
+  if (failed(recordDesign(InitLocks, &AIERTControl::initLocks)) ||
+      failed(recordDesign(InitBuffers, &AIERTControl::initBuffers)) ||
+      failed(recordDesign(ConfigureDMAs, &AIERTControl::configureDMAs)) ||
+      failed(recordDesign(ConfigureSwitches, &AIERTControl::configureSwitches)))
+    return failure();
+
+  if (!device.getOps<CoreOp>().empty() &&
+      failed(recordDesign(EnableCore, &AIERTControl::addCoreEnable)))
+    return failure();
+
+  return success();
+}
+
+static bool isSameOperation(const TransactionBinaryOperation &a,
+                            const TransactionBinaryOperation &b) {
+  if (a.cmd.Opcode != b.cmd.Opcode || a.cmd.RegOff != b.cmd.RegOff ||
+      a.cmd.Value != b.cmd.Value || a.cmd.Mask != b.cmd.Mask ||
+      a.cmd.Size != b.cmd.Size)
+    return false;
+  if (a.cmd.Opcode != XAie_TxnOpcode::XAIE_IO_BLOCKWRITE)
+    return true;
+  return std::memcmp(reinterpret_cast<const void *>(a.cmd.DataPtr),
+                     reinterpret_cast<const void *>(b.cmd.DataPtr),
+                     a.cmd.Size) == 0;
+}
+
+static bool
+isSameOperations(const std::vector<TransactionBinaryOperation> &a,
+                 const std::vector<TransactionBinaryOperation> &b) {
+  return std::equal(a.begin(), a.end(), b.begin(), b.end(), isSameOperation);
+}
+
+// Return the values `operations` leave in the registers they write, assuming
+// the registers are initially zero.
+static std::map<uint64_t, uint32_t>
+getRegisterValues(const std::vector<TransactionBinaryOperation> &operations) {
+  std::map<uint64_t, uint32_t> values;
+  for (auto &op : operations) {
+    if (op.cmd.Opcode == XAie_TxnOpcode::XAIE_IO_WRITE) {
+      values[op.cmd.RegOff] = op.cmd.Value;
+    } else if (op.cmd.Opcode == XAie_TxnOpcode::XAIE_IO_MASKWRITE) {
+      uint32_t &value = values[op.cmd.RegOff];
+      value = (value & ~op.cmd.Mask) | (op.cmd.Value & op.cmd.Mask);
+    } else if (op.cmd.Opcode == XAie_TxnOpcode::XAIE_IO_BLOCKWRITE) {
+      const uint32_t *d = reinterpret_cast<const uint32_t *>(op.cmd.DataPtr);
+      for (uint32_t i = 0; i < op.cmd.Size / 4; i++)
+        values[op.cmd.RegOff + i * 4] = d[i];
+    }
+  }
+  return values;
+}
+
+// Append to `delta` the operations moving a tile from its configuration in
+// the old design, `from`, to its configuration in the new one, `to`, except
+// for enabling its core.
+static LogicalResult
+addTileDelta(const BaseNPUTargetModel &targetModel, TileID tile,
+             const TileConfiguration &from, const TileConfiguration &to,
+             std::list<std::vector<uint8_t>> &binaries,
+             std::vector<TransactionBinaryOperation> &delta) {
+  // Loading an ELF resets the tile. The ELF is not reloaded if it is the one
+  // the core already runs, but the tile is reset all the same.
+  if (!to[LoadElf].empty() && !isSameOperations(from[LoadElf], to[LoadElf])) {
+    llvm::append_range(delta, to[LoadElf]);
+  } else if (!targetModel.isShimNOCorPLTile(tile.col, tile.row)) {
+    if (failed(recordTransactions(
+            targetModel,
+            [&](AIERTControl &ctl) {
+              return ctl.resetTile(tile.col, tile.row);
+            },
+            binaries, delta)))
+      return failure();
+  }
+
+  // The locks keep the values the old design left in them; the new design
+  // only initializes some of them, so all are cleared first.
+  if (failed(recordTransactions(
+          targetModel,
+          [&](AIERTControl &ctl) { return ctl.resetLocks(tile.col, tile.row); },
+          binaries, delta)))
+    return failure();
+
+  // The buffers may have changed since the old design was loaded, so they
+  // are initialized again, as are the locks.
+  llvm::append_range(delta, to[InitLocks]);
+  llvm::append_range(delta, to[InitBuffers]);
+
+  // The BDs the old design already wrote are not written again, but the
+  // channels are restarted. Runtime sequences rewrite the BDs of the shim
+  // tiles, so these are always written.
+  bool isShimTile = targetModel.isShimNOCorPLTile(tile.col, tile.row);
+  for (auto &op : to[ConfigureDMAs]) {
+    if (!isShimTile && op.cmd.Opcode == XAie_TxnOpcode::XAIE_IO_BLOCKWRITE &&
+        llvm::any_of(from[ConfigureDMAs], [&](auto &fromOp) {
+          return isSameOperation(op, fromOp);
+        }))
+      continue;
+    delta.push_back(op);
+  }
+
+  // Only the switch settings that differ are written; the settings of the
+  // old design the new one does not make are cleared.
+  std::map<uint64_t, uint32_t> fromValues =
+      getRegisterValues(from[ConfigureSwitches]);
+  std::map<uint64_t, uint32_t> toValues =
+      getRegisterValues(to[ConfigureSwitches]);
+  for (auto [addr, value] : fromValues)
+    if (value != 0 && !toValues.count(addr))
+      delta.emplace_back(XAie_TxnOpcode::XAIE_IO_WRITE, 0, addr, 0, nullptr,
+                         0);
+  for (auto [addr, value] : toValues) {
+    auto it = fromValues.find(addr);
+    if (it == fromValues.end() || it->second != value)
+      delta.emplace_back(XAie_TxnOpcode::XAIE_IO_WRITE, 0, addr, value,
+                         nullptr, 0);
+  }
   return success();
 }
 
@@ -510,8 +805,101 @@ struct ConvertAIEToControlPacketsPass
     registry.insert<memref::MemRefDialect, AIEX::AIEXDialect>();
   }
   void runOnOperation() override {
-    if (failed(convertAIEToConfiguration(getOperation(), clElfDir,
-                                         OutputType::ControlPacket)))
+    auto seq = convertAIEToConfiguration(getOperation(), clElfDir,
+                                         OutputType::ControlPacket);
+    if (failed(seq))
+      return signalPassFailure();
+
+    Block *body = &seq->getBody().front();
+    if (clSortByTile)
+      sortControlPacketsByTile(body);
+    if (clPackBursts)
+      packControlPacketBursts(body);
+
+    for (auto op : body->getOps<AIEX::NpuControlPacketOp>()) {
+      ++numPackets;
+      if (auto data = op.getData())
+        numWords += data->size();
+    }
+  }
+};
+
+struct ConvertAIEToTransactionDeltaPass
+    : ConvertAIEToTransactionDeltaBase<ConvertAIEToTransactionDeltaPass> {
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<memref::MemRefDialect, AIEX::AIEXDialect>();
+  }
+  void runOnOperation() override {
+    ModuleOp m = getOperation();
+    SmallVector<DeviceOp> devices(m.getOps<DeviceOp>());
+    if (devices.size() != 2) {
+      m.emitOpError("expected two aie.device operations, the old design "
+                    "followed by the new one");
+      return signalPassFailure();
+    }
+    DeviceOp from = devices[0];
+    DeviceOp to = devices[1];
+    if (from.getDevice() != to.getDevice()) {
+      to.emitOpError("targets a different device than the old design");
+      return signalPassFailure();
+    }
+
+    const BaseNPUTargetModel &targetModel =
+        (const BaseNPUTargetModel &)to.getTargetModel();
+    if (!targetModel.hasProperty(AIETargetModel::IsNPU)) {
+      to.emitOpError("expected an NPU device");
+      return signalPassFailure();
+    }
+
+    // Without the ELFs of the old design, the programs it loaded are unknown
+    // and every ELF of the new design is loaded.
+    DesignConfiguration fromConfig, toConfig;
+    if (failed(getDesignConfiguration(from, clFromElfDir, fromConfig)) ||
+        failed(getDesignConfiguration(to, clElfDir, toConfig)))
+      return signalPassFailure();
+
+    // A tile is reconfigured as a whole if any of its configuration changes,
+    // be it only because the old design uses it and the new one does not.
+    const TileConfiguration unused = {};
+    auto getTileConfiguration = [&](DesignConfiguration &config, TileID tile)
+        -> const TileConfiguration & {
+      auto it = config.tiles.find(tile);
+      return it == config.tiles.end() ? unused : it->second;
+    };
+    std::set<TileID> tiles;
+    for (auto *config : {&fromConfig, &toConfig})
+      for (TileID tile : llvm::make_first_range(config->tiles))
+        tiles.insert(tile);
+
+    std::vector<TransactionBinaryOperation> delta;
+    SmallVector<TileID> changedTiles;
+    for (TileID tile : tiles) {
+      const TileConfiguration &fromTile =
+          getTileConfiguration(fromConfig, tile);
+      const TileConfiguration &toTile = getTileConfiguration(toConfig, tile);
+      // Runtime sequences rewrite the BDs of the shim tiles, so a shim tile
+      // with DMAs is configured again even if both designs agree on it.
+      bool rewritesBds = targetModel.isShimNOCorPLTile(tile.col, tile.row) &&
+                         !toTile[ConfigureDMAs].empty();
+      if (!rewritesBds && std::equal(fromTile.begin(), fromTile.end(),
+                                     toTile.begin(), isSameOperations))
+        continue;
+      changedTiles.push_back(tile);
+      if (failed(addTileDelta(targetModel, tile, fromTile, toTile,
+                              toConfig.binaries, delta)))
+        return signalPassFailure();
+    }
+    // The cores are only enabled once all the tiles are configured.
+    for (TileID tile : changedTiles)
+      llvm::append_range(delta,
+                         getTileConfiguration(toConfig, tile)[EnableCore]);
+
+    numChangedTiles = changedTiles.size();
+    numOperations = delta.size();
+
+    OpBuilder builder(to.getBodyRegion());
+    if (failed(convertTransactionOpsToMLIR(builder, to, OutputType::Transaction,
+                                           delta)))
       return signalPassFailure();
   }
 };
@@ -527,3 +915,8 @@ std::unique_ptr<mlir::OperationPass<xilinx::AIE::DeviceOp>>
 xilinx::AIE::createConvertAIEToControlPacketsPass() {
   return std::make_unique<ConvertAIEToControlPacketsPass>();
 }
+
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
+xilinx::AIE::createConvertAIEToTransactionDeltaPass() {
+  return std::make_unique<ConvertAIEToTransactionDeltaPass>();
+}
@@ -21,6 +21,7 @@
 #include "mlir/Conversion/LLVMCommon/Pattern.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/IR/TypeUtilities.h"
+#include "llvm/ADT/StringSwitch.h"
 #include <sstream>
 
 using namespace mlir;
@@ -2320,6 +2321,413 @@ class ShuffleOpConversion
   }
 };
 
+class LegacyShuffleOpConversion
+    : public mlir::ConvertOpToLLVMPattern<aievec::LegacyShuffleOp> {
+  using ConvertOpToLLVMPattern<aievec::LegacyShuffleOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::LegacyShuffleOp shuffleOp, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto loc = shuffleOp.getLoc();
+    auto resultType = cast<VectorType>(shuffleOp.getResult().getType());
+    if (getVectorSizeInBits(resultType) != 512) {
+      shuffleOp.emitWarning() << "aievec.legacyshuffle conversion is only "
+                                 "supported for 512-bit vectors.\n";
+      return failure();
+    }
+
+    // The single source shuffle reads the lanes of the second source of
+    // vshuffle from an undefined vector, as aievec.shuffle does.
+    auto i32ty = rewriter.getI32Type();
+    auto v16xi32ty = VectorType::get({16}, i32ty);
+    auto undef = rewriter.create<xllvm::UndefV16I32IntrOp>(loc, v16xi32ty);
+    auto modeCst = rewriter.create<LLVM::ConstantOp>(
+        loc, i32ty, static_cast<int32_t>(shuffleOp.getMode()));
+    auto vShuffleVal = rewriter
+                           .create<xllvm::VectorShuffleIntrOp>(
+                               loc, v16xi32ty,
+                               forceCastOperandsToSignature(
+                                   rewriter, loc,
+                                   /*operands=*/
+                                   {adaptor.getSource(), undef, modeCst},
+                                   /*signature=*/{v16xi32ty, v16xi32ty, i32ty}))
+                           .getResult();
+
+    rewriter.replaceOp(
+        shuffleOp,
+        forceCastValueToType(rewriter, loc, vShuffleVal, resultType));
+    return success();
+  }
+};
+
+// Multiply convolutions run on the vmac unit in its convolution variant: an
+// M-lane window of lhs sliding over N consecutive lanes is multiplied by the
+// first N lanes of rhs.
+//   mul_conv_32x8: <64xi8> x <64xi8> -> <32xi32>
+//   mul_conv_16x4: <32xi16> x <32xi16> -> <16xi64>
+struct DecodedConvOp {
+  enum class Kind { I8_I8_I32_32x8, I16_I16_I64_16x4, UNSUPPORTED };
+
+  Kind kind;
+  int conf;
+};
+
+static DecodedConvOp decodeConvOp(VectorType lhsTy, VectorType accTy,
+                                  int32_t M, int32_t N, bool fmsub) {
+  auto lhsScaTy = dyn_cast<IntegerType>(lhsTy.getElementType());
+  auto accScaTy = dyn_cast<IntegerType>(accTy.getElementType());
+  if (!lhsScaTy || !accScaTy || getVectorSizeInBits(lhsTy) != 512)
+    return {DecodedConvOp::Kind::UNSUPPORTED, -1};
+
+  if (lhsScaTy.getWidth() == 8 && accScaTy.getWidth() == 32 && M == 32 &&
+      N == 8)
+    return {DecodedConvOp::Kind::I8_I8_I32_32x8,
+            aiev2_vmac_compute_control(
+                /*sgn_x=*/1, /*sgn_y=*/1, /*amode=*/0, /*bmode=*/1,
+                /*variant=*/3, /*zero_acc=*/0, /*shift16=*/0,
+                /*sub_mul=*/fmsub, /*sub_acc1=*/0, /*sub_acc2=*/0,
+                /*sub_mask=*/0)};
+  if (lhsScaTy.getWidth() == 16 && accScaTy.getWidth() == 64 && M == 16 &&
+      N == 4)
+    return {DecodedConvOp::Kind::I16_I16_I64_16x4,
+            aiev2_vmac_compute_control(
+                /*sgn_x=*/1, /*sgn_y=*/1, /*amode=*/1, /*bmode=*/3,
+                /*variant=*/3, /*zero_acc=*/0, /*shift16=*/0,
+                /*sub_mul=*/fmsub, /*sub_acc1=*/0, /*sub_acc2=*/0,
+                /*sub_mask=*/0)};
+  return {DecodedConvOp::Kind::UNSUPPORTED, -1};
+}
+
+class MulConvOpConversion
+    : public mlir::ConvertOpToLLVMPattern<aievec::MulConvOp> {
+public:
+  using ConvertOpToLLVMPattern<aievec::MulConvOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::MulConvOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto resultType = cast<VectorType>(op.getResult().getType());
+    auto decodedConvOp =
+        decodeConvOp(cast<VectorType>(op.getLhs().getType()), resultType,
+                     op.getM(), op.getN(), /*fmsub=*/false);
+    if (decodedConvOp.kind == DecodedConvOp::Kind::UNSUPPORTED) {
+      op.emitWarning() << "aievec.mul_conv conversion is not supported for "
+                          "this shape and element type.\n";
+      return failure();
+    }
+
+    Type i32ty = rewriter.getI32Type();
+    auto confCst = rewriter.create<LLVM::ConstantOp>(
+        loc, i32ty, rewriter.getI32IntegerAttr(decodedConvOp.conf));
+    SmallVector<Value> operands({adaptor.getLhs(), adaptor.getRhs(), confCst});
+    SmallVector<Type> signature({VectorType::get({64}, rewriter.getI8Type()),
+                                 VectorType::get({16}, i32ty), i32ty});
+    auto v16xi64ty = VectorType::get({16}, rewriter.getI64Type());
+    Value mulConvVal;
+    if (decodedConvOp.kind == DecodedConvOp::Kind::I8_I8_I32_32x8)
+      mulConvVal =
+          rewriter
+              .create<xllvm::MulConfAcc32IntrOp>(
+                  loc, v16xi64ty,
+                  forceCastOperandsToSignature(rewriter, loc, operands,
+                                               signature))
+              .getResult();
+    else
+      mulConvVal =
+          rewriter
+              .create<xllvm::MulConfAcc64IntrOp>(
+                  loc, v16xi64ty,
+                  forceCastOperandsToSignature(rewriter, loc, operands,
+                                               signature))
+              .getResult();
+
+    rewriter.replaceOp(
+        op, forceCastValueToType(rewriter, loc, mulConvVal, resultType));
+    return success();
+  }
+};
+
+class FMAConvOpConversion
+    : public mlir::ConvertOpToLLVMPattern<aievec::FMAConvOp> {
+public:
+  using ConvertOpToLLVMPattern<aievec::FMAConvOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::FMAConvOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto resultType = cast<VectorType>(op.getResult().getType());
+    auto decodedConvOp =
+        decodeConvOp(cast<VectorType>(op.getLhs().getType()), resultType,
+                     op.getM(), op.getN(), op.getFmsub());
+    if (decodedConvOp.kind == DecodedConvOp::Kind::UNSUPPORTED) {
+      op.emitWarning() << "aievec.fma_conv conversion is not supported for "
+                          "this shape and element type.\n";
+      return failure();
+    }
+
+    Type i32ty = rewriter.getI32Type();
+    auto v16xi64ty = VectorType::get({16}, rewriter.getI64Type());
+    auto confCst = rewriter.create<LLVM::ConstantOp>(
+        loc, i32ty, rewriter.getI32IntegerAttr(decodedConvOp.conf));
+    SmallVector<Value> operands(
+        {adaptor.getLhs(), adaptor.getRhs(), adaptor.getAcc(), confCst});
+    SmallVector<Type> signature({VectorType::get({64}, rewriter.getI8Type()),
+                                 VectorType::get({16}, i32ty), v16xi64ty,
+                                 i32ty});
+    Value macConvVal;
+    if (decodedConvOp.kind == DecodedConvOp::Kind::I8_I8_I32_32x8)
+      macConvVal =
+          rewriter
+              .create<xllvm::MacConfAcc32IntrOp>(
+                  loc, v16xi64ty,
+                  forceCastOperandsToSignature(rewriter, loc, operands,
+                                               signature))
+              .getResult();
+    else
+      macConvVal =
+          rewriter
+              .create<xllvm::MacConfAcc64IntrOp>(
+                  loc, v16xi64ty,
+                  forceCastOperandsToSignature(rewriter, loc, operands,
+                                               signature))
+              .getResult();
+
+    rewriter.replaceOp(
+        op, forceCastValueToType(rewriter, loc, macConvVal, resultType));
+    return success();
+  }
+};
+
+// The ordered comparisons of 512-bit vectors of i8, i16, i32 and bf16 lanes
+// take the lane mask the vmax.lt and vmin.ge intrinsics return with the
+// maximum or the minimum: lt(a, b) and ge(a, b), gt(a, b) as lt(b, a) and
+// le(a, b) as ge(b, a). Equalities, and the comparisons of f32 lanes the
+// vector unit has no instruction for, are left to the backend as LLVM
+// comparisons.
+class CmpOpConversion : public mlir::ConvertOpToLLVMPattern<aievec::CmpOp> {
+public:
+  using ConvertOpToLLVMPattern<aievec::CmpOp>::ConvertOpToLLVMPattern;
+
+  // Returns the mask of the lanes where lhs < rhs, or lhs >= rhs if `ge`.
+  static Value createOrderedCmpMask(OpBuilder &builder, Location loc,
+                                    Value lhs, Value rhs, bool ge,
+                                    bool isSigned) {
+    auto vecTy = cast<VectorType>(lhs.getType());
+    Type scaTy = vecTy.getElementType();
+    unsigned bitWidth = scaTy.getIntOrFloatBitWidth();
+    Type i32ty = builder.getI32Type();
+    MLIRContext *ctx = builder.getContext();
+
+    if (isa<FloatType>(scaTy)) {
+      auto v32bf16ty = VectorType::get({32}, builder.getBF16Type());
+      auto resTy = LLVM::LLVMStructType::getLiteral(ctx, {v32bf16ty, i32ty});
+      auto operands = forceCastOperandsToSignature(builder, loc, {lhs, rhs},
+                                                   {v32bf16ty, v32bf16ty});
+      Value res;
+      if (ge)
+        res =
+            builder.create<xllvm::VectorMinGeBf16IntrOp>(loc, resTy, operands);
+      else
+        res =
+            builder.create<xllvm::VectorMaxLtBf16IntrOp>(loc, resTy, operands);
+      return builder.create<LLVM::ExtractValueOp>(loc, res, /*position=*/1);
+    }
+
+    auto signCst = builder.create<LLVM::ConstantOp>(
+        loc, i32ty, builder.getI32IntegerAttr(isSigned));
+    SmallVector<Value> operands{lhs, rhs, signCst};
+    auto getResTy = [&](Type maskTy) {
+      return LLVM::LLVMStructType::getLiteral(ctx, {vecTy, maskTy});
+    };
+    Value res;
+    if (bitWidth == 8) {
+      auto v2i32ty = VectorType::get({2}, i32ty);
+      if (ge)
+        res = builder.create<xllvm::VectorMinGe8IntrOp>(
+            loc, getResTy(v2i32ty), operands);
+      else
+        res = builder.create<xllvm::VectorMaxLt8IntrOp>(
+            loc, getResTy(v2i32ty), operands);
+      Value mask =
+          builder.create<LLVM::ExtractValueOp>(loc, res, /*position=*/1);
+      return bitcastValueToType(builder, loc, mask, builder.getI64Type());
+    }
+    if (bitWidth == 16) {
+      if (ge)
+        res = builder.create<xllvm::VectorMinGe16IntrOp>(loc, getResTy(i32ty),
+                                                          operands);
+      else
+        res = builder.create<xllvm::VectorMaxLt16IntrOp>(loc, getResTy(i32ty),
+                                                          operands);
+    } else {
+      if (ge)
+        res = builder.create<xllvm::VectorMinGe32IntrOp>(loc, getResTy(i32ty),
+                                                          operands);
+      else
+        res = builder.create<xllvm::VectorMaxLt32IntrOp>(loc, getResTy(i32ty),
+                                                          operands);
+    }
+    return builder.create<LLVM::ExtractValueOp>(loc, res, /*position=*/1);
+  }
+
+  // Returns the mask of an LLVM comparison of lhs and rhs, one bit per lane.
+  static Value createGenericCmpMask(OpBuilder &builder, Location loc,
+                                    StringRef pred, Value lhs, Value rhs) {
+    auto vecTy = cast<VectorType>(lhs.getType());
+    Value cmp;
+    if (isa<FloatType>(vecTy.getElementType())) {
+      auto fpred = llvm::StringSwitch<LLVM::FCmpPredicate>(pred)
+                       .Case("eq", LLVM::FCmpPredicate::oeq)
+                       .Case("ne", LLVM::FCmpPredicate::une)
+                       .Cases("slt", "ult", LLVM::FCmpPredicate::olt)
+                       .Cases("sle", "ule", LLVM::FCmpPredicate::ole)
+                       .Cases("sgt", "ugt", LLVM::FCmpPredicate::ogt)
+                       .Default(LLVM::FCmpPredicate::oge);
+      cmp = builder.create<LLVM::FCmpOp>(loc, fpred, lhs, rhs);
+    } else {
+      auto ipred = llvm::StringSwitch<LLVM::ICmpPredicate>(pred)
+                       .Case("eq", LLVM::ICmpPredicate::eq)
+                       .Case("ne", LLVM::ICmpPredicate::ne)
+                       .Case("slt", LLVM::ICmpPredicate::slt)
+                       .Case("ult", LLVM::ICmpPredicate::ult)
+                       .Case("sle", LLVM::ICmpPredicate::sle)
+                       .Case("ule", LLVM::ICmpPredicate::ule)
+                       .Case("sgt", LLVM::ICmpPredicate::sgt)
+                       .Case("ugt", LLVM::ICmpPredicate::ugt)
+                       .Case("sge", LLVM::ICmpPredicate::sge)
+                       .Default(LLVM::ICmpPredicate::uge);
+      cmp = builder.create<LLVM::ICmpOp>(loc, ipred, lhs, rhs);
+    }
+    return bitcastValueToType(
+        builder, loc, cmp,
+        builder.getIntegerType(getVectorLaneSize(vecTy)));
+  }
+
+  LogicalResult
+  matchAndRewrite(aievec::CmpOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    StringRef pred = op.getPred();
+    static constexpr StringRef predicates[] = {
+        "eq", "ne", "slt", "ult", "sle", "ule", "sgt", "ugt", "sge", "uge"};
+    if (!llvm::is_contained(predicates, pred)) {
+      op.emitWarning() << "aievec.cmp conversion with predicate \"" << pred
+                       << "\" is not supported.\n";
+      return failure();
+    }
+
+    auto vecTy = cast<VectorType>(op.getLhs().getType());
+    Type scaTy = vecTy.getElementType();
+    if (getVectorSizeInBits(vecTy) != 512) {
+      op.emitWarning() << "aievec.cmp conversion is only supported for "
+                          "512-bit vectors.\n";
+      return failure();
+    }
+
+    Value lhs = adaptor.getLhs();
+    Value rhs = adaptor.getRhs();
+    Value mask;
+    if (pred == "eq" || pred == "ne" || scaTy.isF32()) {
+      mask = createGenericCmpMask(rewriter, loc, pred, lhs, rhs);
+    } else {
+      bool isSigned = pred.starts_with("s");
+      StringRef cmp = pred.drop_front();
+      if (cmp == "gt" || cmp == "le")
+        std::swap(lhs, rhs);
+      bool ge = cmp == "ge" || cmp == "le";
+      mask = createOrderedCmpMask(rewriter, loc, lhs, rhs, ge, isSigned);
+    }
+
+    // The mask has one bit per lane, which may be fewer than the bits of the
+    // result.
+    Type resultType = getTypeConverter()->convertType(op.getResult().getType());
+    unsigned maskWidth = mask.getType().getIntOrFloatBitWidth();
+    unsigned resultWidth = resultType.getIntOrFloatBitWidth();
+    if (maskWidth < resultWidth)
+      mask = rewriter.create<LLVM::ZExtOp>(loc, resultType, mask);
+    else if (maskWidth > resultWidth)
+      mask = rewriter.create<LLVM::TruncOp>(loc, resultType, mask);
+
+    rewriter.replaceOp(op, mask);
+    return success();
+  }
+};
+
+// Negates integer vectors by subtracting them from zero, and floating-point
+// vectors, typically accumulators, by flipping their sign bits.
+// XLLVM has no negation intrinsic, so this stays generic LLVM for the backend
+// to select.
+class NegOpConversion : public mlir::ConvertOpToLLVMPattern<aievec::NegOp> {
+public:
+  using ConvertOpToLLVMPattern<aievec::NegOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::NegOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto vecTy = cast<VectorType>(op.getResult().getType());
+    auto flatVecTy = getFlattenedVectorType(vecTy);
+    Value src = adaptor.getSource();
+    if (vecTy != flatVecTy)
+      src = rewriter.create<vector::ShapeCastOp>(loc, flatVecTy, src);
+
+    Value res;
+    if (isa<FloatType>(flatVecTy.getElementType())) {
+      res = rewriter.create<LLVM::FNegOp>(loc, flatVecTy, src);
+    } else {
+      auto zero = rewriter.create<LLVM::ConstantOp>(
+          loc, flatVecTy, rewriter.getZeroAttr(flatVecTy));
+      res = rewriter.create<LLVM::SubOp>(loc, flatVecTy, zero, src);
+    }
+
+    if (vecTy != flatVecTy)
+      res = rewriter.create<vector::ShapeCastOp>(loc, vecTy, res);
+    rewriter.replaceOp(op, res);
+    return success();
+  }
+};
+
+// The bitwise operations work on 512-bit vectors as bags of bits. XLLVM has
+// no intrinsics for them, so they are expressed as generic LLVM operations on
+// <16xi32> vectors, the backend selecting the vband, vbor, vbxor and vbneg
+// instructions for them.
+template <typename SrcOpTy>
+class BitwiseOpConversion : public mlir::ConvertOpToLLVMPattern<SrcOpTy> {
+public:
+  using mlir::ConvertOpToLLVMPattern<SrcOpTy>::ConvertOpToLLVMPattern;
+  using OpAdaptor = typename SrcOpTy::Adaptor;
+
+  LogicalResult
+  matchAndRewrite(SrcOpTy op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto v16xi32ty = VectorType::get({16}, rewriter.getI32Type());
+    SmallVector<Value> operands = forceCastOperandsToSignature(
+        rewriter, loc, adaptor.getOperands(),
+        SmallVector<Type>(adaptor.getOperands().size(), v16xi32ty));
+
+    Value res;
+    if constexpr (std::is_same_v<SrcOpTy, aievec::BandOp>)
+      res = rewriter.create<LLVM::AndOp>(loc, operands[0], operands[1]);
+    else if constexpr (std::is_same_v<SrcOpTy, aievec::BorOp>)
+      res = rewriter.create<LLVM::OrOp>(loc, operands[0], operands[1]);
+    else if constexpr (std::is_same_v<SrcOpTy, aievec::BxorOp>)
+      res = rewriter.create<LLVM::XOrOp>(loc, operands[0], operands[1]);
+    else {
+      Attribute allOnes = rewriter.getI32IntegerAttr(-1);
+      auto ones = rewriter.create<LLVM::ConstantOp>(
+          loc, v16xi32ty, DenseElementsAttr::get(v16xi32ty, allOnes));
+      res = rewriter.create<LLVM::XOrOp>(loc, operands[0], ones);
+    }
+
+    rewriter.replaceOp(op, forceCastValueToType(rewriter, loc, res,
+                                                op.getResult().getType()));
+    return success();
+  }
+};
+
 void populateAIEVecToLLVMConversionPatterns(
     mlir::LLVMTypeConverter &converter, mlir::RewritePatternSet &patterns,
     Aie2Fp32Emulation aie2Fp32EmulationOption) {
@@ -2345,7 +2753,16 @@ void populateAIEVecToLLVMConversionPatterns(
                ShiftOpConversion,
                ExtractElemOpConversion,
                FoldAIECastOps,
-               ShuffleOpConversion>(converter);
+               ShuffleOpConversion,
+               LegacyShuffleOpConversion,
+               MulConvOpConversion,
+               FMAConvOpConversion,
+               CmpOpConversion,
+               NegOpConversion,
+               BitwiseOpConversion<aievec::BandOp>,
+               BitwiseOpConversion<aievec::BorOp>,
+               BitwiseOpConversion<aievec::BxorOp>,
+               BitwiseOpConversion<aievec::BnegOp>>(converter);
   patterns.add<MulElemOpConversion>(converter, aie2Fp32EmulationOption);
   // clang-format on
 }
@@ -9,11 +9,15 @@
 //===----------------------------------------------------------------------===//
 
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEBufferAccessAnalysis.h"
 #include "aie/Dialect/AIE/Transforms/AIEPasses.h"
 
 #include "mlir/IR/Attributes.h"
 
 #include "llvm/ADT/Twine.h"
+#include "llvm/Support/Debug.h"
+
+#include <numeric>
 
 #define DEBUG_TYPE "aie-assign-buffers"
 
@@ -256,32 +260,41 @@ void printMemMap(TileOp tile, SmallVector<BufferOp> &allocatedBuffers,
 
 // Function that given a buffer will iterate over all the memory banks
 // starting from the given index to try and find a bank with enough
-// space. If it does, it will set the buffer's address and mem_bank
-// attributes and update the nextAddrInBanks vector.
+// space. Banks holding a buffer that may be accessed at the same time as
+// this one (see `conflictsWithBank`) are only used if no other bank has
+// enough space. If it finds a bank, it will set the buffer's address and
+// mem_bank attributes and update the nextAddrInBanks vector.
 // If it does not find one with enough space, it will throw an error.
 // Returns true if the buffer was successfully allocated, false otherwise.
 // If no bank has enough space to accommodate the buffer, an error is emitted.
 
 int setBufferAddress(BufferOp buffer, int numBanks, int &startBankIndex,
                      std::vector<int64_t> &nextAddrInBanks,
-                     std::vector<BankLimits> &bankLimits) {
+                     std::vector<BankLimits> &bankLimits,
+                     llvm::function_ref<bool(int)> conflictsWithBank) {
   assert(startBankIndex < numBanks &&
          "Unexpected input value for startBankIndex");
-  int bankIndex = startBankIndex;
   bool allocated = false;
-  for (int i = 0; i < numBanks; i++) {
-    int64_t startAddr = nextAddrInBanks[bankIndex];
-    int64_t endAddr = startAddr + buffer.getAllocationSize();
-    if (endAddr <= bankLimits[bankIndex].endAddr) {
-      buffer.setMemBank(bankIndex);
-      setAndUpdateAddressInBank(buffer, startAddr, endAddr, nextAddrInBanks);
-      allocated = true;
+  for (bool avoidConflicts : {true, false}) {
+    int bankIndex = startBankIndex;
+    for (int i = 0; i < numBanks; i++) {
+      int64_t startAddr = nextAddrInBanks[bankIndex];
+      int64_t endAddr = startAddr + buffer.getAllocationSize();
+      if (endAddr <= bankLimits[bankIndex].endAddr &&
+          !(avoidConflicts && conflictsWithBank(bankIndex))) {
+        buffer.setMemBank(bankIndex);
+        setAndUpdateAddressInBank(buffer, startAddr, endAddr,
+                                  nextAddrInBanks);
+        allocated = true;
+        bankIndex = (bankIndex + 1) % numBanks;
+        startBankIndex = bankIndex;
+        break;
+      }
+      // Move to the next bank
       bankIndex = (bankIndex + 1) % numBanks;
-      startBankIndex = bankIndex;
-      break;
     }
-    // Move to the next bank
-    bankIndex = (bankIndex + 1) % numBanks;
+    if (allocated)
+      break;
   }
   // If no bank has enough space, throws error
   if (!allocated) {
@@ -351,7 +364,8 @@ void deAllocationBuffers(SmallVector<BufferOp> &buffers) {
   }
 }
 
-LogicalResult simpleBankAwareAllocation(TileOp tile) {
+LogicalResult simpleBankAwareAllocation(TileOp tile,
+                                        const BufferAccessAnalysis &accesses) {
   auto device = tile->getParentOfType<AIE::DeviceOp>();
   if (!device)
     return failure();
@@ -421,16 +435,27 @@ LogicalResult simpleBankAwareAllocation(TileOp tile) {
               return a.getAllocationSize() > b.getAllocationSize();
             });
 
+  // The buffers placed in each bank so far.
+  std::vector<SmallVector<BufferOp>> buffersInBanks(numBanks);
+  for (auto buffer : preAllocatedBuffers)
+    if (auto bank = buffer.getMemBank())
+      buffersInBanks[*bank].push_back(buffer);
+
   // Set addresses for remaining buffers.
   SmallVector<BufferOp> allocatedBuffers;
   int bankIndex = 0;
   for (auto buffer : buffersToAlloc) {
+    auto conflictsWithBank = [&](int bank) {
+      return llvm::any_of(buffersInBanks[bank], [&](BufferOp other) {
+        return accesses.mayConflict(buffer, other);
+      });
+    };
     // If the buffer doesn't fit in any of the bank space then
     // it prints the current memory map of the banks,
     // deallocates all the buffers, and
     // returns a failure.
     if (!setBufferAddress(buffer, numBanks, bankIndex, nextAddrInBanks,
-                          bankLimits)) {
+                          bankLimits, conflictsWithBank)) {
 
       printMemMap(tile, allocatedBuffers, preAllocatedBuffers, numBanks,
                   bankLimits, stacksize);
@@ -438,6 +463,7 @@ LogicalResult simpleBankAwareAllocation(TileOp tile) {
       return failure();
     } else {
       allocatedBuffers.push_back(buffer);
+      buffersInBanks[buffer.getMemBank().value()].push_back(buffer);
     }
   }
 
@@ -452,6 +478,224 @@ LogicalResult simpleBankAwareAllocation(TileOp tile) {
                                nextAddrInBanks, bankLimits);
 }
 
+//===----------------------------------------------------------------------===//
+// BinPackingAllocation : branch-and-bound search over bank assignments
+//===----------------------------------------------------------------------===//
+
+// Upper bound on the number of partial assignments explored per tile.
+static constexpr int64_t maxBinPackingNodes = 200000;
+
+// Node-bounded branch-and-bound search for the assignment of buffers to banks
+// that fits and has the least total conflict weight between buffers sharing
+// a bank. Banks are tried cheapest first, so the first complete assignment
+// reached is the greedy one. Once maxBinPackingNodes partial assignments
+// have been explored, the search stops and keeps the best assignment found
+// so far, which is no worse than the greedy one; if it found none,
+// binPackingAllocation falls back to the greedy bank-aware allocation.
+struct BankPacker {
+  // size of each buffer, sorted by decreasing size
+  std::vector<int64_t> sizes;
+  // conflicts[i][j] is the conflict weight of buffers i and j
+  std::vector<std::vector<int>> conflicts;
+  // fixedCost[i][b] is the conflict weight of buffer i with the buffers
+  // already placed in bank b
+  std::vector<std::vector<int>> fixedCost;
+  // free bytes of each bank
+  std::vector<int64_t> freeBytes;
+  // whether nothing is placed in a bank yet; such banks of the same free
+  // size are interchangeable
+  std::vector<bool> untouched;
+
+  std::vector<int> assignment, bestAssignment;
+  int64_t bestCost = std::numeric_limits<int64_t>::max();
+  int64_t nodes = 0;
+
+  // Returns false if no assignment fits or none was found within the node
+  // bound.
+  bool solve() {
+    assignment.assign(sizes.size(), -1);
+    int64_t totalSize = std::accumulate(sizes.begin(), sizes.end(), 0LL);
+    search(0, 0, totalSize);
+    return bestCost != std::numeric_limits<int64_t>::max();
+  }
+
+  bool hitNodeBound() const { return nodes > maxBinPackingNodes; }
+
+  void search(size_t i, int64_t cost, int64_t remainingSize) {
+    if (cost >= bestCost || bestCost == 0 || nodes++ >= maxBinPackingNodes)
+      return;
+    if (i == sizes.size()) {
+      bestCost = cost;
+      bestAssignment = assignment;
+      return;
+    }
+    if (remainingSize >
+        std::accumulate(freeBytes.begin(), freeBytes.end(), 0LL))
+      return;
+
+    // Try the banks by increasing added cost, then by decreasing free space
+    // so that the first assignment found already spreads buffers out.
+    int numBanks = freeBytes.size();
+    SmallVector<std::pair<int64_t, int>> candidates;
+    for (int b = 0; b < numBanks; b++) {
+      if (freeBytes[b] < sizes[i])
+        continue;
+      bool symmetric = false;
+      if (untouched[b])
+        for (int c = 0; c < b; c++)
+          symmetric |= untouched[c] && freeBytes[c] == freeBytes[b];
+      if (symmetric)
+        continue;
+      int64_t added = fixedCost[i][b];
+      for (size_t j = 0; j < i; j++)
+        if (assignment[j] == b)
+          added += conflicts[i][j];
+      candidates.push_back({added, b});
+    }
+    llvm::stable_sort(candidates, [&](auto a, auto b) {
+      if (a.first != b.first)
+        return a.first < b.first;
+      return freeBytes[a.second] > freeBytes[b.second];
+    });
+
+    for (auto [added, b] : candidates) {
+      bool wasUntouched = untouched[b];
+      assignment[i] = b;
+      freeBytes[b] -= sizes[i];
+      untouched[b] = false;
+      search(i + 1, cost + added, remainingSize - sizes[i]);
+      untouched[b] = wasUntouched;
+      freeBytes[b] += sizes[i];
+      assignment[i] = -1;
+    }
+  }
+};
+
+// Places each buffer of `tile` in a single bank, like the bank-aware
+// scheme, but searches for an assignment instead of placing buffers
+// greedily. Among the assignments that fit, the one with the fewest
+// concurrent accesses to buffers in the same bank is chosen. If
+// `reportFailure` is false, no diagnostics are emitted when no assignment is
+// found.
+LogicalResult binPackingAllocation(TileOp tile,
+                                   const BufferAccessAnalysis &accesses,
+                                   bool reportFailure = true) {
+  auto device = tile->getParentOfType<AIE::DeviceOp>();
+  if (!device)
+    return failure();
+
+  const auto &targetModel = getTargetModel(tile);
+  int maxDataMemorySize = 0;
+  if (tile.isMemTile())
+    maxDataMemorySize = targetModel.getMemTileSize();
+  else
+    maxDataMemorySize = targetModel.getLocalMemorySize();
+
+  int numBanks = targetModel.getNumBanks(tile.getCol(), tile.getRow());
+  int bankSize = maxDataMemorySize / numBanks;
+
+  std::vector<int64_t> nextAddrInBanks;
+  std::vector<BankLimits> bankLimits;
+  int stacksize = 0;
+  for (int i = 0; i < numBanks; i++)
+    nextAddrInBanks.push_back(bankSize * i);
+  if (auto core = tile.getCoreOp()) {
+    stacksize = core.getStackSize();
+    nextAddrInBanks[0] += stacksize;
+  }
+  fillBankLimits(numBanks, bankSize, bankLimits);
+
+  SmallVector<BufferOp> allBuffers;
+  device.walk<WalkOrder::PreOrder>([&](BufferOp buffer) {
+    if (buffer.getTileOp() == tile)
+      allBuffers.push_back(buffer);
+  });
+
+  // Buffers with an address or a mem_bank are kept where they are, as in
+  // the bank-aware scheme. A buffer with an address is not moved within its
+  // bank, as this scheme may run after a failed bank-aware allocation.
+  SmallVector<BufferOp> preAllocatedBuffers;
+  SmallVector<BufferOp> buffersToAlloc;
+  for (auto buffer : allBuffers) {
+    auto has_addr = checkAndAddBufferWithAddress(buffer, numBanks,
+                                                 nextAddrInBanks, bankLimits);
+    if (failed(has_addr))
+      return failure();
+    FailureOr<bool> has_bank = false;
+    if (!has_addr.value())
+      has_bank = checkAndAddBufferWithMemBank(buffer, numBanks,
+                                              nextAddrInBanks, bankLimits);
+    if (failed(has_bank))
+      return failure();
+    if (!has_addr.value() && !has_bank.value())
+      buffersToAlloc.push_back(buffer);
+    else
+      preAllocatedBuffers.push_back(buffer);
+  }
+
+  std::stable_sort(buffersToAlloc.begin(), buffersToAlloc.end(),
+                   [](BufferOp a, BufferOp b) {
+                     return a.getAllocationSize() > b.getAllocationSize();
+                   });
+
+  BankPacker packer;
+  packer.untouched.assign(numBanks, true);
+  bool preAllocatedOverflow = false;
+  for (int b = 0; b < numBanks; b++) {
+    packer.freeBytes.push_back(
+        std::max<int64_t>(0, bankLimits[b].endAddr - nextAddrInBanks[b]));
+    packer.untouched[b] = nextAddrInBanks[b] == bankLimits[b].startAddr;
+    preAllocatedOverflow |= nextAddrInBanks[b] > bankLimits[b].endAddr;
+  }
+  // The overflow is reported below, once all buffers have an address.
+  if (preAllocatedOverflow && !reportFailure)
+    return failure();
+  for (auto buffer : buffersToAlloc) {
+    packer.sizes.push_back(buffer.getAllocationSize());
+    std::vector<int> row, fixed(numBanks, 0);
+    for (auto other : buffersToAlloc)
+      row.push_back(accesses.getConflictWeight(buffer, other));
+    for (auto other : preAllocatedBuffers)
+      if (auto bank = other.getMemBank())
+        fixed[*bank] += accesses.getConflictWeight(buffer, other);
+    packer.conflicts.push_back(std::move(row));
+    packer.fixedCost.push_back(std::move(fixed));
+  }
+
+  if (!packer.solve()) {
+    // The search ran out of nodes before reaching any assignment that fits,
+    // not necessarily because none does: place the buffers greedily instead.
+    if (packer.hitNodeBound() && reportFailure)
+      return simpleBankAwareAllocation(tile, accesses);
+    if (reportFailure) {
+      SmallVector<BufferOp> allocatedBuffers;
+      printMemMap(tile, allocatedBuffers, preAllocatedBuffers, numBanks,
+                  bankLimits, stacksize);
+    }
+    return failure();
+  }
+
+  LLVM_DEBUG(llvm::dbgs() << "bin-packing for tile (" << tile.getCol() << ", "
+                          << tile.getRow() << "): " << packer.bestCost
+                          << " concurrent accesses after " << packer.nodes
+                          << " nodes\n");
+
+  for (auto [buffer, bank] :
+       llvm::zip_equal(buffersToAlloc, packer.bestAssignment)) {
+    int64_t startAddr = nextAddrInBanks[bank];
+    buffer.setMemBank(bank);
+    setAndUpdateAddressInBank(buffer, startAddr,
+                              startAddr + buffer.getAllocationSize(),
+                              nextAddrInBanks);
+  }
+
+  std::sort(allBuffers.begin(), allBuffers.end(), [](BufferOp a, BufferOp b) {
+    return a.getAddress().value() < b.getAddress().value();
+  });
+  return checkAndPrintOverflow(tile, numBanks, stacksize, allBuffers,
+                               nextAddrInBanks, bankLimits);
+}
+
 struct AIEAssignBufferAddressesPass
     : AIEAssignBufferAddressesBase<AIEAssignBufferAddressesPass> {
 
@@ -474,6 +718,8 @@ struct AIEAssignBufferAddressesPass
       }
     });
 
+    BufferAccessAnalysis accesses(device);
+
     // Select allocation scheme
     if (clAllocScheme == "basic-sequential") {
       for (auto tile : device.getOps<TileOp>()) {
@@ -482,19 +728,43 @@ struct AIEAssignBufferAddressesPass
       }
     } else if (clAllocScheme == "bank-aware") {
       for (auto tile : device.getOps<TileOp>()) {
-        if (auto res = simpleBankAwareAllocation(tile); res.failed())
+        if (auto res = simpleBankAwareAllocation(tile, accesses); res.failed())
+          return signalPassFailure();
+      }
+    } else if (clAllocScheme == "bin-packing") {
+      for (auto tile : device.getOps<TileOp>()) {
+        if (auto res = binPackingAllocation(tile, accesses); res.failed())
           return signalPassFailure();
       }
     } else {
       for (auto tile : device.getOps<TileOp>()) {
         tile.emitWarning("Memory allocation scheme is either not provided or "
                          "unrecognized. Defaulting to bank-aware allocation.");
-        if (auto res = simpleBankAwareAllocation(tile); res.failed()) {
+        if (auto res = simpleBankAwareAllocation(tile, accesses);
+            res.failed()) {
+          if (succeeded(binPackingAllocation(tile, accesses,
+                                             /*reportFailure=*/false)))
+            continue;
           if (auto res2 = basicAllocation(tile); res2.failed())
             return signalPassFailure();
         }
       }
     }
+
+    if (clReportBankConflicts) {
+      for (auto tile : device.getOps<TileOp>()) {
+        auto conflicts = accesses.getBankConflicts(tile);
+        if (conflicts.empty())
+          continue;
+        InFlightDiagnostic remark = tile.emitRemark()
+                                    << conflicts.size()
+                                    << " predicted bank conflict(s)";
+        for (auto [a, b] : conflicts)
+          remark.attachNote(b.getLoc())
+              << a.name() << " and " << b.name()
+              << " share a bank and may be accessed at the same time";
+      }
+    }
   }
 };
 
@@ -0,0 +1,135 @@
+//===- AIEBufferAccessAnalysis.cpp ------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/Transforms/AIEBufferAccessAnalysis.h"
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+BufferAccessAnalysis::BufferAccessAnalysis(DeviceOp device) : device(device) {
+  binaryLocks = device.getTargetModel().getTargetArch() == AIEArch::AIE1;
+
+  device.walk([&](Operation *op) {
+    if (auto core = dyn_cast<CoreOp>(op)) {
+      addCoreAccesses(core);
+    } else if (auto dma = dyn_cast<DMAOp>(op)) {
+      dma.walk([&](DMABDOp bd) { addDMAAccesses(bd, dma); });
+    } else if (auto start = dyn_cast<DMAStartOp>(op)) {
+      // Follow the BD chain of the channel; the chain successor of the
+      // dma_start leads to the next channel.
+      SmallVector<Block *> worklist = {start.getDest()};
+      llvm::SmallPtrSet<Block *, 8> visited;
+      while (!worklist.empty()) {
+        Block *block = worklist.pop_back_val();
+        if (!visited.insert(block).second)
+          continue;
+        for (auto bd : block->getOps<DMABDOp>())
+          addDMAAccesses(bd, start);
+        Operation *terminator = block->getTerminator();
+        if (!isa<DMAStartOp>(terminator))
+          for (Block *succ : terminator->getSuccessors())
+            worklist.push_back(succ);
+      }
+    }
+  });
+}
+
+// Updates the locks held after `useLock`.
+static void updateGuards(SmallVector<LockOp, 2> &guards, UseLockOp useLock) {
+  auto lock = useLock.getLock().getDefiningOp<LockOp>();
+  if (!lock)
+    return;
+  if (useLock.release())
+    llvm::erase(guards, lock);
+  else if (!llvm::is_contained(guards, lock))
+    guards.push_back(lock);
+}
+
+void BufferAccessAnalysis::addCoreAccesses(CoreOp core) {
+  SmallVector<LockOp, 2> held;
+  core.walk<WalkOrder::PreOrder>([&](Operation *op) {
+    if (auto useLock = dyn_cast<UseLockOp>(op)) {
+      updateGuards(held, useLock);
+      return;
+    }
+    for (Value operand : op->getOperands()) {
+      auto buffer = operand.getDefiningOp<BufferOp>();
+      if (!buffer)
+        continue;
+      auto &bufferAccesses = accesses[buffer];
+      bool known = llvm::any_of(bufferAccesses, [&](const Access &access) {
+        return access.agent == core && access.guards == held;
+      });
+      if (!known)
+        bufferAccesses.push_back({core, held});
+    }
+  });
+}
+
+void BufferAccessAnalysis::addDMAAccesses(DMABDOp bd, Operation *channel) {
+  auto buffer = bd.getBuffer().getDefiningOp<BufferOp>();
+  if (!buffer)
+    return;
+  SmallVector<LockOp, 2> guards;
+  for (auto useLock : bd->getBlock()->getOps<UseLockOp>())
+    if (!useLock.release())
+      updateGuards(guards, useLock);
+  accesses[buffer].push_back({channel, guards});
+}
+
+bool BufferAccessAnalysis::areConcurrent(const Access &a,
+                                         const Access &b) const {
+  if (a.agent == b.agent)
+    return false;
+  if (!binaryLocks)
+    return true;
+  return llvm::none_of(a.guards, [&](LockOp lock) {
+    return llvm::is_contained(b.guards, lock);
+  });
+}
+
+int BufferAccessAnalysis::getConflictWeight(BufferOp a, BufferOp b) const {
+  auto itA = accesses.find(a);
+  auto itB = accesses.find(b);
+  if (a == b || itA == accesses.end() || itB == accesses.end())
+    return 0;
+  int weight = 0;
+  for (const Access &accessA : itA->second)
+    for (const Access &accessB : itB->second)
+      weight += areConcurrent(accessA, accessB);
+  return weight;
+}
+
+SmallVector<std::pair<BufferOp, BufferOp>>
+BufferAccessAnalysis::getBankConflicts(TileOp tile) const {
+  const auto &targetModel = device.getTargetModel();
+  int memorySize = tile.isMemTile() ? targetModel.getMemTileSize()
+                                    : targetModel.getLocalMemorySize();
+  int bankSize =
+      memorySize / targetModel.getNumBanks(tile.getCol(), tile.getRow());
+
+  SmallVector<BufferOp> buffers;
+  device.walk([&](BufferOp buffer) {
+    if (buffer.getTileOp() == tile && buffer.getAddress())
+      buffers.push_back(buffer);
+  });
+
+  SmallVector<std::pair<BufferOp, BufferOp>> conflicts;
+  for (auto [i, a] : llvm::enumerate(buffers))
+    for (BufferOp b : ArrayRef<BufferOp>(buffers).drop_front(i + 1))
+      if (*a.getAddress() / bankSize == *b.getAddress() / bankSize &&
+          mayConflict(a, b))
+        conflicts.push_back({a, b});
+  return conflicts;
+}
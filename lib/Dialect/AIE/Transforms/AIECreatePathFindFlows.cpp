@@ -926,6 +926,10 @@ void AIEPathfinderPass::runOnOperation() {
   LLVM_DEBUG(llvm::dbgs() << "---Begin AIEPathfinderPass---\n");
 
   DeviceOp d = getOperation();
+  analyzer.parallelRouting = clParallelRouting;
+  analyzer.aStarRouting = clAStarRouting;
+  analyzer.routingSolutionFile = clRoutingSolution;
+  analyzer.routingReportFile = clRoutingReport;
   if (failed(analyzer.runAnalysis(d)))
     return signalPassFailure();
   OpBuilder builder = OpBuilder::atBlockTerminator(d.getBody());
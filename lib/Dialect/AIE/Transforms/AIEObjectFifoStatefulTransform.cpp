@@ -126,6 +126,236 @@ public:
   }
 };
 
+//===----------------------------------------------------------------------===//
+// ObjectFifo Liveness Analysis
+//===----------------------------------------------------------------------===//
+/// Live range of an objectFifo: its elements may hold data from operation
+/// start to operation end, which may be in different blocks or cores. A null
+/// start means from the beginning of the program, a null end until its end.
+struct LiveRange {
+  Operation *start = nullptr;
+  Operation *end = nullptr;
+};
+
+class ObjectFifoLivenessAnalysis {
+  DenseMap<ObjectFifoCreateOp, LiveRange> liveRanges;
+
+public:
+  /// Only objectFifos whose elements are accessed through shared memory by
+  /// the core of their producer tile, and by the core of their consumer tile
+  /// if there is one, are analyzed. If both are the same core, the live range
+  /// is limited to the innermost block, e.g. a loop body, that contains all
+  /// the acquires and releases and in which the objectFifo is empty every time
+  /// the block starts and ends. Otherwise, it starts at the first top-level
+  /// operation of the producer core that accesses the objectFifo, and only
+  /// ends, at the last one of the consumer core, when the consumer releases
+  /// every element the producer releases. Any other use of an objectFifo (a
+  /// link, a DMA, an acquire in a function, ...) leaves it without a live
+  /// range: memtile objectFifos are always accessed by DMAs, which repeat
+  /// their buffer descriptor chains forever.
+  ObjectFifoLivenessAnalysis(DeviceOp &device) {
+    for (auto createOp : device.getOps<ObjectFifoCreateOp>()) {
+      if (!isSharedMemoryOnly(createOp))
+        continue;
+      CoreOp producer = createOp.getProducerTileOp().getCoreOp();
+      auto consumerTile =
+          cast<TileOp>(createOp.getConsumerTiles()[0].getDefiningOp());
+      CoreOp consumer = consumerTile.getCoreOp();
+      if (!producer || !producer.getBody().hasOneBlock() ||
+          (consumer && !consumer.getBody().hasOneBlock()))
+        continue;
+      if (auto liveRange =
+              computeLiveRange(device, createOp, producer, consumer))
+        liveRanges[createOp] = *liveRange;
+    }
+  }
+
+  std::optional<LiveRange> getLiveRange(ObjectFifoCreateOp op) const {
+    if (auto it = liveRanges.find(op); it != liveRanges.end())
+      return it->second;
+    return {};
+  }
+
+  static bool overlap(LiveRange a, LiveRange b) {
+    return !isBefore(a.end, b.start) && !isBefore(b.end, a.start);
+  }
+
+private:
+  static bool isSharedMemoryOnly(ObjectFifoCreateOp op) {
+    if (op.getVia_DMA() || op.getRepeatCount().has_value() ||
+        op.getInitValues().has_value() || !op.getDimensionsToStream().empty())
+      return false;
+    if (op.getConsumerTiles().size() != 1)
+      return false;
+    if (!llvm::all_of(op.getDimensionsFromStreamPerConsumer(),
+                      [](BDDimLayoutArrayAttr dims) { return dims.empty(); }))
+      return false;
+    auto device = op->getParentOfType<DeviceOp>();
+    for (auto linkOp : device.getOps<ObjectFifoLinkOp>())
+      if (llvm::is_contained(linkOp.getInputObjectFifos(), op) ||
+          llvm::is_contained(linkOp.getOutputObjectFifos(), op))
+        return false;
+    auto consumerTile = cast<TileOp>(op.getConsumerTiles()[0].getDefiningOp());
+    TileOp producerTile = op.getProducerTileOp();
+    if (producerTile == consumerTile)
+      return true;
+    const auto &targetModel = getTargetModel(op);
+    if (producerTile.isShimTile() || consumerTile.isShimTile() ||
+        targetModel.isMemTile(producerTile.getCol(), producerTile.getRow()) ||
+        targetModel.isMemTile(consumerTile.getCol(), consumerTile.getRow()))
+      return false;
+    return targetModel.isLegalMemAffinity(
+               producerTile.getCol(), producerTile.getRow(),
+               consumerTile.getCol(), consumerTile.getRow()) ||
+           targetModel.isLegalMemAffinity(
+               consumerTile.getCol(), consumerTile.getRow(),
+               producerTile.getCol(), producerTile.getRow());
+  }
+
+  /// Returns true if operation a is done every time operation b starts: both
+  /// are in the same core and, in the innermost block that contains them, the
+  /// ancestor of a precedes that of b.
+  static bool isBefore(Operation *a, Operation *b) {
+    if (!a || !b)
+      return false;
+    for (Block *block = a->getBlock(); block;) {
+      if (Operation *bAncestor = block->findAncestorOpInBlock(*b))
+        return block->findAncestorOpInBlock(*a)->isBeforeInBlock(bAncestor);
+      Operation *parent = block->getParentOp();
+      if (!parent || isa<CoreOp>(parent))
+        return false;
+      block = parent->getBlock();
+    }
+    return false;
+  }
+
+  /// Returns the number of elements of the objectFifo released on the given
+  /// port by the operations of the block, or std::nullopt if some element
+  /// that they acquire on that port is still held at the end of the block.
+  static std::optional<int> getReleased(Block *block, ObjectFifoCreateOp op,
+                                        ObjectFifoPort port) {
+    int held = 0;
+    int released = 0;
+    for (Operation &blockOp : *block) {
+      if (auto acquireOp = dyn_cast<ObjectFifoAcquireOp>(blockOp)) {
+        if (acquireOp.getObjectFifo() == op && acquireOp.getPort() == port)
+          held = std::max(held, acquireOp.acqNumber());
+      } else if (auto releaseOp = dyn_cast<ObjectFifoReleaseOp>(blockOp)) {
+        if (releaseOp.getObjectFifo() != op || releaseOp.getPort() != port)
+          continue;
+        held -= releaseOp.relNumber();
+        released += releaseOp.relNumber();
+        if (held < 0)
+          return {};
+      }
+    }
+    if (held != 0)
+      return {};
+    return released;
+  }
+
+  /// Returns the first and last operations of the block that contain one of
+  /// the given operations, or std::nullopt if one of them is not in it.
+  static std::optional<LiveRange> getSpan(Block *block,
+                                          ArrayRef<Operation *> ops) {
+    LiveRange span;
+    for (Operation *op : ops) {
+      Operation *ancestor = block->findAncestorOpInBlock(*op);
+      if (!ancestor)
+        return {};
+      if (!span.start || ancestor->isBeforeInBlock(span.start))
+        span.start = ancestor;
+      if (!span.end || span.end->isBeforeInBlock(ancestor))
+        span.end = ancestor;
+    }
+    return span;
+  }
+
+  static bool allInBlock(Block *block, ArrayRef<Operation *> ops) {
+    return llvm::all_of(
+        ops, [&](Operation *op) { return op->getBlock() == block; });
+  }
+
+  /// The live range spans every acquire and release of the objectFifo, and
+  /// every operation using the elements it acquired, even indirectly.
+  static std::optional<LiveRange> computeLiveRange(DeviceOp &device,
+                                                   ObjectFifoCreateOp op,
+                                                   CoreOp producer,
+                                                   CoreOp consumer) {
+    auto uses = SymbolTable::getSymbolUses(op, device);
+    if (!uses)
+      return {};
+
+    // acquires and releases, and all operations accessing the elements, of
+    // the producer and the consumer core
+    SmallVector<Operation *> accesses[2];
+    SmallVector<Operation *> users[2];
+    for (auto use : *uses) {
+      Operation *user = use.getUser();
+      ObjectFifoPort port;
+      if (auto acquireOp = dyn_cast<ObjectFifoAcquireOp>(user))
+        port = acquireOp.getPort();
+      else if (auto releaseOp = dyn_cast<ObjectFifoReleaseOp>(user))
+        port = releaseOp.getPort();
+      else
+        return {};
+      bool produce = port == ObjectFifoPort::Produce;
+      CoreOp core = produce ? producer : consumer;
+      if (!core || user->getParentOfType<CoreOp>() != core)
+        return {};
+      accesses[produce].push_back(user);
+      users[produce].push_back(user);
+
+      SmallVector<Value> worklist(user->getResults());
+      DenseSet<Value> visited;
+      while (!worklist.empty()) {
+        Value value = worklist.pop_back_val();
+        if (!visited.insert(value).second)
+          continue;
+        for (Operation *valueUser : value.getUsers()) {
+          if (valueUser->getParentOfType<CoreOp>() != core)
+            return {};
+          users[produce].push_back(valueUser);
+          worklist.append(valueUser->result_begin(), valueUser->result_end());
+        }
+      }
+    }
+    if (accesses[true].empty())
+      return {};
+
+    Block *producerBody = &producer.getBody().front();
+    if (producer == consumer) {
+      SmallVector<Operation *> allAccesses(accesses[true]);
+      allAccesses.append(accesses[false]);
+      SmallVector<Operation *> allUsers(users[true]);
+      allUsers.append(users[false]);
+      Block *block = allAccesses.front()->getBlock();
+      if (block != producerBody && allInBlock(block, allAccesses)) {
+        auto produced = getReleased(block, op, ObjectFifoPort::Produce);
+        auto consumed = getReleased(block, op, ObjectFifoPort::Consume);
+        if (produced && consumed && *produced == *consumed)
+          if (auto liveRange = getSpan(block, allUsers))
+            return liveRange;
+      }
+      return getSpan(producerBody, allUsers);
+    }
+
+    LiveRange liveRange;
+    liveRange.start = getSpan(producerBody, users[true])->start;
+    if (!consumer || accesses[false].empty())
+      return liveRange;
+    Block *consumerBody = &consumer.getBody().front();
+    if (allInBlock(producerBody, accesses[true]) &&
+        allInBlock(consumerBody, accesses[false])) {
+      auto produced = getReleased(producerBody, op, ObjectFifoPort::Produce);
+      auto consumed = getReleased(consumerBody, op, ObjectFifoPort::Consume);
+      if (produced && consumed && *produced == *consumed)
+        liveRange.end = getSpan(consumerBody, users[false])->end;
+    }
+    return liveRange;
+  }
+};
+
 //===----------------------------------------------------------------------===//
 // Create objectFifos Pass
 //===----------------------------------------------------------------------===//
@@ -147,6 +377,12 @@ struct AIEObjectFifoStatefulTransformPass
   std::vector<ObjectFifoCreateOp>
       splitBecauseLink; // objfifos which have been split because they are
   // part of a Link, not because they didn't have a shared memory module
+  std::vector<std::pair<BufferOp, std::vector<LiveRange>>>
+      reusableBuffers; // buffers of objFifos with a live range, and the live
+  // ranges of all the objFifos aliasing them
+  DenseSet<std::pair<CoreOp, ObjectFifoCreateOp>>
+      dynamicFifos; // objFifos whose elements are indexed at runtime in a
+  // CoreOp, chosen by the cost model instead of unrolling loops for them
 
   /// Function that returns true if two tiles in the AIE array share a memory
   /// module. share_direction is equal to:
@@ -400,10 +636,31 @@ struct AIEObjectFifoStatefulTransformPass
     return locks;
   }
 
+  /// Function that returns a buffer of the given tile and type, previously
+  /// created for objectFifos whose live ranges do not overlap liveRange, or
+  /// nullptr if there is none. The buffer then also holds liveRange.
+  BufferOp findReusableBuffer(TileOp tile, MemRefType type,
+                              LiveRange liveRange) {
+    for (auto &[buff, ranges] : reusableBuffers) {
+      if (buff.getTileOp() != tile || buff.getType() != type)
+        continue;
+      if (llvm::any_of(ranges, [&](LiveRange r) {
+            return ObjectFifoLivenessAnalysis::overlap(r, liveRange);
+          }))
+        continue;
+      ranges.push_back(liveRange);
+      return buff;
+    }
+    return nullptr;
+  }
+
   /// Function used to create objectFifo elements and their locks.
-  /// It maps the input objectFifo to associated buffers and locks.
+  /// It maps the input objectFifo to associated buffers and locks. If the
+  /// objectFifo has a live range, its elements alias the buffers of other
+  /// objectFifos that are dead during that range, when there are any.
   void createObjectFifoElements(OpBuilder &builder, LockAnalysis &lockAnalysis,
-                                ObjectFifoCreateOp op, int share_direction) {
+                                ObjectFifoCreateOp op, int share_direction,
+                                std::optional<LiveRange> liveRange = {}) {
     if (!op.size())
       return;
 
@@ -483,6 +740,14 @@ struct AIEObjectFifoStatefulTransformPass
           initValues =
               llvm::cast<mlir::ElementsAttr>(op.getInitValues().value()[i]);
         }
+        if (liveRange) {
+          if (auto buff =
+                  findReusableBuffer(creation_tile, elemType, *liveRange)) {
+            buffers.push_back(buff);
+            of_elem_index++;
+            continue;
+          }
+        }
         auto buff = builder.create<BufferOp>(
             builder.getUnknownLoc(), elemType, creation_tile,
             builder.getStringAttr(op.name().str() + "_buff_" +
@@ -490,6 +755,8 @@ struct AIEObjectFifoStatefulTransformPass
             /*address*/ nullptr, initValues,
             /*mem_bank*/ nullptr);
         buffers.push_back(buff);
+        if (liveRange)
+          reusableBuffers.push_back({buff, {*liveRange}});
       }
       of_elem_index++;
     }
@@ -931,6 +1198,151 @@ struct AIEObjectFifoStatefulTransformPass
     return lcm;
   }
 
+  /// Function that checks if the accesses to op in coreOp can be lowered with
+  /// runtime indices without unrolling forLoop: all of them must be acquires
+  /// and releases directly in the body of forLoop that release every element
+  /// they acquire by the end of an iteration, so that each iteration acquires
+  /// the same number of elements as the first one.
+  bool canLowerDynamically(CoreOp coreOp, scf::ForOp forLoop,
+                           ObjectFifoCreateOp op) {
+    std::map<ObjectFifoPort, int> held;
+    WalkResult res = coreOp.walk([&](Operation *user) {
+      int acquired = 0;
+      int released = 0;
+      ObjectFifoPort port = ObjectFifoPort::Produce;
+      if (auto acqOp = dyn_cast<ObjectFifoAcquireOp>(user);
+          acqOp && acqOp.getObjectFifo() == op) {
+        acquired = acqOp.acqNumber();
+        port = acqOp.getPort();
+      } else if (auto relOp = dyn_cast<ObjectFifoReleaseOp>(user);
+                 relOp && relOp.getObjectFifo() == op) {
+        released = relOp.relNumber();
+        port = relOp.getPort();
+      } else {
+        return WalkResult::advance();
+      }
+      if (user->getParentOp() != forLoop)
+        return WalkResult::interrupt();
+      // ops of the loop body are visited in program order
+      held[port] = std::max(held[port], acquired) - released;
+      if (held[port] < 0)
+        return WalkResult::interrupt();
+      return WalkResult::advance();
+    });
+    if (res.wasInterrupted())
+      return false;
+    return llvm::all_of(held, [](auto &portHeld) { return !portHeld.second; });
+  }
+
+  /// Cost model choosing, for each loop of the cores on objectFifoTiles that
+  /// acquires objectFifo elements, between unrolling it by the LCM of the
+  /// objectFifo sizes and indexing the elements at runtime. Unrolling takes
+  /// program memory for the copies of the loop body; runtime indexing
+  /// executes a load and an index_switch per subview access and an update of
+  /// the index per release, at every iteration. Within a program memory
+  /// budget of clUnrollBudget operations per core, the loops that save the
+  /// most operations per unrolled operation are unrolled first; the
+  /// objectFifos of the others are added to dynamicFifos. Loops with a
+  /// non-constant trip count cannot be unrolled and always use runtime
+  /// indexing. Only targets with semaphore locks are supported, as the locks
+  /// of AIE1 objectFifos are chosen per element.
+  void selectDynamicObjectFifos(DeviceOp &device,
+                                std::set<TileOp> objectFifoTiles) {
+    if (!device.getTargetModel().hasProperty(
+            AIETargetModel::UsesSemaphoreLocks))
+      return;
+
+    struct LoopCost {
+      scf::ForOp loop;
+      std::vector<ObjectFifoCreateOp> fifos;
+      int64_t unrollOps; // operations added by unrolling
+      int64_t indexOps;  // operations added by runtime indexing
+      bool canUnroll;
+    };
+
+    for (auto coreOp : device.getOps<CoreOp>()) {
+      if (objectFifoTiles.count(coreOp.getTileOp()) == 0)
+        continue;
+
+      std::vector<LoopCost> loops;
+      coreOp.walk([&](scf::ForOp forLoop) {
+        std::set<int> objFifoSizes;
+        std::vector<ObjectFifoCreateOp> fifos;
+        int64_t indexOpsPerIteration = 0;
+        for (auto acqOp : forLoop.getBody()->getOps<ObjectFifoAcquireOp>()) {
+          ObjectFifoCreateOp op = acqOp.getObjectFifo();
+          objFifoSizes.insert(op.size());
+          if (std::find(fifos.begin(), fifos.end(), op) == fifos.end())
+            fifos.push_back(op);
+          // load, index_cast, index_switch and its yields per access
+          if (op.size() > 1)
+            for (auto *user : acqOp->getUsers())
+              if (isa<ObjectFifoSubviewAccessOp>(user))
+                indexOpsPerIteration += 3 + op.size() + 1;
+        }
+        // load, constant, add, compare, subtract, select and store
+        for (auto relOp : forLoop.getBody()->getOps<ObjectFifoReleaseOp>())
+          if (relOp.getObjectFifo().size() > 1)
+            indexOpsPerIteration += 7;
+        if (fifos.empty())
+          return;
+
+        // loops nested in, or containing, another loop with objectFifo
+        // accesses are left to unrolling
+        bool nested = false;
+        forLoop.getBody()->walk([&](scf::ForOp inner) {
+          if (!inner.getBody()->getOps<ObjectFifoAcquireOp>().empty())
+            nested = true;
+        });
+        for (auto outer = forLoop->getParentOfType<scf::ForOp>(); outer;
+             outer = outer->getParentOfType<scf::ForOp>())
+          if (!outer.getBody()->getOps<ObjectFifoAcquireOp>().empty())
+            nested = true;
+        if (nested)
+          return;
+
+        int64_t tripCount = 0;
+        if (forLoop.getSingleLowerBound() && forLoop.getSingleUpperBound() &&
+            forLoop.getSingleStep())
+          tripCount = constantTripCount(*(forLoop.getSingleLowerBound()),
+                                        *(forLoop.getSingleUpperBound()),
+                                        *(forLoop.getSingleStep()))
+                          .value_or(0);
+        int64_t bodyOps = 0;
+        forLoop.getBody()->walk([&](Operation *) { bodyOps++; });
+
+        // an unrolled loop holds unrollFactor copies of the body, followed
+        // by the copies of its remainder
+        int64_t unrollFactor = computeLCM(objFifoSizes);
+        int64_t copies = tripCount < unrollFactor
+                             ? tripCount - 1
+                             : unrollFactor - 1 + tripCount % unrollFactor;
+        loops.push_back({forLoop, fifos, std::max<int64_t>(copies, 0) * bodyOps,
+                         indexOpsPerIteration * tripCount, tripCount > 0});
+      });
+
+      // unroll the loops saving the most operations per unrolled operation
+      std::stable_sort(loops.begin(), loops.end(),
+                       [](const LoopCost &a, const LoopCost &b) {
+                         return a.indexOps * std::max<int64_t>(b.unrollOps, 1) >
+                                b.indexOps * std::max<int64_t>(a.unrollOps, 1);
+                       });
+      int64_t budget = clUnrollBudget;
+      for (LoopCost &cost : loops) {
+        if (cost.canUnroll && cost.unrollOps <= budget) {
+          budget -= cost.unrollOps;
+          continue;
+        }
+        if (!llvm::all_of(cost.fifos, [&](ObjectFifoCreateOp op) {
+              return canLowerDynamically(coreOp, cost.loop, op);
+            }))
+          continue;
+        for (ObjectFifoCreateOp op : cost.fifos)
+          dynamicFifos.insert({coreOp, op});
+      }
+    }
+  }
+
   // Function that unrolls for-loops that contain objectFifo operations.
   LogicalResult unrollForLoops(DeviceOp &device, OpBuilder &builder,
                                std::set<TileOp> objectFifoTiles) {
@@ -950,8 +1362,11 @@ struct AIEObjectFifoStatefulTransformPass
           remainderMap[forLoop.getOperation()] = 0;
           for (auto acqOp : body->getOps<ObjectFifoAcquireOp>()) {
             if (acqOp.getOperation()->getParentOp() == forLoop) {
-              foundMap[forLoop.getOperation()] = true;
               ObjectFifoCreateOp op = acqOp.getObjectFifo();
+              // elements of dynamic objFifos are indexed at runtime
+              if (dynamicFifos.contains({coreOp, op}))
+                continue;
+              foundMap[forLoop.getOperation()] = true;
               objFifoSizes.insert(op.size());
             }
           }
@@ -1068,137 +1483,155 @@ struct AIEObjectFifoStatefulTransformPass
   }
 
   // Function that generates the IR for objectfifo accesses to be handled at
-  // runtime.
+  // runtime: all objectfifo accesses of the cores on objectFifoTiles, and
+  // those of the objectfifos in dynamicFifos.
   LogicalResult dynamicGlobalObjectFifos(DeviceOp &device, OpBuilder &builder,
                                          std::set<TileOp> objectFifoTiles) {
     for (auto coreOp : device.getOps<CoreOp>()) {
-      if (objectFifoTiles.count(coreOp.getTileOp()) <= 0)
+      bool allDynamic = objectFifoTiles.count(coreOp.getTileOp()) > 0;
+      auto isDynamic = [&](ObjectFifoCreateOp op) {
+        return allDynamic || dynamicFifos.contains({coreOp, op});
+      };
+      // For each core: count the number of objectFifos and create
+      // a global buffer just before the core to track index of
+      // next object to access.
+      // !! NOTE !! objectFifos with same producer / consumer tile
+      // need two counters (accessed based on the ObjectFifoPort)
+      std::map<std::pair<ObjectFifoCreateOp, ObjectFifoPort>, int> fifoSizes;
+      auto addFifo = [&](ObjectFifoCreateOp op, ObjectFifoPort port) {
+        if (isDynamic(op) && fifoSizes.find({op, port}) == fifoSizes.end())
+          fifoSizes[{op, port}] = op.size();
+      };
+      // releases count too: the elements may have been acquired by a
+      // previous acquire of a larger subview
+      coreOp.walk([&](Operation *op) {
+        if (auto acqOp = dyn_cast<ObjectFifoAcquireOp>(op))
+          addFifo(acqOp.getObjectFifo(), acqOp.getPort());
+        else if (auto relOp = dyn_cast<ObjectFifoReleaseOp>(op))
+          addFifo(relOp.getObjectFifo(), relOp.getPort());
+      });
+      if (fifoSizes.empty() && !allDynamic)
         continue;
-      if (objectFifoTiles.count(coreOp.getTileOp()) > 0) {
-        // For each core: count the number of objectFifos and create
-        // a global buffer just before the core to track index of
-        // next object to access.
-        // !! NOTE !! objectFifos with same producer / consumer tile
-        // need two counters (accessed based on the ObjectFifoPort)
-        std::map<std::pair<ObjectFifoCreateOp, ObjectFifoPort>, int> fifoSizes;
-        coreOp.walk([&](ObjectFifoAcquireOp acqOp) {
-          ObjectFifoCreateOp op = acqOp.getObjectFifo();
-          ObjectFifoPort port = acqOp.getPort();
-          if (fifoSizes.find({op, port}) == fifoSizes.end())
-            fifoSizes[{op, port}] = op.size();
-        });
-        builder.setInsertionPoint(coreOp);
-        auto memrefTy =
-            MemRefType::get(SmallVector<int64_t>{(int64_t)fifoSizes.size()},
-                            builder.getI32Type());
-        auto globalNextIndex = builder.create<BufferOp>(
-            builder.getUnknownLoc(), memrefTy, coreOp.getTile(),
-            /*sym_name*/ nullptr, /*address*/ nullptr,
-            /*initial_value*/ nullptr, /*mem_bank*/ nullptr);
-
-        // Initialize all counters in the global buffers to 0.
-        // Also, keep a map of the ConstantOps for the indices per OF
-        // and a map with the ConstantOps for the sizes per OF.
-        std::map<std::pair<ObjectFifoCreateOp, ObjectFifoPort>,
-                 arith::ConstantOp>
-            globalIndices;
-        std::map<std::pair<ObjectFifoCreateOp, ObjectFifoPort>,
-                 arith::ConstantOp>
-            constantSizes;
-        int index = 0;
-        builder.setInsertionPointToStart(&(coreOp.getBody().front()));
-        Value initVal = builder.create<arith::ConstantOp>(
-            builder.getUnknownLoc(), builder.getI32IntegerAttr(0));
-        for (auto i : fifoSizes) {
-          auto indexOp = builder.create<arith::ConstantOp>(
-              initVal.getLoc(), builder.getIndexAttr(index));
-          globalIndices[i.first] = indexOp;
-          index++;
-          auto size = builder.create<arith::ConstantOp>(
-              indexOp.getLoc(), builder.getI32IntegerAttr(i.second));
-          constantSizes[i.first] = size;
-          builder.create<memref::StoreOp>(
-              size.getLoc(), initVal, globalNextIndex,
-              ValueRange(ArrayRef({indexOp.getResult()})));
+      builder.setInsertionPoint(coreOp);
+      auto memrefTy =
+          MemRefType::get(SmallVector<int64_t>{(int64_t)fifoSizes.size()},
+                          builder.getI32Type());
+      auto globalNextIndex = builder.create<BufferOp>(
+          builder.getUnknownLoc(), memrefTy, coreOp.getTile(),
+          /*sym_name*/ nullptr, /*address*/ nullptr,
+          /*initial_value*/ nullptr, /*mem_bank*/ nullptr);
+
+      // Initialize all counters in the global buffers to 0.
+      // Also, keep a map of the ConstantOps for the indices per OF
+      // and a map with the ConstantOps for the sizes per OF.
+      std::map<std::pair<ObjectFifoCreateOp, ObjectFifoPort>, arith::ConstantOp>
+          globalIndices;
+      std::map<std::pair<ObjectFifoCreateOp, ObjectFifoPort>, arith::ConstantOp>
+          constantSizes;
+      int index = 0;
+      builder.setInsertionPointToStart(&(coreOp.getBody().front()));
+      Value initVal = builder.create<arith::ConstantOp>(
+          builder.getUnknownLoc(), builder.getI32IntegerAttr(0));
+      for (auto i : fifoSizes) {
+        auto indexOp = builder.create<arith::ConstantOp>(
+            initVal.getLoc(), builder.getIndexAttr(index));
+        globalIndices[i.first] = indexOp;
+        index++;
+        auto size = builder.create<arith::ConstantOp>(
+            indexOp.getLoc(), builder.getI32IntegerAttr(i.second));
+        constantSizes[i.first] = size;
+        builder.create<memref::StoreOp>(
+            size.getLoc(), initVal, globalNextIndex,
+            ValueRange(ArrayRef({indexOp.getResult()})));
+      }
+
+      // Walk the code:
+      // - after each ObjectFifoReleaseOp:
+      //    - globalNextIndex: add #rel modulo objfifo depth
+      // - before each ObjectFifoAcquireOp:
+      //    - globalNextIndex: load index and use it to index_switch (one
+      //    IndexSwithOp per AccessOp)
+      WalkResult res = coreOp.walk([&](Operation *op) {
+        if (auto relOp = dyn_cast<ObjectFifoReleaseOp>(op)) {
+          ObjectFifoCreateOp createOp = relOp.getObjectFifo();
+          ObjectFifoPort port = relOp.getPort();
+          if (!isDynamic(createOp))
+            return WalkResult::advance();
+          updateGlobalNextIndex(builder, relOp, globalNextIndex,
+                                globalIndices[{createOp, port}],
+                                constantSizes[{createOp, port}]);
         }
+        if (auto acqOp = dyn_cast<ObjectFifoAcquireOp>(op)) {
+          std::vector<ObjectFifoSubviewAccessOp> accessOps;
+          for (auto u : acqOp->getUsers())
+            if (auto accessOp = dyn_cast<ObjectFifoSubviewAccessOp>(u))
+              accessOps.push_back(accessOp);
+
+          for (auto accessOp : accessOps) {
+            ObjectFifoCreateOp createOp = acqOp.getObjectFifo();
+            ObjectFifoPort port = acqOp.getPort();
+            if (!isDynamic(createOp))
+              return WalkResult::advance();
 
-        // Walk the code:
-        // - after each ObjectFifoReleaseOp:
-        //    - globalNextIndex: add #rel modulo objfifo depth
-        // - before each ObjectFifoAcquireOp:
-        //    - globalNextIndex: load index and use it to index_switch (one
-        //    IndexSwithOp per AccessOp)
-        WalkResult res = coreOp.walk([&](Operation *op) {
-          if (auto relOp = dyn_cast<ObjectFifoReleaseOp>(op)) {
-            ObjectFifoCreateOp createOp = relOp.getObjectFifo();
-            ObjectFifoPort port = relOp.getPort();
-            updateGlobalNextIndex(builder, relOp, globalNextIndex,
-                                  globalIndices[{createOp, port}],
-                                  constantSizes[{createOp, port}]);
-          }
-          if (auto acqOp = dyn_cast<ObjectFifoAcquireOp>(op)) {
-            std::vector<ObjectFifoSubviewAccessOp> accessOps;
-            for (auto u : acqOp->getUsers())
-              if (auto accessOp = dyn_cast<ObjectFifoSubviewAccessOp>(u))
-                accessOps.push_back(accessOp);
-
-            for (auto accessOp : accessOps) {
-              ObjectFifoCreateOp createOp = acqOp.getObjectFifo();
-              ObjectFifoPort port = acqOp.getPort();
-
-              // Single switch case
-              if (fifoSizes[{createOp, port}] == 1)
-                return WalkResult::advance();
-
-              // Create a switch for each subview access
-              builder.setInsertionPointAfter(accessOp);
-              auto switchIndexAsInteger = builder.create<memref::LoadOp>(
-                  builder.getUnknownLoc(), globalNextIndex,
-                  ValueRange(
-                      ArrayRef({globalIndices[{createOp, port}].getResult()})));
-              auto switchIndex = builder.create<arith::IndexCastOp>(
-                  builder.getUnknownLoc(), builder.getIndexType(),
-                  switchIndexAsInteger);
-              unsigned caseRegionCounts = fifoSizes[{createOp, port}];
-              SmallVector<int64_t, 4> caseValues;
-              for (int i = 0; i < fifoSizes[{createOp, port}]; ++i) {
-                caseValues.push_back(i);
-              }
-              auto cases =
-                  DenseI64ArrayAttr::get(builder.getContext(), caseValues);
-              auto switchOp = builder.create<scf::IndexSwitchOp>(
-                  switchIndex.getLoc(),
-                  TypeRange({buffersPerFifo[createOp][0].getType()}),
-                  switchIndex, cases, caseRegionCounts);
-              // Create default case of IndexSwitchOp
-              builder.createBlock(&switchOp.getDefaultRegion());
-              auto bufferIndex = (accessOp.getIndex()) % createOp.size();
-              builder.setInsertionPointToStart(&(switchOp.getDefaultBlock()));
-              builder.create<scf::YieldOp>(
-                  builder.getUnknownLoc(),
-                  buffersPerFifo[createOp][bufferIndex].getResult());
-              for (int i = 0; i < fifoSizes[{createOp, port}]; ++i) {
-                // Create other cases of IndexSwitchOp
-                builder.createBlock(&switchOp.getCaseRegions()[i]);
-                builder.setInsertionPoint(&switchOp.getCaseBlock(i),
-                                          switchOp.getCaseBlock(i).begin());
-                int bufferToBeAccesed =
-                    (accessOp.getIndex() + i) % fifoSizes[{createOp, port}];
-                builder.create<scf::YieldOp>(
-                    switchOp.getCaseRegions()[i].getLoc(),
-                    buffersPerFifo[createOp][bufferToBeAccesed].getResult());
-              }
+            // Single switch case
+            if (fifoSizes[{createOp, port}] == 1)
+              return WalkResult::advance();
 
-              // Replace all uses of accessed objectfifo buffers with
-              // results of switchOps
-              accessOp.getOutput().replaceAllUsesWith(switchOp.getResult(0));
+            // if objFifo was linked with others, its elements are those of
+            // the objFifo they were created for
+            ObjectFifoCreateOp target = createOp;
+            if (auto linkOp = getOptionalLinkOp(createOp))
+              if (objFifoLinks.find(*linkOp) != objFifoLinks.end())
+                target = objFifoLinks[*linkOp];
+
+            // Create a switch for each subview access
+            builder.setInsertionPointAfter(accessOp);
+            auto switchIndexAsInteger = builder.create<memref::LoadOp>(
+                builder.getUnknownLoc(), globalNextIndex,
+                ValueRange(
+                    ArrayRef({globalIndices[{createOp, port}].getResult()})));
+            auto switchIndex = builder.create<arith::IndexCastOp>(
+                builder.getUnknownLoc(), builder.getIndexType(),
+                switchIndexAsInteger);
+            unsigned caseRegionCounts = fifoSizes[{createOp, port}];
+            SmallVector<int64_t, 4> caseValues;
+            for (int i = 0; i < fifoSizes[{createOp, port}]; ++i) {
+              caseValues.push_back(i);
+            }
+            auto cases =
+                DenseI64ArrayAttr::get(builder.getContext(), caseValues);
+            auto switchOp = builder.create<scf::IndexSwitchOp>(
+                switchIndex.getLoc(),
+                TypeRange({buffersPerFifo[target][0].getType()}),
+                switchIndex, cases, caseRegionCounts);
+            // Create default case of IndexSwitchOp
+            builder.createBlock(&switchOp.getDefaultRegion());
+            auto bufferIndex = (accessOp.getIndex()) % createOp.size();
+            builder.setInsertionPointToStart(&(switchOp.getDefaultBlock()));
+            builder.create<scf::YieldOp>(
+                builder.getUnknownLoc(),
+                buffersPerFifo[target][bufferIndex].getResult());
+            for (int i = 0; i < fifoSizes[{createOp, port}]; ++i) {
+              // Create other cases of IndexSwitchOp
+              builder.createBlock(&switchOp.getCaseRegions()[i]);
+              builder.setInsertionPoint(&switchOp.getCaseBlock(i),
+                                        switchOp.getCaseBlock(i).begin());
+              int bufferToBeAccesed =
+                  (accessOp.getIndex() + i) % fifoSizes[{createOp, port}];
+              builder.create<scf::YieldOp>(
+                  switchOp.getCaseRegions()[i].getLoc(),
+                  buffersPerFifo[target][bufferToBeAccesed].getResult());
             }
+
+            // Replace all uses of accessed objectfifo buffers with
+            // results of switchOps
+            accessOp.getOutput().replaceAllUsesWith(switchOp.getResult(0));
           }
-          return WalkResult::advance();
-        });
-        if (res.wasInterrupted())
-          return failure();
-      }
+        }
+        return WalkResult::advance();
+      });
+      if (res.wasInterrupted())
+        return failure();
     }
     return success();
   }
@@ -1380,6 +1813,9 @@ struct AIEObjectFifoStatefulTransformPass
     DeviceOp device = getOperation();
     LockAnalysis lockAnalysis(device);
     DMAChannelAnalysis dmaAnalysis(device);
+    // computed before objectFifos are split, as the consumer end of a split
+    // objectFifo looks local to its tile
+    ObjectFifoLivenessAnalysis livenessAnalysis(device);
     OpBuilder builder = OpBuilder::atBlockTerminator(device.getBody());
     auto ctx = device->getContext();
     auto producerWireType = WireBundle::DMA;
@@ -1502,8 +1938,11 @@ struct AIEObjectFifoStatefulTransformPass
       // if split, the necessary size for producer fifo might change
       if (shared) {
         checkAndApplyViaSharedMemAttribute(createOp, share_direction);
+        std::optional<LiveRange> liveRange;
+        if (clReuseCoreObjectFifoBuffers)
+          liveRange = livenessAnalysis.getLiveRange(createOp);
         createObjectFifoElements(builder, lockAnalysis, createOp,
-                                 share_direction);
+                                 share_direction, liveRange);
       } else {
         if (createOp.getViaSharedMem().has_value())
           createOp->emitWarning("No access to shared memory module; ignoring "
@@ -1603,6 +2042,7 @@ struct AIEObjectFifoStatefulTransformPass
     } else {
       std::set<TileOp> dynamicTiles;
       std::set<TileOp> unrollTiles;
+      std::set<TileOp> costModelTiles;
       for (auto c : device.getOps<CoreOp>()) {
         TileOp t = c.getTileOp();
         if (objectFifoTiles.count(t) > 0) {
@@ -1613,9 +2053,12 @@ struct AIEObjectFifoStatefulTransformPass
               unrollTiles.insert(t);
           } else {
             unrollTiles.insert(t);
+            costModelTiles.insert(t);
           }
         }
       }
+      if (clUnrollBudget > 0)
+        selectDynamicObjectFifos(device, costModelTiles);
       if (failed(dynamicGlobalObjectFifos(device, builder, dynamicTiles)))
         signalPassFailure();
       if (failed(unrollForLoops(device, builder, unrollTiles)))
@@ -11,17 +11,219 @@
 #include "aie/Dialect/AIE/Transforms/AIEPathFinder.h"
 #include "d_ary_heap.h"
 
+#include "mlir/IR/Threading.h"
+
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_os_ostream.h"
 
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/MapVector.h"
 
+#include <mutex>
+
 using namespace mlir;
 using namespace xilinx;
 using namespace xilinx::AIE;
 
 #define DEBUG_TYPE "aie-pathfinder"
 
+static llvm::json::Value endPointToJSON(const PathEndPoint &endPoint) {
+  return llvm::json::Object{
+      {"col", endPoint.coords.col},
+      {"row", endPoint.coords.row},
+      {"bundle", stringifyWireBundle(endPoint.port.bundle).str()},
+      {"channel", endPoint.port.channel}};
+}
+
+static std::optional<PathEndPoint>
+endPointFromJSON(const llvm::json::Value *value) {
+  const llvm::json::Object *object = value ? value->getAsObject() : nullptr;
+  if (!object)
+    return std::nullopt;
+  auto col = object->getInteger("col");
+  auto row = object->getInteger("row");
+  auto bundleName = object->getString("bundle");
+  auto channel = object->getInteger("channel");
+  if (!col || !row || !bundleName || !channel)
+    return std::nullopt;
+  auto bundle = symbolizeWireBundle(*bundleName);
+  if (!bundle)
+    return std::nullopt;
+  return PathEndPoint{{static_cast<int>(*col), static_cast<int>(*row)},
+                      {*bundle, static_cast<int>(*channel)}};
+}
+
+// A routing solution is stored as
+// {"devices": {key: {"flows": [{"src": ep, "dsts": [ep...],
+//                               "channels": [[ep, ep] | null...]}]}...}}
+// where ep is {"col", "row", "bundle", "channel"} and key identifies the
+// device, see getRoutingSolutionKey.
+static llvm::json::Value
+routedFlowsToJSON(const std::vector<RoutedFlow> &routedFlows) {
+  llvm::json::Array flowsJSON;
+  for (const auto &[src, dsts, channels] : routedFlows) {
+    llvm::json::Array dstsJSON;
+    for (const auto &dst : dsts)
+      dstsJSON.push_back(endPointToJSON(dst));
+    llvm::json::Array channelsJSON;
+    for (const auto &channel : channels) {
+      if (channel)
+        channelsJSON.push_back(llvm::json::Array{
+            endPointToJSON(channel->first), endPointToJSON(channel->second)});
+      else
+        channelsJSON.push_back(nullptr);
+    }
+    flowsJSON.push_back(
+        llvm::json::Object{{"src", endPointToJSON(src)},
+                           {"dsts", std::move(dstsJSON)},
+                           {"channels", std::move(channelsJSON)}});
+  }
+  return llvm::json::Object{{"flows", std::move(flowsJSON)}};
+}
+
+static std::optional<std::vector<RoutedFlow>>
+routedFlowsFromJSON(const llvm::json::Value &value) {
+  const llvm::json::Object *object = value.getAsObject();
+  const llvm::json::Array *flowsJSON =
+      object ? object->getArray("flows") : nullptr;
+  if (!flowsJSON)
+    return std::nullopt;
+  std::vector<RoutedFlow> routedFlows;
+  for (const llvm::json::Value &flowValue : *flowsJSON) {
+    const llvm::json::Object *flowJSON = flowValue.getAsObject();
+    if (!flowJSON)
+      return std::nullopt;
+    auto src = endPointFromJSON(flowJSON->get("src"));
+    const llvm::json::Array *dstsJSON = flowJSON->getArray("dsts");
+    const llvm::json::Array *channelsJSON = flowJSON->getArray("channels");
+    if (!src || !dstsJSON || !channelsJSON)
+      return std::nullopt;
+    RoutedFlow routedFlow{*src, {}, {}};
+    for (const llvm::json::Value &dstValue : *dstsJSON) {
+      auto dst = endPointFromJSON(&dstValue);
+      if (!dst)
+        return std::nullopt;
+      routedFlow.dsts.push_back(*dst);
+    }
+    for (const llvm::json::Value &channelValue : *channelsJSON) {
+      if (channelValue.getAsNull()) {
+        routedFlow.channels.push_back(std::nullopt);
+        continue;
+      }
+      const llvm::json::Array *channelJSON = channelValue.getAsArray();
+      if (!channelJSON || channelJSON->size() != 2)
+        return std::nullopt;
+      auto channelSrc = endPointFromJSON(&(*channelJSON)[0]);
+      auto channelDst = endPointFromJSON(&(*channelJSON)[1]);
+      if (!channelSrc || !channelDst)
+        return std::nullopt;
+      routedFlow.channels.push_back(std::make_pair(*channelSrc, *channelDst));
+    }
+    routedFlows.push_back(std::move(routedFlow));
+  }
+  return routedFlows;
+}
+
+// The routes of a device are stored under the name of its target, numbered
+// from the second device of the module with the same target on.
+static std::string getRoutingSolutionKey(DeviceOp device) {
+  std::string key = stringifyAIEDevice(device.getDevice()).str();
+  int index = 0;
+  for (Operation &op : *device->getBlock()) {
+    if (&op == device.getOperation())
+      break;
+    if (auto other = dyn_cast<DeviceOp>(op);
+        other && other.getDevice() == device.getDevice())
+      index++;
+  }
+  if (index)
+    key += "_" + std::to_string(index);
+  return key;
+}
+
+// The devices of a module may be routed concurrently, and each one reads and
+// rewrites its own entry of the shared routing solution file.
+static std::mutex routingSolutionFileMutex;
+
+// Returns the devices object of the routing solution file, which is empty if
+// the file does not exist yet, or std::nullopt if it is malformed.
+static std::optional<llvm::json::Object>
+readRoutingSolutions(StringRef fileName) {
+  auto buffer = llvm::MemoryBuffer::getFile(fileName);
+  if (!buffer)
+    return llvm::json::Object();
+  auto json = llvm::json::parse((*buffer)->getBuffer());
+  if (!json) {
+    llvm::consumeError(json.takeError());
+    return std::nullopt;
+  }
+  const llvm::json::Object *object = json->getAsObject();
+  const llvm::json::Object *devices =
+      object ? object->getObject("devices") : nullptr;
+  if (!devices)
+    return std::nullopt;
+  return *devices;
+}
+
+// The routing report is written as
+// {"iterations": [{"overCapacityChannels", "overCapacityHistory", "maxDemand",
+//                  "pathLength"}...],
+//  "switchboxes": [{"col", "row", "ports", "usedPorts", "links", "usedLinks",
+//                   "maxPacketSharing", "overCapacity"}...],
+//  "channels": [{"src": ep, "dst": ep, "demand", "overCapacity",
+//                "circuitFlows", "packetFlows", "packetGroups"}...],
+//  "flows": [{"src": ep, "packet", "hops", "dsts": [{"dst": ep, "hops"}...]}]}
+static llvm::json::Value routingReportToJSON(const RoutingReport &report) {
+  llvm::json::Array iterationsJSON;
+  for (const auto &iteration : report.iterations)
+    iterationsJSON.push_back(llvm::json::Object{
+        {"overCapacityChannels", iteration.overCapacityChannels},
+        {"overCapacityHistory", iteration.overCapacityHistory},
+        {"maxDemand", iteration.maxDemand},
+        {"pathLength", iteration.pathLength}});
+  llvm::json::Array switchboxesJSON;
+  for (const auto &sb : report.switchboxes)
+    switchboxesJSON.push_back(
+        llvm::json::Object{{"col", sb.coords.col},
+                           {"row", sb.coords.row},
+                           {"ports", sb.numPorts},
+                           {"usedPorts", sb.usedPorts},
+                           {"links", sb.numLinks},
+                           {"usedLinks", sb.usedLinks},
+                           {"maxPacketSharing", sb.maxPacketSharing},
+                           {"overCapacity", sb.overCapacity}});
+  llvm::json::Array channelsJSON;
+  for (const auto &channel : report.channels)
+    channelsJSON.push_back(
+        llvm::json::Object{{"src", endPointToJSON(channel.src)},
+                           {"dst", endPointToJSON(channel.dst)},
+                           {"demand", channel.demand},
+                           {"overCapacity", channel.overCapacity},
+                           {"circuitFlows", channel.circuitFlows},
+                           {"packetFlows", channel.packetFlows},
+                           {"packetGroups", channel.packetGroups}});
+  llvm::json::Array flowsJSON;
+  for (const auto &flow : report.flows) {
+    llvm::json::Array dstsJSON;
+    for (const auto &[dst, hops] : flow.dsts)
+      dstsJSON.push_back(
+          llvm::json::Object{{"dst", endPointToJSON(dst)}, {"hops", hops}});
+    flowsJSON.push_back(llvm::json::Object{{"src", endPointToJSON(flow.src)},
+                                           {"packet", flow.isPacketFlow},
+                                           {"hops", flow.hops},
+                                           {"reused", flow.reused},
+                                           {"dsts", std::move(dstsJSON)}});
+  }
+  return llvm::json::Object{{"iterations", std::move(iterationsJSON)},
+                            {"switchboxes", std::move(switchboxesJSON)},
+                            {"channels", std::move(channelsJSON)},
+                            {"flows", std::move(flowsJSON)}};
+}
+
 LogicalResult DynamicTileAnalysis::runAnalysis(DeviceOp &device) {
   LLVM_DEBUG(llvm::dbgs() << "\t---Begin DynamicTileAnalysis Constructor---\n");
   // find the maxCol and maxRow
@@ -33,6 +235,12 @@ LogicalResult DynamicTileAnalysis::runAnalysis(DeviceOp &device) {
   }
 
   pathfinder->initialize(maxCol, maxRow, device.getTargetModel());
+  // Parallel routing batches flows whose searches stay in disjoint boxes. A
+  // Dijkstra search covers the whole array, so it routes with A* instead.
+  if (parallelRouting)
+    pathfinder->enableParallelRouting(device->getContext());
+  if (aStarRouting || parallelRouting)
+    pathfinder->enableAStarRouting();
 
   // For each flow (circuit + packet) in the device, add it to pathfinder. Each
   // source can map to multiple different destinations (fanout). Control packet
@@ -101,14 +309,68 @@ LogicalResult DynamicTileAnalysis::runAnalysis(DeviceOp &device) {
       return switchboxOp.emitOpError() << "Unable to add fixed connections";
   }
 
+  // seed incremental routing with the previous solution of this device, if
+  // there is one
+  std::string routingSolutionKey = getRoutingSolutionKey(device);
+  if (!routingSolutionFile.empty()) {
+    std::optional<llvm::json::Object> solutions;
+    {
+      std::lock_guard<std::mutex> lock(routingSolutionFileMutex);
+      solutions = readRoutingSolutions(routingSolutionFile);
+    }
+    const llvm::json::Value *solution =
+        solutions ? solutions->get(routingSolutionKey) : nullptr;
+    std::optional<std::vector<RoutedFlow>> priorFlows;
+    if (solution)
+      priorFlows = routedFlowsFromJSON(*solution);
+    if (!solutions || (solution && !priorFlows))
+      device.emitWarning("Ignoring malformed routing solution ")
+          << routingSolutionFile;
+    else if (priorFlows)
+      for (const auto &routedFlow : *priorFlows)
+        pathfinder->addPriorRoute(routedFlow);
+  }
+
   // all flows are now populated, call the congestion-aware pathfinder
   // algorithm
   // check whether the pathfinder algorithm creates a legal routing
-  if (auto maybeFlowSolutions = pathfinder->findPaths(maxIterations))
+  auto maybeFlowSolutions = pathfinder->findPaths(maxIterations);
+
+  // the report is most useful when routing fails, so write it first
+  if (!routingReportFile.empty()) {
+    std::error_code ec;
+    llvm::raw_fd_ostream os(routingReportFile, ec);
+    if (ec)
+      return device.emitError("Unable to write routing report ")
+             << routingReportFile << ": " << ec.message();
+    llvm::json::Value report =
+        routingReportToJSON(pathfinder->getRoutingReport());
+    os << llvm::formatv("{0:2}", report) << "\n";
+  }
+
+  if (maybeFlowSolutions)
     flowSolutions = maybeFlowSolutions.value();
   else
     return device.emitError("Unable to find a legal routing");
 
+  // replace the entry of this device, keeping those of the other devices
+  if (!routingSolutionFile.empty()) {
+    std::lock_guard<std::mutex> lock(routingSolutionFileMutex);
+    llvm::json::Object solutions =
+        readRoutingSolutions(routingSolutionFile)
+            .value_or(llvm::json::Object());
+    solutions[routingSolutionKey] =
+        routedFlowsToJSON(pathfinder->getRoutedFlows());
+    std::error_code ec;
+    llvm::raw_fd_ostream os(routingSolutionFile, ec);
+    if (ec)
+      return device.emitError("Unable to write routing solution ")
+             << routingSolutionFile << ": " << ec.message();
+    llvm::json::Value json =
+        llvm::json::Object{{"devices", std::move(solutions)}};
+    os << llvm::formatv("{0:2}", json) << "\n";
+  }
+
   // initialize all flows as unprocessed to prep for rewrite
   for (const auto &[PathEndPoint, switchSetting] : flowSolutions) {
     processedFlows[PathEndPoint] = false;
@@ -188,6 +450,7 @@ ShimMuxOp DynamicTileAnalysis::getShimMux(OpBuilder &builder, int col) {
 
 void Pathfinder::initialize(int maxCol, int maxRow,
                             const AIETargetModel &targetModel) {
+  maxCoords = {maxCol, maxRow};
 
   std::map<WireBundle, int> maxChannels;
   auto intraconnect = [&](int col, int row) {
@@ -421,19 +684,99 @@ bool Pathfinder::addFixedConnection(SwitchboxOp switchboxOp) {
 
 static constexpr double INF = std::numeric_limits<double>::max();
 
-std::map<PathEndPoint, PathEndPoint>
-Pathfinder::dijkstraShortestPaths(PathEndPoint src) {
-  // Use std::map instead of DenseMap because DenseMap doesn't let you
-  // overwrite tombstones.
-  std::map<PathEndPoint, double> distance;
-  std::map<PathEndPoint, PathEndPoint> preds;
-  std::map<PathEndPoint, uint64_t> indexInHeap;
-  enum Color { WHITE, GRAY, BLACK };
-  std::map<PathEndPoint, Color> colors;
+void Pathfinder::buildRoutingGraph() {
+  routingGraph = RoutingGraph();
+  auto &nodes = routingGraph.nodes;
+  for (const auto &[_, sb] : graph) {
+    for (const auto &port : sb.srcPorts)
+      nodes.emplace_back(sb.srcCoords, port);
+    for (const auto &port : sb.dstPorts)
+      nodes.emplace_back(sb.dstCoords, port);
+  }
+  std::sort(nodes.begin(), nodes.end());
+  nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+
+  auto indexOf = [](const std::vector<Port> &ports, const Port &port) {
+    return std::distance(ports.begin(),
+                         std::find(ports.begin(), ports.end(), port));
+  };
+
+  routingGraph.offsets.reserve(nodes.size() + 1);
+  for (RoutingGraph::NodeID n = 0; n < nodes.size(); n++) {
+    routingGraph.offsets.push_back(routingGraph.channels.size());
+    const PathEndPoint &src = nodes[n];
+    auto addChannel = [&](const PathEndPoint &dest, SwitchboxConnect &sb,
+                          size_t i, size_t j) {
+      // every port of every SwitchboxConnect is a node
+      RoutingGraph::NodeID d = *routingGraph.lookup(dest);
+      routingGraph.channels.push_back(
+          {n, d, &sb, static_cast<uint32_t>(i), static_cast<uint32_t>(j)});
+    };
+
+    // connections within the same switchbox
+    if (auto it = graph.find(std::make_pair(src.coords, src.coords));
+        it != graph.end()) {
+      auto &sb = it->second;
+      for (size_t i = 0; i < sb.srcPorts.size(); i++) {
+        if (sb.srcPorts[i] != src.port)
+          continue;
+        for (size_t j = 0; j < sb.dstPorts.size(); j++)
+          if (sb.connectivity[i][j] == Connectivity::AVAILABLE)
+            addChannel({src.coords, sb.dstPorts[j]}, sb, i, j);
+      }
+    }
+
+    // connections to neighboring switchboxes
+    std::vector<std::pair<TileID, Port>> neighbors = {
+        {{src.coords.col, src.coords.row - 1},
+         {WireBundle::North, src.port.channel}},
+        {{src.coords.col - 1, src.coords.row},
+         {WireBundle::East, src.port.channel}},
+        {{src.coords.col, src.coords.row + 1},
+         {WireBundle::South, src.port.channel}},
+        {{src.coords.col + 1, src.coords.row},
+         {WireBundle::West, src.port.channel}}};
+    for (const auto &[neighborCoords, neighborPort] : neighbors) {
+      auto it = graph.find(std::make_pair(src.coords, neighborCoords));
+      if (it == graph.end() ||
+          src.port.bundle != getConnectingBundle(neighborPort.bundle))
+        continue;
+      auto &sb = it->second;
+      size_t i = indexOf(sb.srcPorts, src.port);
+      size_t j = indexOf(sb.dstPorts, neighborPort);
+      if (j == sb.dstPorts.size())
+        continue;
+      assert(i < sb.srcPorts.size());
+      addChannel({neighborCoords, neighborPort}, sb, i, j);
+    }
+
+    // visit destinations in end point order, as the search always has
+    std::sort(routingGraph.channels.begin() + routingGraph.offsets.back(),
+              routingGraph.channels.end(),
+              [](const RoutingGraph::Channel &lhs,
+                 const RoutingGraph::Channel &rhs) {
+                return lhs.dst < rhs.dst;
+              });
+  }
+  routingGraph.offsets.push_back(routingGraph.channels.size());
+
+  LLVM_DEBUG(llvm::dbgs() << "\t\tRouting graph: " << nodes.size()
+                          << " end points, " << routingGraph.channels.size()
+                          << " channels\n");
+}
+
+std::vector<size_t>
+Pathfinder::dijkstraShortestPaths(RoutingGraph::NodeID src) const {
+  size_t numNodes = routingGraph.numNodes();
+  std::vector<double> distance(numNodes, INF);
+  std::vector<size_t> preds(numNodes, RoutingGraph::NO_CHANNEL);
+  std::vector<uint64_t> indexInHeap(numNodes);
+  enum Color : uint8_t { WHITE, GRAY, BLACK };
+  std::vector<Color> colors(numNodes, WHITE);
   typedef d_ary_heap_indirect<
-      /*Value=*/PathEndPoint, /*Arity=*/4,
-      /*IndexInHeapPropertyMap=*/std::map<PathEndPoint, uint64_t>,
-      /*DistanceMap=*/std::map<PathEndPoint, double> &,
+      /*Value=*/RoutingGraph::NodeID, /*Arity=*/4,
+      /*IndexInHeapPropertyMap=*/std::vector<uint64_t> &,
+      /*DistanceMap=*/std::vector<double> &,
       /*Compare=*/std::less<>>
       MutableQueue;
   MutableQueue Q(distance, indexInHeap);
@@ -444,66 +787,23 @@ Pathfinder::dijkstraShortestPaths(PathEndPoint src) {
     src = Q.top();
     Q.pop();
 
-    // get all channels src connects to
-    if (channels.count(src) == 0) {
-      auto &sb = graph[std::make_pair(src.coords, src.coords)];
-      for (size_t i = 0; i < sb.srcPorts.size(); i++) {
-        for (size_t j = 0; j < sb.dstPorts.size(); j++) {
-          if (sb.srcPorts[i] == src.port &&
-              sb.connectivity[i][j] == Connectivity::AVAILABLE) {
-            // connections within the same switchbox
-            channels[src].push_back(PathEndPoint{src.coords, sb.dstPorts[j]});
-          }
-        }
-      }
-      // connections to neighboring switchboxes
-      std::vector<std::pair<TileID, Port>> neighbors = {
-          {{src.coords.col, src.coords.row - 1},
-           {WireBundle::North, src.port.channel}},
-          {{src.coords.col - 1, src.coords.row},
-           {WireBundle::East, src.port.channel}},
-          {{src.coords.col, src.coords.row + 1},
-           {WireBundle::South, src.port.channel}},
-          {{src.coords.col + 1, src.coords.row},
-           {WireBundle::West, src.port.channel}}};
-
-      for (const auto &[neighborCoords, neighborPort] : neighbors) {
-        if (graph.count(std::make_pair(src.coords, neighborCoords)) > 0 &&
-            src.port.bundle == getConnectingBundle(neighborPort.bundle)) {
-          auto &sb = graph[std::make_pair(src.coords, neighborCoords)];
-          if (std::find(sb.dstPorts.begin(), sb.dstPorts.end(), neighborPort) !=
-              sb.dstPorts.end())
-            channels[src].push_back({neighborCoords, neighborPort});
-        }
-      }
-      std::sort(channels[src].begin(), channels[src].end());
-    }
-
-    for (auto &dest : channels[src]) {
-      if (distance.count(dest) == 0)
-        distance[dest] = INF;
-      auto &sb = graph[std::make_pair(src.coords, dest.coords)];
-      size_t i = std::distance(
-          sb.srcPorts.begin(),
-          std::find(sb.srcPorts.begin(), sb.srcPorts.end(), src.port));
-      size_t j = std::distance(
-          sb.dstPorts.begin(),
-          std::find(sb.dstPorts.begin(), sb.dstPorts.end(), dest.port));
-      assert(i < sb.srcPorts.size());
-      assert(j < sb.dstPorts.size());
-      bool relax = distance[src] + sb.demand[i][j] < distance[dest];
-      if (colors.count(dest) == 0) {
-        // was WHITE
+    size_t channelIndex = routingGraph.offsets[src];
+    for (const auto &channel : routingGraph.outgoing(src)) {
+      RoutingGraph::NodeID dest = channel.dst;
+      double demand = channel.sb->demand[channel.i][channel.j];
+      bool relax = distance[src] + demand < distance[dest];
+      if (colors[dest] == WHITE) {
         if (relax) {
-          distance[dest] = distance[src] + sb.demand[i][j];
-          preds[dest] = src;
+          distance[dest] = distance[src] + demand;
+          preds[dest] = channelIndex;
           colors[dest] = GRAY;
         }
         Q.push(dest);
       } else if (colors[dest] == GRAY && relax) {
-        distance[dest] = distance[src] + sb.demand[i][j];
-        preds[dest] = src;
+        distance[dest] = distance[src] + demand;
+        preds[dest] = channelIndex;
       }
+      channelIndex++;
     }
     colors[src] = BLACK;
   }
@@ -511,6 +811,335 @@ Pathfinder::dijkstraShortestPaths(PathEndPoint src) {
   return preds;
 }
 
+// Double a search margin, up to one that covers the whole array from any tile.
+int Pathfinder::widenSearchMargin(int searchMargin) const {
+  return std::clamp(2 * searchMargin, 1,
+                    std::max(maxCoords.col, maxCoords.row) + 1);
+}
+
+// Returns the predecessor channels of an A* search from src to dst. Only
+// tiles within searchMargin of the bounding box of src and dst are explored;
+// the margin is doubled until dst is reached or the box covers the array.
+// Every channel costs at least DEMAND_BASE * DEMAND_BASE and a hop between
+// switchboxes changes the Manhattan distance by at most one, so the Manhattan
+// distance to dst is an admissible and consistent heuristic.
+std::vector<size_t> Pathfinder::aStarShortestPath(RoutingGraph::NodeID src,
+                                                  RoutingGraph::NodeID dst,
+                                                  int &searchMargin) const {
+  size_t numNodes = routingGraph.numNodes();
+  const TileID &srcCoords = routingGraph.nodes[src].coords;
+  const TileID &dstCoords = routingGraph.nodes[dst].coords;
+  auto heuristic = [&](RoutingGraph::NodeID n) {
+    const TileID &coords = routingGraph.nodes[n].coords;
+    return DEMAND_BASE * DEMAND_BASE *
+           (std::abs(coords.col - dstCoords.col) +
+            std::abs(coords.row - dstCoords.row));
+  };
+
+  for (;;) {
+    int minCol = std::min(srcCoords.col, dstCoords.col) - searchMargin;
+    int maxCol = std::max(srcCoords.col, dstCoords.col) + searchMargin;
+    int minRow = std::min(srcCoords.row, dstCoords.row) - searchMargin;
+    int maxRow = std::max(srcCoords.row, dstCoords.row) + searchMargin;
+    auto inBox = [&](RoutingGraph::NodeID n) {
+      const TileID &coords = routingGraph.nodes[n].coords;
+      return coords.col >= minCol && coords.col <= maxCol &&
+             coords.row >= minRow && coords.row <= maxRow;
+    };
+
+    std::vector<double> distance(numNodes, INF);
+    // distance plus heuristic, the key of the queue
+    std::vector<double> estimate(numNodes, INF);
+    std::vector<size_t> preds(numNodes, RoutingGraph::NO_CHANNEL);
+    std::vector<uint64_t> indexInHeap(numNodes, static_cast<uint64_t>(-1));
+    llvm::BitVector closed(numNodes);
+    typedef d_ary_heap_indirect<
+        /*Value=*/RoutingGraph::NodeID, /*Arity=*/4,
+        /*IndexInHeapPropertyMap=*/std::vector<uint64_t> &,
+        /*DistanceMap=*/std::vector<double> &,
+        /*Compare=*/std::less<>>
+        MutableQueue;
+    MutableQueue Q(estimate, indexInHeap);
+
+    distance[src] = 0.0;
+    estimate[src] = heuristic(src);
+    Q.push(src);
+    while (!Q.empty()) {
+      RoutingGraph::NodeID n = Q.top();
+      Q.pop();
+      if (n == dst)
+        break;
+      closed.set(n);
+
+      size_t channelIndex = routingGraph.offsets[n];
+      for (const auto &channel : routingGraph.outgoing(n)) {
+        RoutingGraph::NodeID dest = channel.dst;
+        if (!closed.test(dest) && inBox(dest)) {
+          double demand = channel.sb->demand[channel.i][channel.j];
+          if (distance[n] + demand < distance[dest]) {
+            distance[dest] = distance[n] + demand;
+            estimate[dest] = distance[dest] + heuristic(dest);
+            preds[dest] = channelIndex;
+            Q.push_or_update(dest);
+          }
+        }
+        channelIndex++;
+      }
+    }
+
+    if (preds[dst] != RoutingGraph::NO_CHANNEL ||
+        (minCol <= 0 && maxCol >= maxCoords.col && minRow <= 0 &&
+         maxRow >= maxCoords.row))
+      return preds;
+    searchMargin = widenSearchMargin(searchMargin);
+    LLVM_DEBUG(llvm::dbgs() << "\t\tPathfinder: widening search from "
+                            << routingGraph.nodes[src] << " to "
+                            << routingGraph.nodes[dst] << " to margin "
+                            << searchMargin << "\n");
+  }
+}
+
+// Find the channels used by a flow given the current demand. Only reads the
+// routing graph, so flows may be routed concurrently.
+std::optional<Pathfinder::Route>
+Pathfinder::findRoute(const Flow &flow, int &searchMargin) const {
+  const PathEndPoint &src = flow.src;
+  std::optional<RoutingGraph::NodeID> srcNode = routingGraph.lookup(src);
+  if (!srcNode) {
+    LLVM_DEBUG(llvm::dbgs() << "\t\tPathfinder: no such end point " << src
+                            << "\n");
+    return std::nullopt;
+  }
+  // A* searches towards one destination at a time; Dijkstra finds the paths
+  // to all of them at once
+  std::vector<size_t> preds;
+  if (!aStarRouting)
+    preds = dijkstraShortestPaths(*srcNode);
+
+  // trace the path of the flow backwards via predecessors
+  Route route;
+  llvm::BitVector processed(routingGraph.numNodes());
+  processed.set(*srcNode);
+  for (auto endPoint : flow.dsts) {
+    if (endPoint == src)
+      route.push_back(RoutingGraph::NO_CHANNEL);
+    std::optional<RoutingGraph::NodeID> curr = routingGraph.lookup(endPoint);
+    if (!curr) {
+      LLVM_DEBUG(llvm::dbgs() << "\t\tPathfinder: no such end point "
+                              << endPoint << "\n");
+      return std::nullopt;
+    }
+    if (aStarRouting && !processed.test(*curr))
+      preds = aStarShortestPath(*srcNode, *curr, searchMargin);
+    // trace backwards until a vertex already processed is reached
+    while (!processed.test(*curr)) {
+      if (preds[*curr] == RoutingGraph::NO_CHANNEL) {
+        LLVM_DEBUG(llvm::dbgs() << "\t\tPathfinder: " << endPoint
+                                << " is unreachable from " << src << "\n");
+        return std::nullopt;
+      }
+      route.push_back(preds[*curr]);
+      processed.set(*curr);
+      curr = routingGraph.channels[preds[*curr]].src;
+    }
+  }
+  return route;
+}
+
+// Increment used_capacity for the channels of a route and return the switch
+// settings implementing it.
+SwitchSettings Pathfinder::commitRoute(const Flow &flow, const Route &route) {
+  const auto &[packetGroupId, isPriority, src, _] = flow;
+  SwitchSettings switchSettings;
+  for (size_t c : route) {
+    if (c == RoutingGraph::NO_CHANNEL) {
+      // route to self
+      switchSettings[src.coords].srcs.push_back(src.port);
+      switchSettings[src.coords].dsts.push_back(src.port);
+      continue;
+    }
+    const auto &channel = routingGraph.channels[c];
+    auto &sb = *channel.sb;
+    size_t i = channel.i;
+    size_t j = channel.j;
+    sb.isPriority[i][j] = isPriority;
+    if (packetGroupId >= 0 && (sb.packetGroupId[i][j] == -1 ||
+                               sb.packetGroupId[i][j] == packetGroupId)) {
+      for (size_t k = 0; k < sb.srcPorts.size(); k++) {
+        for (size_t l = 0; l < sb.dstPorts.size(); l++) {
+          if (k == i || l == j) {
+            sb.packetGroupId[k][l] = packetGroupId;
+          }
+        }
+      }
+      sb.packetFlowCount[i][j]++;
+      // maximum packet stream sharing per channel
+      if (sb.packetFlowCount[i][j] >= MAX_PACKET_STREAM_CAPACITY) {
+        sb.packetFlowCount[i][j] = 0;
+        sb.usedCapacity[i][j]++;
+      }
+    } else {
+      sb.usedCapacity[i][j]++;
+    }
+    // if at capacity, bump demand to discourage using this Channel
+    // this means the order matters!
+    sb.bumpDemand(i, j);
+    const PathEndPoint &pred = routingGraph.nodes[channel.src];
+    const PathEndPoint &curr = routingGraph.nodes[channel.dst];
+    if (pred.coords == curr.coords) {
+      switchSettings[pred.coords].srcs.push_back(pred.port);
+      switchSettings[curr.coords].dsts.push_back(curr.port);
+    }
+  }
+  return switchSettings;
+}
+
+std::optional<Pathfinder::Route>
+Pathfinder::findPriorRoute(const Flow &flow) const {
+  auto it = priorRoutes.find({flow.src, flow.dsts});
+  if (it == priorRoutes.end())
+    return std::nullopt;
+  Route route;
+  for (const auto &routedChannel : it->second.channels) {
+    if (!routedChannel) {
+      route.push_back(RoutingGraph::NO_CHANNEL);
+      continue;
+    }
+    auto src = routingGraph.lookup(routedChannel->first);
+    auto dst = routingGraph.lookup(routedChannel->second);
+    if (!src || !dst)
+      return std::nullopt;
+    // the channel may since have been taken by a fixed connection
+    auto channel = routingGraph.findChannel(*src, *dst);
+    if (!channel)
+      return std::nullopt;
+    route.push_back(*channel);
+  }
+  return route;
+}
+
+RoutedFlow Pathfinder::toRoutedFlow(const Flow &flow,
+                                    const Route &route) const {
+  RoutedFlow routedFlow{flow.src, flow.dsts, {}};
+  for (size_t c : route) {
+    if (c == RoutingGraph::NO_CHANNEL) {
+      routedFlow.channels.push_back(std::nullopt);
+      continue;
+    }
+    const auto &channel = routingGraph.channels[c];
+    routedFlow.channels.push_back(std::make_pair(
+        routingGraph.nodes[channel.src], routingGraph.nodes[channel.dst]));
+  }
+  return routedFlow;
+}
+
+void Pathfinder::reportRoutes(
+    const std::vector<const Flow *> &flows, const std::vector<Route> &routes,
+    const std::vector<std::optional<Route>> &pinnedRoutes) {
+  // the flows through each channel used, and their packet groups
+  std::map<size_t, RoutingReport::ChannelUsage> usage;
+  std::map<size_t, std::set<int>> packetGroups;
+  for (size_t k = 0; k < flows.size(); k++) {
+    const Flow &flow = *flows[k];
+    bool isPacketFlow = flow.packetGroupId >= 0;
+    RoutingReport::FlowLength length;
+    length.src = flow.src;
+    length.isPacketFlow = isPacketFlow;
+    length.reused = pinnedRoutes[k].has_value();
+    auto isHop = [&](const RoutingGraph::Channel &channel) {
+      return routingGraph.nodes[channel.src].coords !=
+             routingGraph.nodes[channel.dst].coords;
+    };
+    // the route is a tree, so every end point on it but the source has a
+    // single channel leading to it
+    llvm::DenseMap<RoutingGraph::NodeID, size_t> incoming;
+    for (size_t c : routes[k]) {
+      if (c == RoutingGraph::NO_CHANNEL)
+        continue;
+      const auto &channel = routingGraph.channels[c];
+      incoming[channel.dst] = c;
+      if (isHop(channel))
+        length.hops++;
+      auto &channelUsage = usage[c];
+      if (isPacketFlow) {
+        channelUsage.packetFlows++;
+        packetGroups[c].insert(flow.packetGroupId);
+      } else {
+        channelUsage.circuitFlows++;
+      }
+    }
+    for (const auto &dst : flow.dsts) {
+      int hops = 0;
+      auto it = incoming.find(*routingGraph.lookup(dst));
+      while (it != incoming.end()) {
+        const auto &channel = routingGraph.channels[it->second];
+        if (isHop(channel))
+          hops++;
+        it = incoming.find(channel.src);
+      }
+      length.dsts.emplace_back(dst, hops);
+    }
+    report.flows.push_back(std::move(length));
+  }
+
+  std::map<TileID, RoutingReport::SwitchboxUsage> switchboxes;
+  for (const auto &[_, sb] : graph) {
+    auto &sbUsage = switchboxes[sb.srcCoords];
+    sbUsage.coords = sb.srcCoords;
+    bool isLink = sb.srcCoords != sb.dstCoords;
+    if (isLink)
+      sbUsage.numLinks += sb.srcPorts.size();
+    else
+      sbUsage.numPorts += sb.dstPorts.size();
+    for (size_t j = 0; j < sb.dstPorts.size(); j++) {
+      bool used = false;
+      for (size_t i = 0; i < sb.srcPorts.size(); i++) {
+        used |= sb.usedCapacity[i][j] > 0;
+        sbUsage.overCapacity += sb.overCapacity[i][j];
+      }
+      if (used)
+        (isLink ? sbUsage.usedLinks : sbUsage.usedPorts)++;
+    }
+  }
+
+  for (auto &[c, channelUsage] : usage) {
+    const auto &channel = routingGraph.channels[c];
+    const auto &sb = *channel.sb;
+    channelUsage.src = routingGraph.nodes[channel.src];
+    channelUsage.dst = routingGraph.nodes[channel.dst];
+    channelUsage.demand = sb.getBaseDemand(channel.i, channel.j);
+    channelUsage.overCapacity = sb.overCapacity[channel.i][channel.j];
+    channelUsage.packetGroups = packetGroups[c].size();
+    auto &sbUsage = switchboxes[sb.srcCoords];
+    sbUsage.maxPacketSharing =
+        std::max(sbUsage.maxPacketSharing, channelUsage.packetFlows);
+    report.channels.push_back(channelUsage);
+  }
+  for (const auto &[_, sbUsage] : switchboxes)
+    report.switchboxes.push_back(sbUsage);
+}
+
+namespace {
+// A rectangle of tiles, including its bounds; empty if min exceeds max
+struct TileBox {
+  int minCol = std::numeric_limits<int>::max();
+  int maxCol = std::numeric_limits<int>::min();
+  int minRow = std::numeric_limits<int>::max();
+  int maxRow = std::numeric_limits<int>::min();
+
+  void add(TileID coords) {
+    minCol = std::min(minCol, coords.col);
+    maxCol = std::max(maxCol, coords.col);
+    minRow = std::min(minRow, coords.row);
+    maxRow = std::max(maxRow, coords.row);
+  }
+  bool overlaps(const TileBox &other) const {
+    return std::max(minCol, other.minCol) <= std::min(maxCol, other.maxCol) &&
+           std::max(minRow, other.minRow) <= std::min(maxRow, other.maxRow);
+  }
+};
+} // namespace
+
 // Perform congestion-aware routing for all flows which have been added.
 // Use Dijkstra's shortest path to find routes, and use "demand" as the
 // weights. If the routing finds too much congestion, update the demand
@@ -521,6 +1150,7 @@ std::optional<std::map<PathEndPoint, SwitchSettings>>
 Pathfinder::findPaths(const int maxIterations) {
   LLVM_DEBUG(llvm::dbgs() << "\t---Begin Pathfinder::findPaths---\n");
   std::map<PathEndPoint, SwitchSettings> routingSolution;
+  report = RoutingReport();
   // initialize all Channel histories to 0
   for (auto &[_, sb] : graph) {
     for (size_t i = 0; i < sb.srcPorts.size(); i++) {
@@ -532,6 +1162,8 @@ Pathfinder::findPaths(const int maxIterations) {
     }
   }
 
+  buildRoutingGraph();
+
   // group flows based on packetGroupId
   llvm::MapVector<int, std::vector<Flow>> groupedFlows;
   for (auto &f : flows) {
@@ -540,12 +1172,31 @@ Pathfinder::findPaths(const int maxIterations) {
     }
     groupedFlows[f.packetGroupId].push_back(f);
   }
+  std::vector<const Flow *> orderedFlows;
+  for (const auto &[_, flows] : groupedFlows)
+    for (const auto &flow : flows)
+      orderedFlows.push_back(&flow);
+
+  // Flows unchanged since the prior solution start out pinned to their prior
+  // route. A pinned route is ripped up once it shares an over capacity
+  // channel, and its flow is rerouted like any other from then on.
+  std::vector<std::optional<Route>> pinnedRoutes(orderedFlows.size());
+  std::vector<Route> committedRoutes(orderedFlows.size());
+  // A* search margin of each flow, widened when its route is congested
+  std::vector<int> searchMargins(orderedFlows.size(), ASTAR_INITIAL_MARGIN);
+  if (!priorRoutes.empty()) {
+    for (size_t k = 0; k < orderedFlows.size(); k++)
+      pinnedRoutes[k] = findPriorRoute(*orderedFlows[k]);
+    LLVM_DEBUG(llvm::dbgs()
+               << "\t\tPathfinder: reusing "
+               << llvm::count_if(pinnedRoutes,
+                                 [](const auto &r) { return r.has_value(); })
+               << " of " << orderedFlows.size() << " prior routes\n");
+  }
 
   int iterationCount = -1;
   int illegalEdges = 0;
-#ifndef NDEBUG
   int totalPathLength = 0;
-#endif
   do {
     // if reach maxIterations, throw an error since no routing can be found
     if (++iterationCount >= maxIterations) {
@@ -565,9 +1216,7 @@ Pathfinder::findPaths(const int maxIterations) {
 
     // "rip up" all routes
     illegalEdges = 0;
-#ifndef NDEBUG
     totalPathLength = 0;
-#endif
     routingSolution.clear();
     for (auto &[_, sb] : graph) {
       for (size_t i = 0; i < sb.srcPorts.size(); i++) {
@@ -582,72 +1231,96 @@ Pathfinder::findPaths(const int maxIterations) {
     // for each flow, find the shortest path from source to destination
     // update used_capacity for the path between them
 
+    // The tiles whose demand a search for the route of flow k may read: the
+    // A* search stays within its margin around the end points, Dijkstra's
+    // explores the whole array.
+    auto getSearchBox = [&](size_t k) {
+      TileBox box;
+      if (!aStarRouting) {
+        box.add({0, 0});
+        box.add(maxCoords);
+        return box;
+      }
+      box.add(orderedFlows[k]->src.coords);
+      for (const auto &dst : orderedFlows[k]->dsts)
+        box.add(dst.coords);
+      box.minCol -= searchMargins[k];
+      box.maxCol += searchMargins[k];
+      box.minRow -= searchMargins[k];
+      box.maxRow += searchMargins[k];
+      return box;
+    };
+    // The tiles whose demand committing a route changes
+    auto getRouteBox = [&](const Route &route) {
+      TileBox box;
+      for (size_t c : route)
+        if (c != RoutingGraph::NO_CHANNEL)
+          box.add(routingGraph.nodes[routingGraph.channels[c].dst].coords);
+      return box;
+    };
+    auto getBatchBox = [&](size_t k) {
+      return pinnedRoutes[k] ? getRouteBox(*pinnedRoutes[k]) : getSearchBox(k);
+    };
+
+    // In parallel mode, consecutive flows of a packet group whose boxes are
+    // pairwise disjoint form a batch and are routed concurrently, against
+    // the demand left by the flows before the batch. No flow of a batch can
+    // then read demand that another one changes, unless its search had to
+    // widen; such a flow is routed again once the flows before it are
+    // committed. Routes are committed in flow order, so the result is the
+    // same as routing serially.
+    size_t flowIndex = 0;
     for (const auto &[_, flows] : groupedFlows) {
-      for (const auto &[packetGroupId, isPriority, src, dsts] : flows) {
-        // Use dijkstra to find path given current demand from the start
-        // switchbox; find the shortest paths to each other switchbox. Output is
-        // in the predecessor map, which must then be processed to get
-        // individual switchbox settings
-        std::set<PathEndPoint> processed;
-        std::map<PathEndPoint, PathEndPoint> preds = dijkstraShortestPaths(src);
-
-        // trace the path of the flow backwards via predecessors
-        // increment used_capacity for the associated channels
-        SwitchSettings switchSettings;
-        processed.insert(src);
-        for (auto endPoint : dsts) {
-          if (endPoint == src) {
-            // route to self
-            switchSettings[src.coords].srcs.push_back(src.port);
-            switchSettings[src.coords].dsts.push_back(src.port);
+      size_t groupEnd = flowIndex + flows.size();
+      while (flowIndex < groupEnd) {
+        size_t batchBegin = flowIndex;
+        size_t batchEnd = batchBegin + 1;
+        if (parallelContext) {
+          std::vector<TileBox> batchBoxes = {getBatchBox(batchBegin)};
+          for (; batchEnd < groupEnd; batchEnd++) {
+            TileBox box = getBatchBox(batchEnd);
+            if (llvm::any_of(batchBoxes, [&](const TileBox &batchBox) {
+                  return batchBox.overlaps(box);
+                }))
+              break;
+            batchBoxes.push_back(box);
           }
-          auto curr = endPoint;
-          // trace backwards until a vertex already processed is reached
-          while (!processed.count(curr)) {
-            auto &sb = graph[std::make_pair(preds[curr].coords, curr.coords)];
-            size_t i =
-                std::distance(sb.srcPorts.begin(),
-                              std::find(sb.srcPorts.begin(), sb.srcPorts.end(),
-                                        preds[curr].port));
-            size_t j = std::distance(
-                sb.dstPorts.begin(),
-                std::find(sb.dstPorts.begin(), sb.dstPorts.end(), curr.port));
-            assert(i < sb.srcPorts.size());
-            assert(j < sb.dstPorts.size());
-            sb.isPriority[i][j] = isPriority;
-            if (packetGroupId >= 0 &&
-                (sb.packetGroupId[i][j] == -1 ||
-                 sb.packetGroupId[i][j] == packetGroupId)) {
-              for (size_t k = 0; k < sb.srcPorts.size(); k++) {
-                for (size_t l = 0; l < sb.dstPorts.size(); l++) {
-                  if (k == i || l == j) {
-                    sb.packetGroupId[k][l] = packetGroupId;
-                  }
-                }
-              }
-              sb.packetFlowCount[i][j]++;
-              // maximum packet stream sharing per channel
-              if (sb.packetFlowCount[i][j] >= MAX_PACKET_STREAM_CAPACITY) {
-                sb.packetFlowCount[i][j] = 0;
-                sb.usedCapacity[i][j]++;
-              }
-            } else {
-              sb.usedCapacity[i][j]++;
-            }
-            // if at capacity, bump demand to discourage using this Channel
-            // this means the order matters!
-            sb.bumpDemand(i, j);
-            if (preds[curr].coords == curr.coords) {
-              switchSettings[preds[curr].coords].srcs.push_back(
-                  preds[curr].port);
-              switchSettings[curr.coords].dsts.push_back(curr.port);
-            }
-            processed.insert(curr);
-            curr = preds[curr];
+        }
+        std::vector<int> batchMargins(searchMargins.begin() + batchBegin,
+                                      searchMargins.begin() + batchEnd);
+        std::vector<std::optional<Route>> routes(batchEnd - batchBegin);
+        if (routes.size() > 1) {
+          parallelFor(parallelContext, batchBegin, batchEnd, [&](size_t k) {
+            if (!pinnedRoutes[k])
+              routes[k - batchBegin] =
+                  findRoute(*orderedFlows[k], searchMargins[k]);
+          });
+        }
+
+        std::vector<TileBox> committedBoxes;
+        for (; flowIndex < batchEnd; flowIndex++) {
+          const Flow &flow = *orderedFlows[flowIndex];
+          // Use dijkstra to find path given current demand from the start
+          // switchbox, then trace it back from each destination to get
+          // individual switchbox settings
+          std::optional<Route> &route = routes[flowIndex - batchBegin];
+          if (pinnedRoutes[flowIndex]) {
+            route = pinnedRoutes[flowIndex];
+          } else if (!route ||
+                     llvm::any_of(committedBoxes, [&](const TileBox &box) {
+                       return box.overlaps(getSearchBox(flowIndex));
+                     })) {
+            // route it again from the margin a serial search starts with
+            searchMargins[flowIndex] = batchMargins[flowIndex - batchBegin];
+            route = findRoute(flow, searchMargins[flowIndex]);
           }
+          if (!route)
+            return std::nullopt;
+          // add this flow to the proposed solution
+          routingSolution[flow.src] = commitRoute(flow, *route);
+          committedBoxes.push_back(getRouteBox(*route));
+          committedRoutes[flowIndex] = std::move(*route);
         }
-        // add this flow to the proposed solution
-        routingSolution[src] = switchSettings;
       }
       for (auto &[_, sb] : graph) {
         for (size_t i = 0; i < sb.srcPorts.size(); i++) {
@@ -663,6 +1336,7 @@ Pathfinder::findPaths(const int maxIterations) {
       }
     }
 
+    RoutingReport::Iteration iteration;
     for (auto &[_, sb] : graph) {
       for (size_t i = 0; i < sb.srcPorts.size(); i++) {
         for (size_t j = 0; j < sb.dstPorts.size(); j++) {
@@ -680,15 +1354,44 @@ Pathfinder::findPaths(const int maxIterations) {
                 << sb.usedCapacity[i][j] << ", demand = " << sb.demand[i][j]
                 << ", over_capacity_count = " << sb.overCapacity[i][j] << "\n");
           }
-#ifndef NDEBUG
+          iteration.overCapacityHistory += sb.overCapacity[i][j];
           // calculate total path length (across switchboxes)
           if (sb.srcCoords != sb.dstCoords) {
             totalPathLength += sb.usedCapacity[i][j];
           }
-#endif
         }
       }
     }
+    iteration.overCapacityChannels = illegalEdges;
+    iteration.pathLength = totalPathLength;
+    for (const Route &route : committedRoutes) {
+      for (size_t c : route) {
+        if (c == RoutingGraph::NO_CHANNEL)
+          continue;
+        const auto &channel = routingGraph.channels[c];
+        iteration.maxDemand =
+            std::max(iteration.maxDemand,
+                     channel.sb->getBaseDemand(channel.i, channel.j));
+      }
+    }
+    report.iterations.push_back(iteration);
+
+    // rip up pinned routes that use an over capacity channel, and let the
+    // A* search of congested flows explore further afield
+    if (illegalEdges > 0) {
+      for (size_t k = 0; k < orderedFlows.size(); k++) {
+        if (llvm::none_of(committedRoutes[k], [&](size_t c) {
+              if (c == RoutingGraph::NO_CHANNEL)
+                return false;
+              const auto &channel = routingGraph.channels[c];
+              return channel.sb->usedCapacity[channel.i][channel.j] >
+                     MAX_CIRCUIT_STREAM_CAPACITY;
+            }))
+          continue;
+        pinnedRoutes[k].reset();
+        searchMargins[k] = widenSearchMargin(searchMargins[k]);
+      }
+    }
 
 #ifndef NDEBUG
     for (const auto &[PathEndPoint, switchSetting] : routingSolution) {
@@ -705,6 +1408,11 @@ Pathfinder::findPaths(const int maxIterations) {
   } while (illegalEdges >
            0); // continue iterations until a legal routing is found
 
+  routedFlows.clear();
+  for (size_t k = 0; k < orderedFlows.size(); k++)
+    routedFlows.push_back(toRoutedFlow(*orderedFlows[k], committedRoutes[k]));
+  reportRoutes(orderedFlows, committedRoutes, pinnedRoutes);
+
   LLVM_DEBUG(llvm::dbgs() << "\t---End Pathfinder::findPaths---\n");
   return routingSolution;
 }
@@ -0,0 +1,192 @@
+//===- AIEPlaceTiles.cpp ----------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+#include "aie/Dialect/AIE/Transforms/AIEPlacer.h"
+
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/ADT/DenseSet.h"
+
+#include <set>
+
+#define DEBUG_TYPE "aie-place-tiles"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+namespace {
+
+PlacementTileKind getKind(TileOp tile) {
+  if (tile.isMemTile())
+    return PlacementTileKind::Mem;
+  if (tile.isShimNOCTile())
+    return PlacementTileKind::ShimNOC;
+  if (tile.isShimPLTile())
+    return PlacementTileKind::ShimPL;
+  return PlacementTileKind::Core;
+}
+
+// A tile can be moved if it is only used by ops that do not depend on where
+// it is. Tiles with DMA programs, switchboxes, cascades or packet flows stay
+// in place, as do those sharing memory with another tile (see
+// pinSharedMemoryTiles).
+bool isMovable(TileOp tile) {
+  if (tile->use_empty())
+    return false;
+  return llvm::all_of(tile->getUsers(), [](Operation *user) {
+    return isa<CoreOp, BufferOp, LockOp, ObjectFifoCreateOp, FlowOp>(user);
+  });
+}
+
+// Tiles whose buffers or locks are used in the core or DMAs of another tile
+// must remain neighbours of that tile, so neither of them moves.
+template <typename OpTy>
+void pinSharedMemoryTiles(DeviceOp device, std::set<TileID> &fixedTiles) {
+  for (auto op : device.getOps<OpTy>()) {
+    TileID owner = op.getTileOp().getTileID();
+    for (Operation *user : op->getUsers()) {
+      auto element = user->template getParentOfType<TileElement>();
+      if (!element || element.getTileID() == owner)
+        continue;
+      fixedTiles.insert(owner);
+      fixedTiles.insert(element.getTileID());
+    }
+  }
+}
+
+uint64_t getElemBytes(ObjectFifoCreateOp fifo) {
+  auto memref = llvm::cast<MemRefType>(
+      llvm::cast<AIEObjectFifoType>(fifo.getElemType()).getElementType());
+  return memref.getNumElements() * memref.getElementTypeBitWidth() / 8;
+}
+
+struct AIEPlaceTilesPass : AIEPlaceTilesBase<AIEPlaceTilesPass> {
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+    const auto &targetModel = device.getTargetModel();
+
+    std::set<TileID> fixedTiles;
+    for (const std::string &tile : clFixedTiles) {
+      auto [col, row] = StringRef(tile).split(':');
+      TileID id;
+      if (col.getAsInteger(10, id.col) || row.getAsInteger(10, id.row)) {
+        device.emitError("expected a tile as <col>:<row> in fixed-tiles, got ")
+            << tile;
+        return signalPassFailure();
+      }
+      fixedTiles.insert(id);
+    }
+    pinSharedMemoryTiles<BufferOp>(device, fixedTiles);
+    pinSharedMemoryTiles<LockOp>(device, fixedTiles);
+
+    SmallVector<TileOp> tiles;
+    SmallVector<PlacementNode> nodes;
+    DenseMap<Value, unsigned> nodeIds;
+    for (TileOp tile : device.getOps<TileOp>()) {
+      PlacementNode node{getKind(tile), tile.getTileID()};
+      node.fixed = fixedTiles.count(node.tile) || !isMovable(tile);
+      for (Operation *user : tile->getUsers()) {
+        if (auto core = dyn_cast<CoreOp>(user))
+          node.memory += core.getStackSize();
+        else if (auto buffer = dyn_cast<BufferOp>(user))
+          node.memory += buffer.getAllocationSize();
+      }
+      nodeIds[tile.getResult()] = nodes.size();
+      tiles.push_back(tile);
+      nodes.push_back(node);
+    }
+
+    // The link tile of a distribute reuses the buffers of the input
+    // objectFifo for its outputs; that of other links reuses the buffers of
+    // the output objectFifo for its inputs.
+    DenseSet<ObjectFifoCreateOp> linkedFifos, reusedByProducer,
+        reusedByConsumer;
+    for (auto link : device.getOps<ObjectFifoLinkOp>()) {
+      auto ins = link.getInputObjectFifos();
+      auto outs = link.getOutputObjectFifos();
+      linkedFifos.insert(ins.begin(), ins.end());
+      linkedFifos.insert(outs.begin(), outs.end());
+      if (link.isDistribute())
+        reusedByProducer.insert(outs.begin(), outs.end());
+      else
+        reusedByConsumer.insert(ins.begin(), ins.end());
+    }
+
+    SmallVector<PlacementNet> nets;
+    for (auto fifo : device.getOps<ObjectFifoCreateOp>()) {
+      uint64_t bytes = getElemBytes(fifo);
+      PlacementNet net;
+      net.source = {nodeIds.lookup(fifo.getProducerTile()),
+                    reusedByProducer.contains(fifo) ? 0 : fifo.size() * bytes};
+      for (auto [i, consumer] : llvm::enumerate(fifo.getConsumerTiles()))
+        net.dests.push_back(
+            {nodeIds.lookup(consumer),
+             reusedByConsumer.contains(fifo) ? 0 : fifo.size(i + 1) * bytes});
+      // As in the objectFifo lowering, data layout transformations, links
+      // and broadcasts need DMAs.
+      auto noTransform = [](BDDimLayoutArrayAttr dims) { return dims.empty(); };
+      net.mayShareMemory =
+          !fifo.getVia_DMA() && !fifo.getRepeatCount() &&
+          net.dests.size() == 1 && fifo.getDimensionsToStream().empty() &&
+          llvm::all_of(fifo.getDimensionsFromStreamPerConsumer(),
+                       noTransform) &&
+          !linkedFifos.contains(fifo);
+      nets.push_back(net);
+    }
+    for (auto flow : device.getOps<FlowOp>()) {
+      auto src = nodeIds.find(flow.getSource());
+      auto dst = nodeIds.find(flow.getDest());
+      if (src == nodeIds.end() || dst == nodeIds.end())
+        continue;
+      PlacementNet net;
+      net.source = {src->second, 0, flow.getSourceBundle() == WireBundle::DMA};
+      net.dests.push_back(
+          {dst->second, 0, flow.getDestBundle() == WireBundle::DMA});
+      nets.push_back(net);
+    }
+
+    TilePlacer placer(targetModel, std::move(nodes), std::move(nets));
+    PlacementCost initialCost = placer.evaluate();
+    placer.place(clIterations, clSeed);
+    PlacementCost cost = placer.evaluate();
+    LLVM_DEBUG(llvm::dbgs() << "cost " << initialCost.total() << " -> "
+                            << cost.total() << "\n");
+
+    if (!cost.isLegal()) {
+      device.emitError("no placement found within the resources of the "
+                       "device: ")
+          << cost.channelOverflow << " DMA channels and "
+          << cost.memoryOverflow << " bytes of memory over";
+      return signalPassFailure();
+    }
+    if (cost.congestionOverflow)
+      device.emitWarning("placement may not be routable: ")
+          << cost.congestionOverflow
+          << " streams estimated over the switchbox connections";
+
+    OpBuilder builder(device);
+    for (auto [tile, node] : llvm::zip(tiles, placer.getNodes())) {
+      if (tile.getTileID() == node.tile)
+        continue;
+      tile.setColAttr(builder.getI32IntegerAttr(node.tile.col));
+      tile.setRowAttr(builder.getI32IntegerAttr(node.tile.row));
+      ++numMovedTiles;
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<OperationPass<DeviceOp>> AIE::createAIEPlaceTilesPass() {
+  return std::make_unique<AIEPlaceTilesPass>();
+}
@@ -0,0 +1,348 @@
+//===- AIEPlacer.cpp --------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/Transforms/AIEPlacer.h"
+
+#include "llvm/ADT/STLExtras.h"
+
+#include <cmath>
+#include <map>
+#include <optional>
+#include <random>
+
+using namespace xilinx::AIE;
+
+namespace {
+
+// Weights of the resources used beyond those of the target, relative to the
+// wirelength. DMA channels and memory make a placement illegal; congestion
+// only makes the routing longer or impossible, so it weighs less.
+constexpr double kChannelWeight = 100;
+constexpr double kMemoryWeightPerKiB = 100;
+constexpr double kCongestionWeight = 10;
+
+// Number of random moves sampled to pick the initial temperature, and the
+// ratio of the final temperature to the initial one.
+constexpr unsigned kNumTemperatureSamples = 100;
+constexpr double kFinalTemperatureRatio = 1e-3;
+
+std::optional<PlacementTileKind> getKind(const AIETargetModel &targetModel,
+                                         int col, int row) {
+  if (targetModel.isCoreTile(col, row))
+    return PlacementTileKind::Core;
+  if (targetModel.isMemTile(col, row))
+    return PlacementTileKind::Mem;
+  if (targetModel.isShimNOCTile(col, row))
+    return PlacementTileKind::ShimNOC;
+  if (targetModel.isShimPLTile(col, row))
+    return PlacementTileKind::ShimPL;
+  return std::nullopt;
+}
+
+// Appends to `hops` the switchbox ports a stream from `src` to `dst` is
+// estimated to leave through: along the column of `src` to the row of `dst`,
+// then along that row.
+void addRoute(TileID src, TileID dst,
+              llvm::SmallVectorImpl<std::pair<TileID, WireBundle>> &hops) {
+  TileID at = src;
+  while (at.row != dst.row) {
+    bool north = at.row < dst.row;
+    hops.push_back({at, north ? WireBundle::North : WireBundle::South});
+    at.row += north ? 1 : -1;
+  }
+  while (at.col != dst.col) {
+    bool east = at.col < dst.col;
+    hops.push_back({at, east ? WireBundle::East : WireBundle::West});
+    at.col += east ? 1 : -1;
+  }
+}
+
+uint64_t getOverflow(uint64_t used, uint64_t available) {
+  return used > available ? used - available : 0;
+}
+
+} // namespace
+
+double PlacementCost::total() const {
+  return wirelength + kChannelWeight * channelOverflow +
+         kMemoryWeightPerKiB * std::ceil(memoryOverflow / 1024.0) +
+         kCongestionWeight * congestionOverflow;
+}
+
+TilePlacer::TilePlacer(const AIETargetModel &targetModel,
+                       llvm::SmallVector<PlacementNode> nodes,
+                       llvm::SmallVector<PlacementNet> nets)
+    : targetModel(targetModel), nodes(std::move(nodes)),
+      nets(std::move(nets)), netsOf(this->nodes.size()) {
+  for (auto [i, node] : llvm::enumerate(this->nodes)) {
+    [[maybe_unused]] bool inserted = nodeAt.try_emplace(node.tile, i).second;
+    assert(inserted && "nodes must be placed on distinct tiles");
+  }
+  for (auto [i, net] : llvm::enumerate(this->nets)) {
+    netsOf[net.source.node].push_back(i);
+    for (const PlacementNet::Endpoint &dest : net.dests)
+      netsOf[dest.node].push_back(i);
+  }
+  for (llvm::SmallVector<unsigned> &ids : netsOf)
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
+
+bool TilePlacer::isSharedMemory(const PlacementNet &net) const {
+  if (!net.mayShareMemory || net.dests.size() != 1)
+    return false;
+  const PlacementNode &src = nodes[net.source.node];
+  const PlacementNode &dst = nodes[net.dests[0].node];
+  if (src.kind != PlacementTileKind::Core ||
+      dst.kind != PlacementTileKind::Core)
+    return false;
+  return targetModel.isLegalMemAffinity(src.tile.col, src.tile.row,
+                                        dst.tile.col, dst.tile.row) ||
+         targetModel.isLegalMemAffinity(dst.tile.col, dst.tile.row,
+                                        src.tile.col, src.tile.row);
+}
+
+void TilePlacer::addNodeOverflow(Usage &usage, unsigned i,
+                                 bool remove) const {
+  const PlacementNode &node = nodes[i];
+  int col = node.tile.col, row = node.tile.row;
+  uint64_t channels = 0, memory = 0;
+  switch (node.kind) {
+  case PlacementTileKind::Core:
+  case PlacementTileKind::Mem:
+    channels += getOverflow(usage.mm2s[i],
+                            targetModel.getNumSourceSwitchboxConnections(
+                                col, row, WireBundle::DMA));
+    channels += getOverflow(usage.s2mm[i],
+                            targetModel.getNumDestSwitchboxConnections(
+                                col, row, WireBundle::DMA));
+    memory = getOverflow(usage.memory[i], node.kind == PlacementTileKind::Core
+                                              ? targetModel.getLocalMemorySize()
+                                              : targetModel.getMemTileSize());
+    break;
+  case PlacementTileKind::ShimNOC:
+  case PlacementTileKind::ShimPL:
+    // The buffers of shim tiles are in host memory.
+    channels += getOverflow(usage.mm2s[i],
+                            targetModel.getNumSourceShimMuxConnections(
+                                col, row, WireBundle::DMA));
+    channels += getOverflow(usage.s2mm[i],
+                            targetModel.getNumDestShimMuxConnections(
+                                col, row, WireBundle::DMA));
+    break;
+  }
+  if (remove) {
+    usage.cost.channelOverflow -= channels;
+    usage.cost.memoryOverflow -= memory;
+  } else {
+    usage.cost.channelOverflow += channels;
+    usage.cost.memoryOverflow += memory;
+  }
+}
+
+void TilePlacer::addNet(Usage &usage, unsigned i, bool remove) const {
+  const PlacementNet &net = nets[i];
+  auto update = [&](auto &value, uint64_t amount) {
+    if (remove)
+      value -= amount;
+    else
+      value += amount;
+  };
+
+  // The overflows of the endpoints are taken out while their usage changes.
+  llvm::SmallVector<unsigned> endpoints{net.source.node};
+  for (const PlacementNet::Endpoint &dest : net.dests)
+    endpoints.push_back(dest.node);
+  llvm::sort(endpoints);
+  endpoints.erase(std::unique(endpoints.begin(), endpoints.end()),
+                  endpoints.end());
+  for (unsigned node : endpoints)
+    addNodeOverflow(usage, node, /*remove=*/true);
+
+  update(usage.memory[net.source.node], net.source.memory);
+  if (!isSharedMemory(net)) {
+    if (net.source.usesDMA)
+      update(usage.mm2s[net.source.node], 1);
+
+    TileID src = nodes[net.source.node].tile;
+    int minCol = src.col, maxCol = src.col;
+    int minRow = src.row, maxRow = src.row;
+    // A stream broadcast to several destinations only uses a port once.
+    llvm::SmallVector<std::pair<TileID, WireBundle>> hops;
+    for (const PlacementNet::Endpoint &dest : net.dests) {
+      update(usage.memory[dest.node], dest.memory);
+      if (dest.usesDMA)
+        update(usage.s2mm[dest.node], 1);
+      TileID dst = nodes[dest.node].tile;
+      minCol = std::min(minCol, dst.col);
+      maxCol = std::max(maxCol, dst.col);
+      minRow = std::min(minRow, dst.row);
+      maxRow = std::max(maxRow, dst.row);
+      addRoute(src, dst, hops);
+    }
+    update(usage.cost.wirelength, (maxCol - minCol) + (maxRow - minRow));
+    llvm::sort(hops);
+    hops.erase(std::unique(hops.begin(), hops.end()), hops.end());
+    for (const auto &hop : hops) {
+      unsigned &streams = usage.demand[hop];
+      unsigned available = targetModel.getNumDestSwitchboxConnections(
+          hop.first.col, hop.first.row, hop.second);
+      usage.cost.congestionOverflow -= getOverflow(streams, available);
+      update(streams, 1);
+      usage.cost.congestionOverflow += getOverflow(streams, available);
+    }
+  }
+
+  for (unsigned node : endpoints)
+    addNodeOverflow(usage, node, /*remove=*/false);
+}
+
+TilePlacer::Usage TilePlacer::computeUsage() const {
+  Usage usage;
+  usage.mm2s.resize(nodes.size());
+  usage.s2mm.resize(nodes.size());
+  for (const PlacementNode &node : nodes)
+    usage.memory.push_back(node.memory);
+  for (unsigned i = 0; i < nodes.size(); i++)
+    addNodeOverflow(usage, i, /*remove=*/false);
+  for (unsigned i = 0; i < nets.size(); i++)
+    addNet(usage, i, /*remove=*/false);
+  return usage;
+}
+
+PlacementCost TilePlacer::evaluate() const { return computeUsage().cost; }
+
+void TilePlacer::move(unsigned node, TileID tile) {
+  TileID from = nodes[node].tile;
+  if (auto it = nodeAt.find(tile); it != nodeAt.end()) {
+    unsigned other = it->second;
+    nodes[other].tile = from;
+    nodeAt[from] = other;
+  } else {
+    nodeAt.erase(from);
+  }
+  nodes[node].tile = tile;
+  nodeAt[tile] = node;
+}
+
+void TilePlacer::move(Usage &usage, unsigned node, TileID tile) {
+  llvm::SmallVector<unsigned, 2> moved{node};
+  if (auto it = nodeAt.find(tile); it != nodeAt.end())
+    moved.push_back(it->second);
+  llvm::SmallVector<unsigned> affected;
+  for (unsigned n : moved)
+    llvm::append_range(affected, netsOf[n]);
+  llvm::sort(affected);
+  affected.erase(std::unique(affected.begin(), affected.end()),
+                 affected.end());
+
+  for (unsigned net : affected)
+    addNet(usage, net, /*remove=*/true);
+  for (unsigned n : moved)
+    addNodeOverflow(usage, n, /*remove=*/true);
+  move(node, tile);
+  for (unsigned n : moved)
+    addNodeOverflow(usage, n, /*remove=*/false);
+  for (unsigned net : affected)
+    addNet(usage, net, /*remove=*/false);
+}
+
+void TilePlacer::place(unsigned iterations, unsigned seed) {
+  // The results of the distributions of <random> vary between standard
+  // libraries, so the generator is only used directly.
+  std::mt19937 rng(seed);
+  auto random = [&](size_t n) { return rng() % n; };
+  auto uniform = [&]() { return rng() / 4294967296.0; };
+
+  std::map<PlacementTileKind, llvm::SmallVector<TileID>> sites;
+  for (int col = 0; col < targetModel.columns(); col++)
+    for (int row = 0; row < targetModel.rows(); row++)
+      if (auto kind = getKind(targetModel, col, row))
+        sites[*kind].push_back({col, row});
+
+  llvm::SmallVector<unsigned> movable;
+  for (auto [i, node] : llvm::enumerate(nodes))
+    if (!node.fixed && sites[node.kind].size() > 1)
+      movable.push_back(i);
+  if (movable.empty() || iterations == 0)
+    return;
+
+  // Only the nets of the moved nodes are re-evaluated after each move.
+  Usage usage = computeUsage();
+
+  // Move a random node to a random tile of its kind, swapping it with the
+  // node there unless that one is fixed. Returns the node and the tile it
+  // was moved from, so that the move can be undone.
+  auto randomMove = [&]() -> std::optional<std::pair<unsigned, TileID>> {
+    unsigned node = movable[random(movable.size())];
+    llvm::ArrayRef<TileID> candidates = sites[nodes[node].kind];
+    TileID tile = candidates[random(candidates.size())];
+    TileID from = nodes[node].tile;
+    if (tile == from)
+      return std::nullopt;
+    if (auto it = nodeAt.find(tile);
+        it != nodeAt.end() && nodes[it->second].fixed)
+      return std::nullopt;
+    move(usage, node, tile);
+    return std::make_pair(node, from);
+  };
+
+  double cost = usage.cost.total();
+
+  // Start at the mean cost increase of a random move, so that most moves are
+  // accepted at first.
+  double uphill = 0;
+  unsigned numUphill = 0;
+  for (unsigned i = 0; i < kNumTemperatureSamples; i++) {
+    auto undo = randomMove();
+    if (!undo)
+      continue;
+    if (double delta = usage.cost.total() - cost; delta > 0) {
+      uphill += delta;
+      ++numUphill;
+    }
+    move(usage, undo->first, undo->second);
+  }
+  double initialTemperature = numUphill ? uphill / numUphill : 1.0;
+
+  llvm::SmallVector<TileID> best;
+  auto saveBest = [&]() {
+    best.clear();
+    for (const PlacementNode &node : nodes)
+      best.push_back(node.tile);
+  };
+  saveBest();
+  double bestCost = cost;
+
+  for (unsigned i = 0; i < iterations; i++) {
+    double temperature =
+        initialTemperature *
+        std::pow(kFinalTemperatureRatio, static_cast<double>(i) / iterations);
+    auto undo = randomMove();
+    if (!undo)
+      continue;
+    double newCost = usage.cost.total();
+    double delta = newCost - cost;
+    if (delta > 0 && uniform() >= std::exp(-delta / temperature)) {
+      move(usage, undo->first, undo->second);
+      continue;
+    }
+    cost = newCost;
+    if (cost < bestCost) {
+      bestCost = cost;
+      saveBest();
+    }
+  }
+
+  nodeAt.clear();
+  for (auto [i, node] : llvm::enumerate(nodes)) {
+    node.tile = best[i];
+    nodeAt[node.tile] = i;
+  }
+}
@@ -0,0 +1,150 @@
+//===- AIESplitCoreModules.cpp ----------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+//
+// Lower the code of every core of a design into a module of its own, in a
+// single run. A core module holds what aie-standard-lowering{tilecol tilerow}
+// followed by aiex-standard-lowering produce from the whole design, further
+// lowered by the core pipeline, and is written to
+// <output-dir>/core_<col>_<row>.mlir. The design itself is left unchanged.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Pass/PassManager.h"
+#include "mlir/Pass/PassRegistry.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+#define DEBUG_TYPE "aie-split-core-modules"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+namespace {
+
+std::string getCoreLoweringPipeline(int col, int row) {
+  return "aie-standard-lowering{tilecol=" + std::to_string(col) +
+         " tilerow=" + std::to_string(row) + "},aiex-standard-lowering";
+}
+
+// Returns true if the lowering of `core` needs a copy of `op`. The other
+// cores and the ops with regions configuring the DMAs and the switchboxes are
+// dropped by the lowering, so they are not copied in the first place, nor are
+// the ops using them.
+bool isNeededByCore(Operation *op, CoreOp core, const IRMapping &mapper) {
+  if (!llvm::all_of(op->getOperands(),
+                    [&](Value v) { return mapper.contains(v); }))
+    return false;
+  if (auto otherCore = dyn_cast<CoreOp>(op))
+    return otherCore == core;
+  return op->getNumRegions() == 0 || isa<func::FuncOp>(op);
+}
+
+struct AIESplitCoreModulesPass
+    : AIESplitCoreModulesBase<AIESplitCoreModulesPass> {
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    AIESplitCoreModulesBase::getDependentDialects(registry);
+    OpPassManager pm(ModuleOp::getOperationName());
+    if (succeeded(parsePassPipeline(getCoreLoweringPipeline(0, 0), pm)))
+      pm.getDependentDialects(registry);
+    if (!clCorePipeline.empty())
+      if (auto corePm = parsePassPipeline(clCorePipeline); succeeded(corePm))
+        corePm->getDependentDialects(registry);
+  }
+
+  void runOnOperation() override {
+    ModuleOp m = getOperation();
+    if (m.getOps<DeviceOp>().empty()) {
+      m.emitOpError("expected AIE.device operation at toplevel");
+      return signalPassFailure();
+    }
+    DeviceOp device = *m.getOps<DeviceOp>().begin();
+
+    std::optional<OpPassManager> corePm;
+    if (!clCorePipeline.empty()) {
+      auto parsed = parsePassPipeline(clCorePipeline);
+      if (failed(parsed)) {
+        m.emitError("invalid core pipeline: ") << clCorePipeline;
+        return signalPassFailure();
+      }
+      corePm = std::move(*parsed);
+    }
+
+    if (std::error_code ec = llvm::sys::fs::create_directories(clOutputDir)) {
+      m.emitError("unable to create ") << clOutputDir << ": " << ec.message();
+      return signalPassFailure();
+    }
+
+    SmallVector<Operation *> topLevelOps;
+    for (Operation &op : m.getBody()->getOperations())
+      if (!isa<DeviceOp>(op))
+        topLevelOps.push_back(&op);
+
+    SmallVector<CoreOp> cores(device.getOps<CoreOp>());
+    OpBuilder builder = OpBuilder::atBlockEnd(m.getBody());
+    for (CoreOp core : cores) {
+      int col = core.colIndex();
+      int row = core.rowIndex();
+
+      // Copy the part of the design the core needs into a module nested in
+      // this one, so that it can be lowered as the design would be.
+      auto coreModule = builder.create<ModuleOp>(m.getLoc());
+      coreModule->setDiscardableAttrs(m->getDiscardableAttrDictionary());
+      OpBuilder coreBuilder = OpBuilder::atBlockEnd(coreModule.getBody());
+      IRMapping mapper;
+      for (Operation *op : topLevelOps)
+        coreBuilder.clone(*op, mapper);
+      Operation *coreDevice =
+          coreBuilder.insert(device->cloneWithoutRegions(mapper));
+      Block *body = new Block();
+      coreDevice->getRegion(0).push_back(body);
+      coreBuilder.setInsertionPointToEnd(body);
+      for (Operation &op : device.getBody()->getOperations())
+        if (isNeededByCore(&op, core, mapper))
+          coreBuilder.clone(op, mapper);
+
+      OpPassManager pm(ModuleOp::getOperationName());
+      if (failed(parsePassPipeline(getCoreLoweringPipeline(col, row), pm)) ||
+          failed(runPipeline(pm, coreModule)) ||
+          (corePm && failed(runPipeline(*corePm, coreModule)))) {
+        coreModule.erase();
+        return signalPassFailure();
+      }
+
+      SmallString<128> path(clOutputDir);
+      llvm::sys::path::append(path, "core_" + std::to_string(col) + "_" +
+                                        std::to_string(row) + ".mlir");
+      std::error_code ec;
+      llvm::raw_fd_ostream os(path, ec);
+      if (ec) {
+        coreModule.erase();
+        m.emitError("unable to write ") << path << ": " << ec.message();
+        return signalPassFailure();
+      }
+      coreModule.print(os);
+      coreModule.erase();
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<OperationPass<ModuleOp>>
+AIE::createAIESplitCoreModulesPass() {
+  return std::make_unique<AIESplitCoreModulesPass>();
+}
@@ -144,6 +144,26 @@ void AIEX::getHardwareStridesWraps(const AIE::AIETargetModel &targetModel,
   }
 }
 
+mlir::LogicalResult
+AIEX::getStridesWrapsFieldWidths(const AIE::AIETargetModel &targetModel,
+                                 int tileCol, int tileRow, uint32_t &wrapBits,
+                                 uint32_t &stepBits, uint32_t &iterBits) {
+  iterBits = 6;
+  if (targetModel.isShimNOCTile(tileCol, tileRow)) {
+    stepBits = 20; // XAIEMLGBL_NOC_MODULE_DMA_BD0_3_D0_STEPSIZE_WIDTH
+    wrapBits = 10; // XAIEMLGBL_NOC_MODULE_DMA_BD0_3_D0_WRAP_WIDTH
+  } else if (targetModel.isMemTile(tileCol, tileRow)) {
+    stepBits = 17; // XAIEMLGBL_MEM_TILE_MODULE_DMA_BD0_2_D0_STEPSIZE_WIDTH
+    wrapBits = 10; // XAIEMLGBL_MEM_TILE_MODULE_DMA_BD0_2_D0_WRAP_WIDTH
+  } else if (targetModel.isCoreTile(tileCol, tileRow)) {
+    stepBits = 13; // XAIEMLGBL_MEMORY_MODULE_DMA_BD0_2_D0_STEPSIZE_WIDTH
+    wrapBits = 8;  // XAIEMLGBL_MEMORY_MODULE_DMA_BD0_3_D0_WRAP_WIDTH
+  } else {
+    return mlir::failure();
+  }
+  return mlir::success();
+}
+
 mlir::LogicalResult
 AIEX::verifyStridesWraps(mlir::Operation *forOp,
                          mlir::MemRefType referencedBufType, int tileCol,
@@ -151,24 +171,16 @@ AIEX::verifyStridesWraps(mlir::Operation *forOp,
                          llvm::SmallVector<int64_t, 4> inputStrides,
                          llvm::SmallVector<int64_t, 4> hardwareSizes,
                          llvm::SmallVector<int64_t, 4> hardwareStrides,
-                         bool skipTransformationChecks) {
+                         bool skipTransformationChecks, bool skipRangeChecks) {
   const auto &targetModel = AIE::getTargetModel(forOp);
   auto addressGranularity = targetModel.getAddressGenGranularity();
   auto elemWidth = referencedBufType.getElementTypeBitWidth();
 
   uint32_t wrap_bits = 0;
   uint32_t step_bits = 0;
-  uint32_t iter_bits = 6;
-  if (targetModel.isShimNOCTile(tileCol, tileRow)) {
-    step_bits = 20; // XAIEMLGBL_NOC_MODULE_DMA_BD0_3_D0_STEPSIZE_WIDTH
-    wrap_bits = 10; // XAIEMLGBL_NOC_MODULE_DMA_BD0_3_D0_WRAP_WIDTH
-  } else if (targetModel.isMemTile(tileCol, tileRow)) {
-    step_bits = 17; // XAIEMLGBL_MEM_TILE_MODULE_DMA_BD0_2_D0_STEPSIZE_WIDTH
-    wrap_bits = 10; // XAIEMLGBL_MEM_TILE_MODULE_DMA_BD0_2_D0_WRAP_WIDTH
-  } else if (targetModel.isCoreTile(tileCol, tileRow)) {
-    step_bits = 13; // XAIEMLGBL_MEMORY_MODULE_DMA_BD0_2_D0_STEPSIZE_WIDTH
-    wrap_bits = 8;  // XAIEMLGBL_MEMORY_MODULE_DMA_BD0_3_D0_WRAP_WIDTH
-  } else {
+  uint32_t iter_bits = 0;
+  if (failed(getStridesWrapsFieldWidths(targetModel, tileCol, tileRow,
+                                        wrap_bits, step_bits, iter_bits))) {
     return forOp->emitOpError(
         "Unsupported tile type at (" + std::to_string(tileCol) + ", " +
         std::to_string(tileRow) + ") Must be ShimNOC, Mem or Core.");
@@ -220,6 +232,9 @@ AIEX::verifyStridesWraps(mlir::Operation *forOp,
     }
   }
 
+  if (skipRangeChecks)
+    return success();
+
   if (!skipTransformationChecks && hardwareSizes[0] > (1 << wrap_bits) - 1)
     return forOp->emitOpError(
         "Size 0 exceeds the [0:" + std::to_string((1 << wrap_bits) - 1) +
@@ -385,16 +400,14 @@ LogicalResult AIEX::NpuDmaMemcpyNdOp::verify() {
     return emitOpError("Offset must be 4-byte-aligned.");
   }
 
-  // dma_memcpy_nd transfers of the form [1, 1, 1, len][0, 0, 0, 1] do not
-  // specify any data layout transformation, but simply express a contiguous
-  // transfer of `len`. For backwards compatibility, we allow this to proceed
-  // even if it exceeds the maximum stride/wrap size of any one dimension,
-  // and simply do not lower any data layout transformations, since there is
-  // no other way to express this at the dma_memcpy_nd interface otherwise.
+  // Patterns exceeding the ranges of the BD fields are legal here: they are
+  // split into several BDs by aie-split-access-patterns, and rejected by
+  // aie-dma-to-npu if they are left as they are.
   bool skipTransformationChecks = isLinearTransferWithoutTransformation();
   if (failed(verifyStridesWraps(*this, buffer, getX(), getY(), inputSizes,
                                 inputStrides, hardwareSizes, hardwareStrides,
-                                skipTransformationChecks))) {
+                                skipTransformationChecks,
+                                /*skipRangeChecks=*/true))) {
     return failure();
   }
 
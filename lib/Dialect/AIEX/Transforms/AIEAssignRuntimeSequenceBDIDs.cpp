@@ -66,8 +66,7 @@ struct AIEAssignRuntimeSequenceBDIDsPass
           if (bd_op.getBdId().has_value()) {
             return WalkResult::advance();
           }
-          // FIXME: use correct channelIndex here
-          std::optional<int32_t> next_id = gen.nextBdId(/*channelIndex=*/0);
+          std::optional<int32_t> next_id = gen.nextBdId(op.getChannel());
           if (!next_id) {
             op.emitOpError()
                 << "Allocator exhausted available buffer descriptor IDs.";
@@ -129,24 +128,82 @@ struct AIEAssignRuntimeSequenceBDIDsPass
     return success();
   }
 
+  // Inserts an aiex.dma_free_task after the point where each task of the
+  // sequence is known to have completed for the last time, so that its BD IDs
+  // can be reused by the tasks configured after it.
+  //
+  // A DMA channel runs the tasks started on it in order, so awaiting a task
+  // also completes the tasks started before it on the same channel, even if
+  // they are never awaited themselves. A task that is started again later
+  // keeps its BDs until a completion after its last start. Tasks freed
+  // explicitly by the user are left alone.
+  void insertFrees(RuntimeSequenceOp sequence) {
+    using Channel = std::tuple<Operation *, AIE::DMAChannelDir, uint32_t>;
+    auto getChannel = [](DMAConfigureTaskOp task) -> Channel {
+      return {task.getTileOp(), task.getDirection(), task.getChannel()};
+    };
+
+    Block &body = sequence.getBody().front();
+    DenseMap<DMAConfigureTaskOp, Operation *> lastStart;
+    DenseSet<DMAConfigureTaskOp> freed;
+    for (Operation &op : body) {
+      if (auto start = dyn_cast<DMAStartTaskOp>(op); start && start.getTaskOp())
+        lastStart[start.getTaskOp()] = start;
+      if (auto free = dyn_cast<DMAFreeTaskOp>(op); free && free.getTaskOp())
+        freed.insert(free.getTaskOp());
+    }
+
+    std::map<Channel, SmallVector<DMAConfigureTaskOp>> running;
+    for (Operation &op : llvm::make_early_inc_range(body)) {
+      if (auto start = dyn_cast<DMAStartTaskOp>(op)) {
+        if (DMAConfigureTaskOp task = start.getTaskOp())
+          running[getChannel(task)].push_back(task);
+        continue;
+      }
+      auto await = dyn_cast<DMAAwaitTaskOp>(op);
+      if (!await)
+        continue;
+      OpBuilder builder(await);
+      builder.setInsertionPointAfter(await);
+      DMAConfigureTaskOp task = await.getTaskOp();
+      if (!task) {
+        // Reported by runOnFreeBDs.
+        builder.create<DMAFreeTaskOp>(await.getLoc(), await.getTask());
+        continue;
+      }
+
+      SmallVector<DMAConfigureTaskOp> completed = {task};
+      auto &queue = running[getChannel(task)];
+      auto it = llvm::find(llvm::reverse(queue), task);
+      if (it != queue.rend()) {
+        auto end = it.base();
+        completed.assign(queue.begin(), end);
+        queue.erase(queue.begin(), end);
+      }
+      for (DMAConfigureTaskOp done : completed) {
+        auto startIt = lastStart.find(done);
+        if (freed.contains(done) || llvm::is_contained(queue, done) ||
+            (startIt != lastStart.end() &&
+             await->isBeforeInBlock(startIt->second)))
+          continue;
+        builder.create<DMAFreeTaskOp>(await.getLoc(), done.getResult());
+        freed.insert(done);
+      }
+    }
+  }
+
   void runOnOperation() override {
 
-    // This pass currently assigns BD IDs with a simple linear pass. IDs are
-    // assigned in sequence, and issuing an aiex.free_bds or aiex.await_bds op
-    // kills the correspondings IDs use. If in the future we support
-    // branching/jumping in the sequence function, a proper liveness analysis
-    // will become necessary here.
+    // This pass assigns BD IDs with a simple linear pass. IDs are assigned in
+    // sequence, and issuing an aiex.dma_free_task op kills the corresponding
+    // IDs' use. Those ops are inserted where tasks are known to complete by
+    // insertFrees. If in the future we support branching/jumping in the
+    // sequence function, that analysis will need to follow the control flow.
 
     AIE::DeviceOp device = getOperation();
     std::map<AIE::TileOp, BdIdGenerator> gens;
 
-    // Insert a free_bds operation for each await_bds
-    // After waiting for BD IDs, they can definitely safely be reused
-    device.walk([&](DMAAwaitTaskOp op) {
-      OpBuilder builder(op);
-      builder.setInsertionPointAfter(op);
-      builder.create<DMAFreeTaskOp>(op.getLoc(), op.getTask());
-    });
+    device.walk([&](RuntimeSequenceOp sequence) { insertFrees(sequence); });
 
     // TODO: Only walk the sequence function
     device.walk([&](Operation *op) {
@@ -351,6 +351,19 @@ public:
     llvm::SmallVector<int64_t, 4> strides(4);
     getHardwareStridesWraps(targetModel, bufferType, inputSizes, inputStrides,
                             sizes, strides);
+
+    // dma_memcpy_nd transfers of the form [1, 1, 1, len][0, 0, 0, 1] do not
+    // specify any data layout transformation, but simply express a contiguous
+    // transfer of `len`. For backwards compatibility, we allow this to proceed
+    // even if it exceeds the maximum stride/wrap size of any one dimension,
+    // and simply do not lower any data layout transformations, since there is
+    // no other way to express this at the dma_memcpy_nd interface otherwise.
+    if (targetModel.getTargetArch() != AIE::AIEArch::AIE1 &&
+        failed(verifyStridesWraps(op, bufferType, op.getX(), op.getY(),
+                                  inputSizes, inputStrides, sizes, strides,
+                                  op.isLinearTransferWithoutTransformation())))
+      return failure();
+
     int64_t offset = op.getOffsetInBytes();
 
     // column
@@ -0,0 +1,322 @@
+//===- AIEOptimizeNpuWrites.cpp ---------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+//
+// Shrink the register writes of a runtime sequence. Between two barriers (any
+// op that is not a write to a configuration register, e.g. npu.sync, a core
+// control write or a DMA channel reset), writes that are overwritten before
+// the barrier are dropped, chains of mask writes to one register are folded,
+// and runs of write32s to consecutive addresses are merged into a single
+// npu.blockwrite.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIEX/IR/AIEXDialect.h"
+#include "aie/Dialect/AIEX/Transforms/AIEXPasses.h"
+
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/TypeSwitch.h"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIEX;
+
+namespace {
+
+// Returns the byte address written by `op` with the tile coordinates folded
+// in, or std::nullopt if the address is still symbolic.
+template <typename OpTy>
+std::optional<uint32_t> getFullAddress(const AIE::AIETargetModel &tm,
+                                       OpTy op) {
+  if (op.getBuffer())
+    return std::nullopt;
+  uint32_t address = op.getAddress();
+  if (op.getColumn() && op.getRow())
+    address = ((*op.getColumn() & 0xff) << tm.getColumnShift()) |
+              ((*op.getRow() & 0xff) << tm.getRowShift()) |
+              (address & 0xFFFFF);
+  return address;
+}
+
+// Returns true if `address` is a register that only holds configuration: a
+// BD word, a lock value or a stream switch setting of the AIE2 shim, mem and
+// core tile register maps. Only the last write to such a register before a
+// barrier matters. Any other write may act on the device (a core enable or
+// reset, a DMA channel reset, a task queue push, an event, a lock request)
+// and is a barrier. No register is known to be one on other architectures.
+bool isStorageRegister(const AIE::AIETargetModel &tm, uint32_t address) {
+  if (tm.getTargetArch() == AIE::AIEArch::AIE1)
+    return false;
+  uint32_t rowShift = tm.getRowShift();
+  uint32_t colShift = tm.getColumnShift();
+  int col = address >> colShift;
+  int row = (address >> rowShift) & ((1u << (colShift - rowShift)) - 1);
+  uint32_t offset = address & ((1u << rowShift) - 1);
+  auto inRange = [&](uint32_t first, uint32_t size) {
+    return offset >= first && offset < first + size;
+  };
+  if (tm.isMemTile(col, row))
+    return inRange(0xA0000, 0x600) || inRange(0xB0000, 0x400) ||
+           inRange(0xC0000, 0x400);
+  if (tm.isShimNOCorPLTile(col, row))
+    return inRange(0x1D000, 0x200) || inRange(0x14000, 0x100) ||
+           inRange(0x3F000, 0x400) || inRange(0x1F000, 0x8);
+  return inRange(0x1D000, 0x200) || inRange(0x1F000, 0x100) ||
+         inRange(0x3F000, 0x400);
+}
+
+// Returns the number of words written by a block write, or std::nullopt if
+// its payload is not a static 32-bit memref.
+std::optional<uint32_t> getBlockWriteSize(NpuBlockWriteOp op) {
+  auto type = dyn_cast<MemRefType>(op.getData().getType());
+  if (!type || !type.hasStaticShape() || type.getElementTypeBitWidth() != 32)
+    return std::nullopt;
+  return type.getNumElements();
+}
+
+// A mask write can be folded with its neighbours only if it leaves the bits
+// outside its mask alone, whether or not the value is masked on the device.
+bool isFoldableMaskWrite(NpuMaskWrite32Op op) {
+  return (op.getValue() & ~op.getMask()) == 0;
+}
+
+struct NpuWrite {
+  Operation *op;
+  uint32_t address;
+  // number of words written, 1 unless this is a block write
+  uint32_t size;
+};
+
+class NpuWriteOptimizer {
+public:
+  NpuWriteOptimizer(AIE::DeviceOp device)
+      : device(device), tm(device.getTargetModel()),
+        builder(device.getContext()) {}
+
+  void run(RuntimeSequenceOp seq) {
+    SmallVector<NpuWrite> window;
+    for (Operation &op : llvm::make_early_inc_range(seq.getBody().front())) {
+      // Ops without side effects (e.g. the memref.get_global feeding a block
+      // write) do not separate writes.
+      if (isMemoryEffectFree(&op))
+        continue;
+      if (std::optional<NpuWrite> write = getWrite(&op)) {
+        window.push_back(*write);
+        continue;
+      }
+      optimizeWindow(window);
+      window.clear();
+    }
+    optimizeWindow(window);
+  }
+
+private:
+  // Returns the write performed by `op` if it only writes configuration
+  // registers, which this pass may touch.
+  std::optional<NpuWrite> getWrite(Operation *op) {
+    std::optional<uint32_t> address;
+    uint32_t size = 1;
+    llvm::TypeSwitch<Operation *>(op)
+        .Case<NpuWrite32Op, NpuMaskWrite32Op>(
+            [&](auto writeOp) { address = getFullAddress(tm, writeOp); })
+        .Case<NpuBlockWriteOp>([&](NpuBlockWriteOp writeOp) {
+          if (std::optional<uint32_t> numWords = getBlockWriteSize(writeOp)) {
+            address = getFullAddress(tm, writeOp);
+            size = *numWords;
+          }
+        });
+    if (!address)
+      return std::nullopt;
+    for (uint32_t i = 0; i < size; i++)
+      if (!isStorageRegister(tm, *address + i * sizeof(uint32_t)))
+        return std::nullopt;
+    return NpuWrite{op, *address, size};
+  }
+
+  void optimizeWindow(SmallVector<NpuWrite> &window) {
+    if (window.size() < 2)
+      return;
+    removeDeadWrites(window);
+    coalesceWrites(window);
+  }
+
+  // Drop single-word writes that a later write in the window fully
+  // overwrites, and fold mask writes into the write they modify. The
+  // surviving write always takes the position of the last one, so the final
+  // value of a register is never stored earlier than before. The window only
+  // holds configuration writes, so this reorders no write that acts on the
+  // device.
+  void removeDeadWrites(SmallVector<NpuWrite> &window) {
+    // the window index of the last single-word write of each address
+    DenseMap<uint32_t, size_t> pending;
+    auto kill = [&](size_t idx) {
+      window[idx].op->erase();
+      window[idx].op = nullptr;
+    };
+
+    for (size_t i = 0; i < window.size(); i++) {
+      NpuWrite &write = window[i];
+      if (isa<NpuBlockWriteOp>(write.op)) {
+        for (uint32_t w = 0; w < write.size; w++) {
+          auto it = pending.find(write.address + w * sizeof(uint32_t));
+          if (it == pending.end())
+            continue;
+          kill(it->second);
+          pending.erase(it);
+        }
+        continue;
+      }
+
+      auto it = pending.find(write.address);
+      if (it == pending.end()) {
+        pending[write.address] = i;
+        continue;
+      }
+      size_t prevIdx = it->second;
+      it->second = i;
+
+      if (isa<NpuWrite32Op>(write.op)) {
+        kill(prevIdx);
+        continue;
+      }
+
+      auto maskWrite = cast<NpuMaskWrite32Op>(write.op);
+      if (!isFoldableMaskWrite(maskWrite))
+        continue;
+      uint32_t mask = maskWrite.getMask();
+      Operation *prev = window[prevIdx].op;
+      if (auto prevWrite = dyn_cast<NpuWrite32Op>(prev)) {
+        // write32 followed by maskwrite32: a write32 of the merged value
+        prevWrite.setValue((prevWrite.getValue() & ~mask) |
+                           maskWrite.getValue());
+        prevWrite->moveBefore(maskWrite);
+        maskWrite->erase();
+        write.op = prevWrite;
+        window[prevIdx].op = nullptr;
+      } else if (auto prevMaskWrite = dyn_cast<NpuMaskWrite32Op>(prev);
+                 prevMaskWrite && isFoldableMaskWrite(prevMaskWrite)) {
+        // two maskwrite32s: one maskwrite32 of the union of the masks
+        maskWrite.setValue((prevMaskWrite.getValue() & ~mask) |
+                           maskWrite.getValue());
+        maskWrite.setMask(prevMaskWrite.getMask() | mask);
+        kill(prevIdx);
+      }
+    }
+  }
+
+  // Replace every run of two or more write32s to consecutive addresses with
+  // a block write at the position of the first one.
+  void coalesceWrites(SmallVector<NpuWrite> &window) {
+    SmallVector<NpuWrite32Op> run;
+    auto flush = [&]() {
+      if (run.size() > 1)
+        createBlockWrite(run);
+      run.clear();
+    };
+
+    std::optional<uint32_t> nextAddress;
+    for (NpuWrite &write : window) {
+      if (!write.op)
+        continue;
+      auto write32 = dyn_cast<NpuWrite32Op>(write.op);
+      if (!write32 || write.address != nextAddress)
+        flush();
+      if (!write32) {
+        nextAddress = std::nullopt;
+        continue;
+      }
+      run.push_back(write32);
+      nextAddress = write.address + sizeof(uint32_t);
+    }
+    flush();
+  }
+
+  void createBlockWrite(ArrayRef<NpuWrite32Op> run) {
+    NpuWrite32Op first = run.front();
+    std::vector<uint32_t> words;
+    for (NpuWrite32Op op : run)
+      words.push_back(op.getValue());
+
+    int64_t numWords = words.size();
+    MemRefType memrefType = MemRefType::get({numWords}, builder.getI32Type());
+    TensorType tensorType =
+        RankedTensorType::get({numWords}, builder.getI32Type());
+    auto initVal = DenseElementsAttr::get<uint32_t>(tensorType, words);
+    memref::GlobalOp global =
+        getOrCreateGlobal(first->getParentOfType<RuntimeSequenceOp>(),
+                          memrefType, initVal, first.getLoc());
+
+    builder.setInsertionPoint(first);
+    auto memref = builder.create<memref::GetGlobalOp>(
+        first.getLoc(), memrefType, global.getName());
+    builder.create<NpuBlockWriteOp>(
+        first.getLoc(), first.getAddressAttr(), memref.getResult(), nullptr,
+        first.getColumnAttr(), first.getRowAttr());
+    for (NpuWrite32Op op : run)
+      op->erase();
+  }
+
+  // Returns a constant global holding `initVal`, reusing an existing one of
+  // the device if it holds the same data.
+  memref::GlobalOp getOrCreateGlobal(RuntimeSequenceOp seq,
+                                     MemRefType memrefType,
+                                     DenseElementsAttr initVal, Location loc) {
+    if (!globalsCollected) {
+      for (auto g : device.getOps<memref::GlobalOp>())
+        if (auto value = g.getInitialValue(); value && g.getConstant())
+          globals.try_emplace(*value, g);
+      globalsCollected = true;
+    }
+    if (memref::GlobalOp global = globals.lookup(initVal);
+        global && global.getType() == memrefType)
+      return global;
+
+    std::string name = "blockwrite_data_";
+    while (device.lookupSymbol(name + std::to_string(nextGlobalId)))
+      nextGlobalId++;
+    name += std::to_string(nextGlobalId);
+
+    OpBuilder::InsertionGuard guard(builder);
+    builder.setInsertionPoint(seq);
+    auto global = builder.create<memref::GlobalOp>(
+        loc, name, builder.getStringAttr("private"), memrefType, initVal,
+        true, nullptr);
+    globals[initVal] = global;
+    return global;
+  }
+
+  AIE::DeviceOp device;
+  const AIE::AIETargetModel &tm;
+  OpBuilder builder;
+  DenseMap<Attribute, memref::GlobalOp> globals;
+  bool globalsCollected = false;
+  int nextGlobalId = 0;
+};
+
+struct AIEOptimizeNpuWritesPass
+    : AIEOptimizeNpuWritesBase<AIEOptimizeNpuWritesPass> {
+
+  void runOnOperation() override {
+    AIE::DeviceOp device = getOperation();
+    NpuWriteOptimizer optimizer(device);
+    for (auto seq : device.getOps<RuntimeSequenceOp>())
+      optimizer.run(seq);
+  }
+};
+
+} // namespace
+
+std::unique_ptr<OperationPass<AIE::DeviceOp>>
+AIEX::createAIEOptimizeNpuWritesPass() {
+  return std::make_unique<AIEOptimizeNpuWritesPass>();
+}
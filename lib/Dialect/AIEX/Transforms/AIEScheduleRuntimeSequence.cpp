@@ -0,0 +1,256 @@
+//===- AIEScheduleRuntimeSequence.cpp ---------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+//
+// Overlap the host transfers of a runtime sequence. Each npu.dma_wait is sunk
+// past the npu.dma_memcpy_nd ops following it that do not depend on the
+// transfers it may be waiting for, so that the transfers on other channels
+// are issued before the sequence blocks. Waits end up batched after the
+// transfers they overlap with. The npu.dma_memcpy_nd ops that a wait cannot
+// sink past, because a transfer before them depends on it, are then hoisted
+// above the wait if they do not depend on it themselves.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIEX/IR/AIEXDialect.h"
+#include "aie/Dialect/AIEX/Transforms/AIEXPasses.h"
+
+#include "mlir/Interfaces/ViewLikeInterface.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "aie-schedule-runtime-sequence"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIEX;
+
+namespace {
+
+// A shim DMA channel: column, direction and channel index.
+using Channel = std::tuple<int64_t, AIE::DMAChannelDir, int64_t>;
+
+struct Transfer {
+  std::optional<Channel> channel;
+  int64_t col;
+  int64_t bdId;
+  // The host buffer the transfer accesses a view of.
+  Value buffer;
+  // S2MM transfers write the host buffer, MM2S transfers read it.
+  bool writesMemref;
+  // Waits on the channel complete the transfer, and those before it.
+  bool issuesToken;
+};
+
+class RuntimeSequenceScheduler {
+public:
+  RuntimeSequenceScheduler(AIE::DeviceOp device, bool assumeDistinctBuffers)
+      : device(device), assumeDistinctBuffers(assumeDistinctBuffers) {}
+
+  void run(RuntimeSequenceOp sequence) {
+    Block &body = sequence.getBody().front();
+    // Sinking the last waits first lets the earlier ones move past them.
+    SmallVector<NpuDmaWaitOp> waits(body.getOps<NpuDmaWaitOp>());
+    for (NpuDmaWaitOp wait : llvm::reverse(waits))
+      sink(wait);
+    // Hoisting the first transfers first keeps them in order when several
+    // are hoisted above the same wait.
+    SmallVector<NpuDmaMemcpyNdOp> memcpys(body.getOps<NpuDmaMemcpyNdOp>());
+    for (NpuDmaMemcpyNdOp memcpy : memcpys)
+      hoist(memcpy);
+  }
+
+private:
+  std::optional<Channel> getChannel(StringRef symbol) {
+    auto alloc = AIE::ShimDMAAllocationOp::getForSymbol(device, symbol);
+    if (!alloc)
+      return std::nullopt;
+    return Channel{alloc.getCol(), alloc.getChannelDir(),
+                   alloc.getChannelIndex()};
+  }
+
+  Transfer getTransfer(NpuDmaMemcpyNdOp op) {
+    std::optional<Channel> channel = getChannel(op.getMetadata());
+    int64_t col = channel ? std::get<0>(*channel) : op.getX();
+    bool writes =
+        !channel || std::get<1>(*channel) == AIE::DMAChannelDir::S2MM;
+    Value buffer = op.getMemref();
+    while (auto view = buffer.getDefiningOp<ViewLikeOpInterface>())
+      buffer = view.getViewSource();
+    return {channel, col, op.getId(), buffer, writes, op.getIssueToken()};
+  }
+
+  // Returns true if the host buffers `a` and `b` may overlap. The arguments
+  // of a sequence may be bound to the same buffer unless told otherwise.
+  bool mayAlias(Value a, Value b) const {
+    if (a == b)
+      return true;
+    return !assumeDistinctBuffers || !isa<BlockArgument>(a) ||
+           !isa<BlockArgument>(b);
+  }
+
+  // Returns true if `next` may only be issued once `prev` is done: it
+  // reprograms the BD of `prev`, or accesses a host buffer that may overlap
+  // one `prev` writes, or writes one that may overlap one `prev` accesses.
+  bool conflicts(const Transfer &prev, const Transfer &next) const {
+    return (prev.col == next.col && prev.bdId == next.bdId) ||
+           ((prev.writesMemref || next.writesMemref) &&
+            mayAlias(prev.buffer, next.buffer));
+  }
+
+  // Returns true if `next`, issued after a wait on `channel`, may only be
+  // issued once the transfers in `inFlight` the wait could complete are done:
+  // it is queued on the waited channel, or conflicts with one of them. Waits
+  // on a channel are sometimes used to know that transfers on other channels
+  // are done as well, so all transfers still in flight are considered.
+  bool dependsOnWait(const Transfer &next, const Channel &channel,
+                     ArrayRef<Transfer> inFlight) const {
+    if (!next.channel || *next.channel == channel)
+      return true;
+    return llvm::any_of(inFlight, [&](const Transfer &prev) {
+      return conflicts(prev, next);
+    });
+  }
+
+  // Drops the transfers that a wait on `channel` completes from `inFlight`:
+  // those on the channel up to the last one issuing a token.
+  static void complete(SmallVector<Transfer> &inFlight,
+                       const Channel &channel) {
+    auto lastToken =
+        llvm::find_if(llvm::reverse(inFlight), [&](const Transfer &t) {
+          return t.channel == channel && t.issuesToken;
+        });
+    auto end = lastToken.base();
+    inFlight.erase(std::remove_if(inFlight.begin(), end,
+                                  [&](const Transfer &t) {
+                                    return t.channel == channel;
+                                  }),
+                   end);
+  }
+
+  // Returns the transfers issued before `op` that no wait has completed.
+  SmallVector<Transfer> getInFlight(Operation *op) {
+    SmallVector<Transfer> inFlight;
+    for (Operation &prev :
+         llvm::make_range(op->getBlock()->begin(), op->getIterator())) {
+      if (auto memcpy = dyn_cast<NpuDmaMemcpyNdOp>(prev))
+        inFlight.push_back(getTransfer(memcpy));
+      else if (auto wait = dyn_cast<NpuDmaWaitOp>(prev))
+        if (auto waited = getChannel(wait.getSymbol()))
+          complete(inFlight, *waited);
+    }
+    return inFlight;
+  }
+
+  void sink(NpuDmaWaitOp wait) {
+    std::optional<Channel> channel = getChannel(wait.getSymbol());
+    if (!channel)
+      return;
+
+    // The transfers issued before the wait that are still in flight, and the
+    // number of transfers queued on each channel since the last wait on that
+    // channel. The transfers moved ahead of the wait are issued after those
+    // between the wait and them either way, so only the transfers before the
+    // wait can depend on it.
+    SmallVector<Transfer> inFlight = getInFlight(wait);
+    std::map<Channel, unsigned> queued;
+    auto update = [&](Operation *op) {
+      if (auto memcpy = dyn_cast<NpuDmaMemcpyNdOp>(op)) {
+        if (auto channel = getTransfer(memcpy).channel)
+          ++queued[*channel];
+      } else if (auto otherWait = dyn_cast<NpuDmaWaitOp>(op)) {
+        if (auto waited = getChannel(otherWait.getSymbol()))
+          queued[*waited] = 0;
+      }
+    };
+    for (Operation &prev :
+         llvm::make_range(wait->getBlock()->begin(), wait->getIterator()))
+      update(&prev);
+
+    Operation *last = nullptr;
+    for (Operation *next = wait->getNextNode(); next;
+         next = next->getNextNode()) {
+      if (auto otherWait = dyn_cast<NpuDmaWaitOp>(next)) {
+        std::optional<Channel> waited = getChannel(otherWait.getSymbol());
+        if (waited == channel)
+          break;
+        update(next);
+        if (waited)
+          complete(inFlight, *waited);
+        continue;
+      }
+      // Any other op, e.g. a register write or a sync, is a barrier.
+      auto memcpy = dyn_cast<NpuDmaMemcpyNdOp>(next);
+      if (!memcpy)
+        break;
+      // Transfers are not moved ahead of the wait if that could overflow the
+      // task queue of their channel.
+      Transfer transfer = getTransfer(memcpy);
+      if (dependsOnWait(transfer, *channel, inFlight) ||
+          queued[*transfer.channel] >=
+              device.getTargetModel().getDMATaskQueueDepth(transfer.col, 0))
+        break;
+      update(next);
+      last = next;
+    }
+    if (last)
+      wait->moveAfter(last);
+  }
+
+  // Hoists `op` above the waits before it that it does not depend on, so
+  // that it is issued before the sequence blocks. It stays after the
+  // transfers before it that it conflicts with or that share its channel,
+  // and ends up right before the first wait it is hoisted above.
+  void hoist(NpuDmaMemcpyNdOp op) {
+    Transfer transfer = getTransfer(op);
+    if (!transfer.channel)
+      return;
+    Operation *first = nullptr;
+    for (Operation *prev = op->getPrevNode(); prev;
+         prev = prev->getPrevNode()) {
+      if (auto memcpy = dyn_cast<NpuDmaMemcpyNdOp>(prev)) {
+        Transfer prevTransfer = getTransfer(memcpy);
+        if (!prevTransfer.channel || prevTransfer.channel == transfer.channel ||
+            conflicts(prevTransfer, transfer))
+          break;
+        continue;
+      }
+      // Any other op, e.g. a register write or a sync, is a barrier.
+      auto wait = dyn_cast<NpuDmaWaitOp>(prev);
+      if (!wait)
+        break;
+      std::optional<Channel> channel = getChannel(wait.getSymbol());
+      if (!channel || dependsOnWait(transfer, *channel, getInFlight(wait)))
+        break;
+      first = wait;
+    }
+    if (first)
+      op->moveBefore(first);
+  }
+
+  AIE::DeviceOp device;
+  bool assumeDistinctBuffers;
+};
+
+struct AIEScheduleRuntimeSequencePass
+    : AIEScheduleRuntimeSequenceBase<AIEScheduleRuntimeSequencePass> {
+  void runOnOperation() override {
+    AIE::DeviceOp device = getOperation();
+    RuntimeSequenceScheduler scheduler(device, clAssumeDistinctBuffers);
+    for (auto seq : device.getOps<RuntimeSequenceOp>())
+      scheduler.run(seq);
+  }
+};
+
+} // namespace
+
+std::unique_ptr<OperationPass<AIE::DeviceOp>>
+AIEX::createAIEScheduleRuntimeSequencePass() {
+  return std::make_unique<AIEScheduleRuntimeSequencePass>();
+}
@@ -0,0 +1,505 @@
+//===- AIESplitAccessPatterns.cpp -------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+//
+// Split the host transfers of runtime sequences whose access patterns exceed
+// the wrap, step or iteration fields of a BD into transfers that fit.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIEX/IR/AIEXDialect.h"
+#include "aie/Dialect/AIEX/Transforms/AIEXPasses.h"
+
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/Pass/Pass.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/TypeSwitch.h"
+
+#define DEBUG_TYPE "aie-split-access-patterns"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIEX;
+
+namespace {
+
+// A dimension of an access pattern, in units of the memref element type.
+struct Dim {
+  int64_t size;
+  int64_t stride;
+};
+
+// Returns the constant values of the sizes, strides or offsets of an
+// npu.dma_memcpy_nd op, innermost first.
+SmallVector<int64_t> getInnermostFirst(ArrayRef<OpFoldResult> values) {
+  return llvm::map_to_vector(llvm::reverse(values), [](OpFoldResult v) {
+    return getConstantIntValue(v).value();
+  });
+}
+
+// Returns the offset at which the access pattern of `op` starts, in units of
+// the memref element type, which may be narrower than a byte.
+int64_t getOffset(NpuDmaMemcpyNdOp op) {
+  int64_t offset = 0;
+  for (auto [o, stride] : llvm::zip(getInnermostFirst(op.getMixedOffsets()),
+                                    getInnermostFirst(op.getMixedStrides())))
+    offset += o * stride;
+  return offset;
+}
+
+// Returns the dimensions of the access pattern of `op`, innermost first.
+SmallVector<Dim> getDims(NpuDmaMemcpyNdOp op) {
+  SmallVector<Dim> dims;
+  for (auto [size, stride] :
+       llvm::zip(getInnermostFirst(op.getMixedSizes()),
+                 getInnermostFirst(op.getMixedStrides())))
+    dims.push_back({size, stride});
+  return dims;
+}
+
+// Returns the dimensions of the access pattern of `op`, innermost first, with
+// the dimensions of size one dropped and the dimensions walking contiguously
+// through their inner dimension merged into it.
+SmallVector<Dim> getFoldedDims(NpuDmaMemcpyNdOp op) {
+  SmallVector<Dim> dims;
+  for (Dim dim : getDims(op)) {
+    if (dim.size == 1)
+      continue;
+    if (!dims.empty() && dims.back().stride > 0 &&
+        dim.stride == dims.back().size * dims.back().stride) {
+      dims.back().size *= dim.size;
+      continue;
+    }
+    dims.push_back(dim);
+  }
+  if (dims.empty())
+    dims.push_back({1, 1});
+  return dims;
+}
+
+// The BD limits for the transfers of one npu.dma_memcpy_nd op.
+class BDLimits {
+public:
+  BDLimits(const AIE::AIETargetModel &targetModel, MemRefType bufferType,
+           int tileCol, int tileRow, uint32_t wrapBits, uint32_t stepBits,
+           uint32_t iterBits)
+      : targetModel(targetModel), bufferType(bufferType),
+        elemWidth(bufferType.getElementTypeBitWidth()),
+        granularity(targetModel.getAddressGenGranularity()),
+        maxWrap((1 << wrapBits) - 1), maxStep(1 << stepBits),
+        maxIterations((1 << iterBits) + 1),
+        boundedD2(targetModel.isMemTile(tileCol, tileRow)) {}
+
+  // Number of elements in a unit of the address generation.
+  int64_t getGranuleElems() const {
+    return std::max<int64_t>(1, granularity / elemWidth);
+  }
+
+  // Returns true if the 4-d access pattern `bd` can be programmed into a BD,
+  // following AIEX::verifyStridesWraps.
+  bool fits(ArrayRef<Dim> bd) const {
+    SmallVector<int64_t, 4> sizes, strides;
+    for (Dim dim : bd) {
+      sizes.push_back(dim.size);
+      strides.push_back(dim.stride);
+    }
+    if (sizes[0] * elemWidth % granularity != 0)
+      return false;
+    for (int i = 0; i < 4; i++) {
+      if (sizes[i] > 1 && strides[i] < (i < 3 ? 1 : 0))
+        return false;
+      if (!(i == 0 && strides[i] == 1) &&
+          strides[i] * elemWidth % granularity != 0)
+        return false;
+    }
+    SmallVector<int64_t, 4> hwSizes(4), hwStrides(4);
+    getHardwareStridesWraps(targetModel, bufferType, sizes, strides, hwSizes,
+                            hwStrides);
+    bool linear = sizes[1] == 1 && sizes[2] == 1 && strides[0] == 1 &&
+                  strides[1] == 0 && strides[2] == 0;
+    if ((!linear && hwSizes[0] > maxWrap) || hwSizes[1] > maxWrap ||
+        (boundedD2 && hwSizes[2] > maxWrap) ||
+        hwSizes[3] > maxIterations - 1)
+      return false;
+    return hwStrides[0] <= maxStep && hwStrides[1] <= maxStep &&
+           hwStrides[2] <= maxStep &&
+           (hwStrides[3] <= maxStep || hwSizes[3] == 0);
+  }
+
+  // Returns the largest factor of `dim` fitting into position `pos` of a BD,
+  // or 0 if none does.
+  int64_t getLargestFit(unsigned pos, Dim dim) const {
+    if (!fitsAt(pos, {pos == 0 ? getGranuleElems() : 1, dim.stride}))
+      return 0;
+    int64_t limit = dim.size;
+    if (pos == 0)
+      limit = maxWrap * granularity / elemWidth;
+    else if (pos == 1 || (pos == 2 && boundedD2))
+      limit = maxWrap;
+    else if (pos == 3)
+      limit = maxIterations;
+    for (int64_t size = std::min(dim.size, limit); size > 0; --size)
+      if (dim.size % size == 0 && fitsAt(pos, {size, dim.stride}))
+        return size;
+    return 0;
+  }
+
+  // Returns true if the wraps and steps of the aie.dma_bd dimensions `dims`,
+  // innermost first, fit into their fields. Only the dimensions of a memtile
+  // BD beyond the third one have no wrap field.
+  bool fitsTileBD(ArrayRef<Dim> dims) const {
+    for (auto [pos, dim] : llvm::enumerate(dims)) {
+      int64_t wrap = pos == 0 ? dim.size * elemWidth / granularity : dim.size;
+      int64_t step = dim.stride * elemWidth / granularity;
+      if ((pos < 2 || (pos == 2 && boundedD2)) && wrap > maxWrap)
+        return false;
+      if (dim.size > 1 && step - 1 > maxStep)
+        return false;
+    }
+    return true;
+  }
+
+private:
+  bool stepFits(int64_t stride) const {
+    return stride > 0 && stride * elemWidth % granularity == 0 &&
+           stride * elemWidth / granularity - 1 <= maxStep;
+  }
+
+  bool fitsAt(unsigned pos, Dim dim) const {
+    switch (pos) {
+    case 0:
+      return dim.size * elemWidth % granularity == 0 &&
+             dim.size * elemWidth / granularity <= maxWrap &&
+             (dim.stride == 1 || stepFits(dim.stride));
+    case 1:
+      return dim.size <= maxWrap && stepFits(dim.stride);
+    case 2:
+      return (!boundedD2 || dim.size <= maxWrap) && stepFits(dim.stride);
+    default:
+      return dim.size <= maxIterations &&
+             (dim.stride == 0 || stepFits(dim.stride));
+    }
+  }
+
+  const AIE::AIETargetModel &targetModel;
+  MemRefType bufferType;
+  int64_t elemWidth;
+  int64_t granularity;
+  int64_t maxWrap;
+  int64_t maxStep;
+  int64_t maxIterations;
+  bool boundedD2;
+};
+
+// The split of an access pattern: the pattern of every transfer, and the
+// offsets at which the transfers start, in units of the memref element type.
+struct Split {
+  SmallVector<Dim, 4> bd;
+  SmallVector<int64_t> offsets;
+};
+
+// Splits the folded access pattern `dims` starting at `offset` into transfers
+// fitting into a BD each. The dimensions are placed into the BD innermost
+// first, each split by its largest factor fitting into the next free position
+// of the BD, so that the bursts are as long as possible. The dimensions left
+// over are unrolled into separate transfers.
+FailureOr<Split> splitAccessPattern(const BDLimits &limits,
+                                    SmallVector<Dim> dims, int64_t offset) {
+  Split split;
+  split.bd.assign(4, {1, 0});
+  if (dims.size() <= 4) {
+    SmallVector<Dim, 4> bd(dims.begin(), dims.end());
+    bd.resize(4, {1, 0});
+    if (limits.fits(bd)) {
+      split.bd = bd;
+      split.offsets.push_back(offset);
+      return split;
+    }
+  }
+
+  unsigned pos = 0;
+  auto next = dims.begin();
+  while (next != dims.end() && pos < 4) {
+    // The dimension goes into the first position it, or a factor of it, fits
+    // in; the positions skipped are left with a size of one. Factors of one
+    // are only useful for the innermost position, which cannot be skipped.
+    unsigned fitPos = pos;
+    int64_t fit = 0;
+    for (; fitPos < 4; ++fitPos) {
+      fit = limits.getLargestFit(fitPos, *next);
+      if (fit == next->size || fit > 1 || (fitPos == 0 && fit))
+        break;
+    }
+    if (pos == 0 && fitPos != 0)
+      return failure();
+    if (fitPos == 4)
+      break;
+    split.bd[fitPos] = {fit, next->stride};
+    if (fit == next->size)
+      ++next;
+    else
+      *next = {next->size / fit, next->stride * fit};
+    pos = fitPos + 1;
+  }
+
+  // Unroll the dimensions left over.
+  SmallVector<Dim> unrolled(next, dims.end());
+  int64_t numTransfers = 1;
+  for (Dim dim : unrolled)
+    numTransfers *= dim.size;
+  for (int64_t i = 0; i < numTransfers; ++i) {
+    int64_t transferOffset = offset;
+    int64_t index = i;
+    for (Dim dim : unrolled) {
+      transferOffset += index % dim.size * dim.stride;
+      index /= dim.size;
+    }
+    split.offsets.push_back(transferOffset);
+  }
+
+  if (!limits.fits(split.bd))
+    return failure();
+  return split;
+}
+
+class AccessPatternSplitter {
+public:
+  AccessPatternSplitter(AIE::DeviceOp device) : device(device) {}
+
+  void run(RuntimeSequenceOp sequence) {
+    SmallVector<NpuDmaMemcpyNdOp> illegal;
+    sequence.walk([&](Operation *op) {
+      if (auto writeBd = dyn_cast<NpuWriteBdOp>(op))
+        usedBdIds[writeBd.getColumn()].insert(writeBd.getBdId());
+      auto memcpy = dyn_cast<NpuDmaMemcpyNdOp>(op);
+      if (!memcpy)
+        return;
+      usedBdIds[getColumn(memcpy)].insert(memcpy.getId());
+      if (!isLegal(memcpy))
+        illegal.push_back(memcpy);
+    });
+    for (NpuDmaMemcpyNdOp op : illegal)
+      splitTransfer(op);
+  }
+
+private:
+  int64_t getColumn(NpuDmaMemcpyNdOp op) {
+    auto alloc =
+        AIE::ShimDMAAllocationOp::getForSymbol(device, op.getMetadata());
+    return alloc ? alloc.getCol() : op.getX();
+  }
+
+  std::optional<BDLimits> getLimits(NpuDmaMemcpyNdOp op) {
+    const auto &targetModel = device.getTargetModel();
+    uint32_t wrapBits = 0;
+    uint32_t stepBits = 0;
+    uint32_t iterBits = 0;
+    if (failed(getStridesWrapsFieldWidths(targetModel, op.getX(), op.getY(),
+                                          wrapBits, stepBits, iterBits)))
+      return std::nullopt;
+    return BDLimits(targetModel, op.getMemref().getType(), op.getX(),
+                    op.getY(), wrapBits, stepBits, iterBits);
+  }
+
+  bool isSameChannel(StringRef a, StringRef b) {
+    if (a == b)
+      return true;
+    auto allocA = AIE::ShimDMAAllocationOp::getForSymbol(device, a);
+    auto allocB = AIE::ShimDMAAllocationOp::getForSymbol(device, b);
+    return allocA && allocB && allocA.getCol() == allocB.getCol() &&
+           allocA.getChannelDir() == allocB.getChannelDir() &&
+           allocA.getChannelIndex() == allocB.getChannelIndex();
+  }
+
+  // Returns true if a transfer issued before `op` on its channel has issued
+  // a token that no npu.dma_wait has consumed yet.
+  bool hasOutstandingToken(NpuDmaMemcpyNdOp op) {
+    int tokens = 0;
+    for (Operation &prev :
+         llvm::make_range(op->getBlock()->begin(), op->getIterator())) {
+      if (auto memcpy = dyn_cast<NpuDmaMemcpyNdOp>(prev)) {
+        if (memcpy.getIssueToken() &&
+            isSameChannel(memcpy.getMetadata(), op.getMetadata()))
+          ++tokens;
+      } else if (auto wait = dyn_cast<NpuDmaWaitOp>(prev)) {
+        if (tokens > 0 && isSameChannel(wait.getSymbol(), op.getMetadata()))
+          --tokens;
+      }
+    }
+    return tokens > 0;
+  }
+
+  bool isLegal(NpuDmaMemcpyNdOp op) {
+    std::optional<BDLimits> limits = getLimits(op);
+    if (!limits)
+      return true;
+    return limits->fits(getDims(op));
+  }
+
+  void splitTransfer(NpuDmaMemcpyNdOp op) {
+    // Every transfer of a packet-switched pattern would send a header, and
+    // zero padding applies to the pattern as a whole.
+    if (op.getPacket() || op.getD0ZeroBefore() || op.getD1ZeroBefore() ||
+        op.getD2ZeroBefore() || op.getD0ZeroAfter() || op.getD1ZeroAfter() ||
+        op.getD2ZeroAfter())
+      return;
+    std::optional<BDLimits> limits = getLimits(op);
+    FailureOr<Split> split =
+        splitAccessPattern(*limits, getFoldedDims(op), getOffset(op));
+    if (failed(split))
+      return;
+
+    // The transfers start at their offset in a dimension of the pattern they
+    // all share: the innermost one if it is contiguous, else one of size one.
+    SmallVector<Dim, 4> bd = split->bd;
+    int offsetDim = -1;
+    int64_t offsetStride = 1;
+    if (bd[0].stride == 1) {
+      offsetDim = 0;
+    } else if (auto *it = llvm::find_if(
+                   llvm::drop_begin(bd), [](Dim dim) { return dim.size == 1; });
+               it != bd.end()) {
+      offsetDim = std::distance(bd.begin(), it);
+      offsetStride = limits->getGranuleElems();
+      bd[offsetDim].stride = offsetStride;
+    } else {
+      for (auto [i, dim] : llvm::enumerate(bd))
+        if (dim.stride > 0 &&
+            llvm::all_of(split->offsets, [&](int64_t offset) {
+              return offset % dim.stride == 0;
+            })) {
+          offsetDim = i;
+          offsetStride = dim.stride;
+          break;
+        }
+    }
+    if (offsetDim < 0)
+      return;
+
+    // The transfers are queued on the channel of the original one, using BD
+    // IDs not used by any other transfer of the column. Before the queue of
+    // the channel overflows, or BD IDs are reused, the transfers issued so far
+    // are waited for.
+    const auto &targetModel = device.getTargetModel();
+    int64_t col = getColumn(op);
+    auto &used = usedBdIds[col];
+    size_t maxBdIds = std::min<size_t>(targetModel.getDMATaskQueueDepth(col, 0),
+                                       split->offsets.size());
+    SmallVector<int64_t> bdIds = {op.getId()};
+    for (int64_t id = 0, e = targetModel.getNumBDs(col, 0);
+         id < e && bdIds.size() < maxBdIds; ++id)
+      if (!used.contains(id))
+        bdIds.push_back(id);
+    size_t batchSize = bdIds.size();
+    // The waits between the batches must complete the token of the last
+    // transfer of the batch, not one issued before on the channel.
+    if (split->offsets.size() > batchSize &&
+        (!AIE::ShimDMAAllocationOp::getForSymbol(device, op.getMetadata()) ||
+         hasOutstandingToken(op)))
+      return;
+    used.insert(bdIds.begin(), bdIds.end());
+
+    OpBuilder builder(op);
+    SmallVector<int64_t, 4> sizes, strides;
+    for (Dim dim : llvm::reverse(bd)) {
+      sizes.push_back(dim.size);
+      strides.push_back(dim.stride);
+    }
+    for (auto [i, offset] : llvm::enumerate(split->offsets)) {
+      SmallVector<int64_t, 4> offsets(4, 0);
+      offsets[3 - offsetDim] = offset / offsetStride;
+      bool last = i + 1 == split->offsets.size();
+      bool endOfBatch = (i + 1) % batchSize == 0;
+      builder.create<NpuDmaMemcpyNdOp>(
+          op.getLoc(), op.getX(), op.getY(), op.getMemref(),
+          SmallVector<Value>{}, SmallVector<Value>{}, SmallVector<Value>{},
+          ArrayRef(offsets), ArrayRef(sizes), ArrayRef(strides),
+          /*packet=*/nullptr, op.getMetadata(), bdIds[i % batchSize],
+          last ? op.getIssueToken() : endOfBatch, 0, 0, 0, 0, 0, 0);
+      if (!last && endOfBatch)
+        builder.create<NpuDmaWaitOp>(op.getLoc(), op.getMetadata());
+    }
+    op.erase();
+  }
+
+  AIE::DeviceOp device;
+  // The BD IDs used by the transfers of each column.
+  std::map<int64_t, llvm::DenseSet<int64_t>> usedBdIds;
+};
+
+// Only the transfers of runtime sequences are split; the BDs programmed by the
+// device are checked against the limits of their tile instead.
+LogicalResult verifyTileBD(AIE::DMABDOp op) {
+  auto dims = op.getDimensions();
+  auto tile = op->getParentOfType<AIE::TileElement>();
+  if (!dims || !tile)
+    return success();
+  const auto &targetModel = AIE::getTargetModel(op);
+  AIE::TileID tileId = tile.getTileID();
+  uint32_t wrapBits = 0;
+  uint32_t stepBits = 0;
+  uint32_t iterBits = 0;
+  if (failed(getStridesWrapsFieldWidths(targetModel, tileId.col, tileId.row,
+                                        wrapBits, stepBits, iterBits)))
+    return success();
+  BDLimits limits(targetModel, op.getBuffer().getType(), tileId.col,
+                  tileId.row, wrapBits, stepBits, iterBits);
+  SmallVector<Dim> bdDims;
+  for (AIE::BDDimLayoutAttr dim : llvm::reverse(*dims))
+    bdDims.push_back({static_cast<int64_t>(dim.getSize()),
+                      static_cast<int64_t>(dim.getStride())});
+  if (limits.fitsTileBD(bdDims))
+    return success();
+  return op.emitOpError() << "access pattern exceeds the wrap and step fields "
+                             "of the BDs of tile ("
+                          << tileId.col << ", " << tileId.row
+                          << "); only npu.dma_memcpy_nd transfers are split";
+}
+
+// The repetitions of a task are counted by the task queue of its channel.
+template <typename OpTy>
+LogicalResult verifyRepeatCount(OpTy op) {
+  if (op.getRepeatCount() > 255)
+    return op.emitOpError("Repeat count exceeds the [0:255] range.");
+  return success();
+}
+
+struct AIESplitAccessPatternsPass
+    : AIESplitAccessPatternsBase<AIESplitAccessPatternsPass> {
+  void runOnOperation() override {
+    AIE::DeviceOp device = getOperation();
+    bool hasErrors = false;
+    if (!isa<AIE::AIE1TargetModel>(device.getTargetModel()))
+      device.walk([&](AIE::DMABDOp op) {
+        hasErrors |= failed(verifyTileBD(op));
+      });
+    for (auto seq : device.getOps<RuntimeSequenceOp>()) {
+      seq.walk([&](Operation *op) {
+        LogicalResult result =
+            TypeSwitch<Operation *, LogicalResult>(op)
+                .Case<DMAConfigureTaskOp, DMAConfigureTaskForOp,
+                      DMAStartBdChainOp, DMAStartBdChainForOp>(
+                    [](auto task) { return verifyRepeatCount(task); })
+                .Default([](Operation *) { return success(); });
+        hasErrors |= failed(result);
+      });
+      AccessPatternSplitter(device).run(seq);
+    }
+    if (hasErrors)
+      signalPassFailure();
+  }
+};
+
+} // namespace
+
+std::unique_ptr<OperationPass<AIE::DeviceOp>>
+AIEX::createAIESplitAccessPatternsPass() {
+  return std::make_unique<AIESplitAccessPatternsPass>();
+}
@@ -600,6 +600,18 @@ LogicalResult AIERTControl::addInitConfig(DeviceOp &targetOp) {
     return failure();
   }
 
+  if (failed(configureDMAs(targetOp))) {
+    return failure();
+  }
+
+  if (failed(configureSwitches(targetOp))) {
+    return failure();
+  }
+
+  return success();
+}
+
+LogicalResult AIERTControl::configureDMAs(DeviceOp &targetOp) {
   auto memOps = llvm::to_vector_of<TileElement>(targetOp.getOps<MemOp>());
   llvm::append_range(memOps, targetOp.getOps<MemTileDMAOp>());
   llvm::append_range(memOps, targetOp.getOps<ShimDMAOp>());
@@ -656,10 +668,6 @@ LogicalResult AIERTControl::addInitConfig(DeviceOp &targetOp) {
       }
   }
 
-  if (failed(configureSwitches(targetOp))) {
-    return failure();
-  }
-
   return success();
 }
 
@@ -693,33 +701,58 @@ LogicalResult AIERTControl::addAieElf(uint8_t col, uint8_t row,
   return success();
 }
 
+LogicalResult AIERTControl::addAieElf(CoreOp coreOp, const StringRef elfPath,
+                                      bool aieSim) {
+  int col = coreOp.colIndex();
+  int row = coreOp.rowIndex();
+  std::string fileName;
+  if (auto fileAttr = coreOp.getElfFile())
+    fileName = fileAttr->str();
+  else
+    fileName = (llvm::Twine("core_") + std::to_string(col) + "_" +
+                std::to_string(row) + ".elf")
+                   .str();
+  auto ps = std::filesystem::path::preferred_separator;
+  return addAieElf(
+      col, row, (llvm::Twine(elfPath) + std::string(1, ps) + fileName).str(),
+      aieSim);
+}
+
 LogicalResult AIERTControl::addAieElfs(DeviceOp &targetOp,
                                        const StringRef elfPath, bool aieSim) {
   for (auto tileOp : targetOp.getOps<TileOp>())
     if (tileOp.isShimNOCorPLTile()) {
       // Resets no needed with V2 kernel driver
-    } else {
-      int col = tileOp.colIndex();
-      int row = tileOp.rowIndex();
-      if (auto coreOp = tileOp.getCoreOp()) {
-        std::string fileName;
-        if (auto fileAttr = coreOp.getElfFile())
-          fileName = fileAttr->str();
-        else
-          fileName = (llvm::Twine("core_") + std::to_string(col) + "_" +
-                      std::to_string(row) + ".elf")
-                         .str();
-        auto ps = std::filesystem::path::preferred_separator;
-        if (failed(addAieElf(
-                col, row,
-                (llvm::Twine(elfPath) + std::string(1, ps) + fileName).str(),
-                aieSim)))
-          return failure();
-      }
+    } else if (auto coreOp = tileOp.getCoreOp()) {
+      if (failed(addAieElf(coreOp, elfPath, aieSim)))
+        return failure();
     }
   return success();
 }
 
+LogicalResult AIERTControl::resetTile(uint8_t col, uint8_t row) {
+  auto tileLoc = XAie_TileLoc(col, row);
+  if (targetModel.isCoreTile(col, row))
+    TRY_XAIE_API_LOGICAL_RESULT(XAie_CoreDisable, &devInst, tileLoc);
+  TRY_XAIE_API_LOGICAL_RESULT(XAie_DmaChannelResetAll, &devInst, tileLoc,
+                              XAie_DmaChReset::DMA_CHANNEL_RESET);
+  TRY_XAIE_API_LOGICAL_RESULT(XAie_DmaChannelResetAll, &devInst, tileLoc,
+                              XAie_DmaChReset::DMA_CHANNEL_UNRESET);
+  return success();
+}
+
+// Set every lock of a tile to zero, e.g. before configuring a design that
+// does not initialize all the locks a previous design used.
+LogicalResult AIERTControl::resetLocks(uint8_t col, uint8_t row) {
+  auto tileLoc = XAie_TileLoc(col, row);
+  for (uint32_t l = 0; l < targetModel.getNumLocks(col, row); l++) {
+    auto locInit = XAie_LockInit(l, 0);
+    TRY_XAIE_API_LOGICAL_RESULT(XAie_LockSetValue, &devInst, tileLoc,
+                                locInit);
+  }
+  return success();
+}
+
 void AIERTControl::dmaUpdateBdAddr(int col, int row, size_t addr, size_t bdId) {
   auto tileLoc = XAie_TileLoc(col, row);
   TRY_XAIE_API_FATAL_ERROR(XAie_DmaUpdateBdAddr, &devInst, tileLoc, addr, bdId);
@@ -12,15 +12,24 @@
 #include "aie/Dialect/AIE/IR/AIETargetModel.h"
 #include "aie/Dialect/AIEX/IR/AIEXDialect.h"
 
+#include "mlir/IR/Threading.h"
+
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Format.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <fcntl.h> // open
 #include <gelf.h>
 #include <iostream>
 #include <libelf.h>
+#include <map>
+#include <optional>
 #include <set>
 #include <sys/stat.h>
 #include <unistd.h> // read
@@ -282,22 +291,11 @@ using ShimSSSlaveCfgBlock = uint32_t[SHIM_SS_SLAVE_CFG_COUNT];
 using ShimSSSlaveSlotBlock = uint32_t[SHIM_SS_SLAVE_SLOT_COUNT];
 
 // section names
-static uint8_t secNameOffset[SEC_IDX_MAX];
-
 static const char *secNameStr[SEC_IDX_MAX] = {
     "null",     ".ssmast",   ".ssslve",    ".sspckt",
     ".sdma.bd", ".shmmux",   ".sdma.ctl",  ".prgm.mem",
     ".tdma.bd", ".tdma.ctl", "deprecated", ".data.mem"};
 
-static size_t stridx;
-
-/*
-   Holds a sorted list of all writes made to device memory
-   All recorded writes are time/order invariant. This allows sorting to
-   compact the airbin.
-*/
-static std::map<uint64_t, uint32_t> memWrites;
-
 /*
  * Tile address format:
  * --------------------------------------------
@@ -333,8 +331,6 @@ public:
 
   uint8_t col() const { return column; }
 
-  void clearRange(uint32_t rangeStart, uint32_t length);
-
 private:
   uint64_t arrayOffset : 34;
   uint8_t column : TILE_ADDR_COL_WIDTH;
@@ -365,7 +361,9 @@ public:
   Section(uint64_t addr) : address(addr){};
   uint64_t getAddr() const { return address; }
   size_t getLength() const { return data.size() * sizeof(uint32_t); }
-  void addData(uint32_t value) { data.push_back(value); }
+  void addData(llvm::ArrayRef<uint32_t> values) {
+    data.insert(data.end(), values.begin(), values.end());
+  }
   const uint32_t *getData() const { return data.data(); }
 
 private:
@@ -395,64 +393,203 @@ public:
 };
 
 /*
-        Add or replace a register value in 'mem_writes'
+   Holds the writes made to the memory of one tile in pages of words, of
+   which only those written are output. All recorded writes are time/order
+   invariant: the last value written to an address is kept. Pages are
+   allocated on the first write to them and kept sorted, so that contiguous
+   writes are grouped into sections without sorting.
 */
-static void write32(Address addr, uint32_t value) {
-  if (addr.destTile().col() <= 0)
-    llvm::report_fatal_error(
-        llvm::Twine("address of destination tile <= 0 : ") +
-        std::to_string(addr.destTile().col()));
+class TileImage {
+public:
+  static constexpr auto PAGE_SIZE = 0x1000u;
+  static constexpr unsigned WORDS_PER_PAGE = PAGE_SIZE / sizeof(uint32_t);
 
-  auto ret = memWrites.emplace(addr, value);
-  if (!ret.second)
-    ret.first->second = value;
-}
+  TileImage(TileAddress tile) : tile{tile} {}
 
-/*
-        Look up a value for a given address
+  void write32(uint32_t offset, uint32_t value) {
+    Page &page = getPage(offset);
+    auto word = (offset % PAGE_SIZE) / 4u;
+    page.words[word] = value;
+    page.written.set(word);
+  }
 
-        If the address is found return the value, otherwise 0
-*/
-static uint32_t read32(Address addr) {
-  auto ret = memWrites.find(addr);
-  if (ret != memWrites.end())
-    return ret->second;
+  uint32_t read32(uint32_t offset) const {
+    auto it = pages.find(offset / PAGE_SIZE);
+    if (it == pages.end())
+      return 0;
+    auto word = (offset % PAGE_SIZE) / 4u;
+    return it->second.written.test(word) ? it->second.words[word] : 0;
+  }
 
-  return 0;
-}
+  /*
+          Write `size` bytes from `data`, or zeroes if it is null, starting
+          at `start`, a page at a time. The last word is padded with zeroes.
+  */
+  void write(uint32_t start, const uint8_t *data, size_t size) {
+    assert(start % 4 == 0 && "start address must be 4 byte aligned");
+    for (size_t done = 0; done < size;) {
+      uint32_t offset = start + done;
+      Page &page = getPage(offset);
+      auto first = (offset % PAGE_SIZE) / 4u;
+      size_t bytes = std::min<size_t>(size - done, PAGE_SIZE - first * 4u);
+      auto last = first + (bytes + 3u) / 4u;
+      page.words[last - 1] = 0;
+      if (data)
+        memcpy(&page.words[first], data + done, bytes);
+      else
+        std::fill(page.words.begin() + first, page.words.begin() + last, 0);
+      page.written.set(first, last);
+      done += bytes;
+    }
+  }
+
+  /*
+          Set every address in the range to 0
+  */
+  void clearRange(uint32_t start, uint32_t length) {
+    if (start % 4 != 0)
+      llvm::report_fatal_error(llvm::Twine("start address ") +
+                               std::to_string(start) +
+                               " must word 4 byte aligned");
+    if (length % 4 != 0)
+      llvm::report_fatal_error(llvm::Twine("length ") +
+                               std::to_string(length) +
+                               " must be a multiple of 4 bytes");
+
+    LLVM_DEBUG(llvm::dbgs() << llvm::format("0x%lx - 0x%lx (len: %u)\n",
+                                            tile.fullAddress(start),
+                                            tile.fullAddress(start + length),
+                                            length));
+    write(start, nullptr, length);
+  }
+
+  /*
+          Append the runs of written words to `sections`, starting a new
+          section wherever a run does not follow the previous one.
+  */
+  void groupSections(std::vector<Section> &sections) const {
+    std::optional<uint64_t> nextAddr;
+    for (const auto &[pageNum, page] : pages) {
+      for (int first = page.written.find_first(); first != -1;) {
+        int last = page.written.find_next_unset(first);
+        if (last == -1)
+          last = WORDS_PER_PAGE;
+        uint64_t addr = tile.fullAddress(pageNum * PAGE_SIZE + first * 4u);
+        if (addr != nextAddr) {
+          LLVM_DEBUG(llvm::dbgs() << "Starting new section @ "
+                                  << llvm::format("0x%lx\n", addr));
+          sections.emplace_back(addr);
+        }
+        sections.back().addData(
+            llvm::ArrayRef<uint32_t>(page.words).slice(first, last - first));
+        nextAddr = addr + (last - first) * 4u;
+        first = page.written.find_next(last);
+      }
+    }
+  }
+
+  size_t numWrites() const {
+    size_t count = 0;
+    for (const auto &[pageNum, page] : pages)
+      count += page.written.count();
+    return count;
+  }
+
+private:
+  struct Page {
+    std::array<uint32_t, WORDS_PER_PAGE> words;
+    llvm::BitVector written{WORDS_PER_PAGE};
+  };
+
+  Page &getPage(uint32_t offset) {
+    if (offset >= (1u << TILE_ADDR_OFF_WIDTH))
+      llvm::report_fatal_error(llvm::Twine("offset 0x") +
+                               llvm::utohexstr(offset) +
+                               " is outside of the tile");
+    return pages[offset / PAGE_SIZE];
+  }
+
+  TileAddress tile;
+  std::map<uint32_t, Page> pages;
+};
 
 /*
-        Set every address in the range to 0
+   The memory images of the tiles of a device, sorted by tile address so
+   that their sections come out in address order.
 */
-void TileAddress::clearRange(uint32_t start, uint32_t length) {
-  if (start % 4 != 0)
-    llvm::report_fatal_error(llvm::Twine("start address ") +
-                             std::to_string(start) +
-                             " must word 4 byte aligned");
-  if (start % 4 != 0)
-    llvm::report_fatal_error(llvm::Twine("length ") + std::to_string(start) +
-                             " must be a multiple of 4 bytes");
-
-  LLVM_DEBUG(llvm::dbgs() << llvm::format("<%u,%u> 0x%x - 0x%x (len: %u)\n",
-                                          column, row, start, start + length,
-                                          length));
-  for (auto off = start; off < start + length; off += 4u)
-    write32(Address{*this, off}, 0);
-}
+class DeviceImage {
+public:
+  /*
+          Get the image of a tile, creating it if needed. Creating images is
+          not thread-safe; writing to distinct existing images is.
+  */
+  TileImage &getTile(TileAddress tile) {
+    if (tile.col() <= 0)
+      llvm::report_fatal_error(
+          llvm::Twine("address of destination tile <= 0 : ") +
+          std::to_string(tile.col()));
+    return tiles.try_emplace(tile.fullAddress(0), tile).first->second;
+  }
+
+  /*
+          Add or replace a register value
+  */
+  void write32(Address addr, uint32_t value) {
+    getTile(addr.destTile()).write32(addr.getOffset(), value);
+  }
+
+  /*
+          Look up a value for a given address
+
+          If the address is found return the value, otherwise 0
+  */
+  uint32_t read32(Address addr) {
+    return getTile(addr.destTile()).read32(addr.getOffset());
+  }
+
+  /*
+          Group the writes into contiguous sections, one tile per thread
+  */
+  std::vector<Section> groupSections(MLIRContext *context) const {
+    std::vector<const TileImage *> images;
+    for (const auto &[tileAddr, image] : tiles)
+      images.push_back(&image);
+    std::vector<std::vector<Section>> tileSections(images.size());
+    parallelFor(context, 0, images.size(), [&](size_t i) {
+      images[i]->groupSections(tileSections[i]);
+    });
+
+    std::vector<Section> sections;
+    for (auto &s : tileSections)
+      std::move(s.begin(), s.end(), std::back_inserter(sections));
+    return sections;
+  }
+
+  size_t numWrites() const {
+    size_t count = 0;
+    for (const auto &[tileAddr, image] : tiles)
+      count += image.numWrites();
+    return count;
+  }
+
+private:
+  std::map<uint64_t, TileImage> tiles;
+};
 
 /*
    Read the ELF produced by the AIE compiler and include its loadable
    output in the airbin ELF
+
+   elf_version() must have been called before, as this may run on several
+   tiles at once.
 */
-static void loadElf(TileAddress tile, const std::string &filename) {
-  LLVM_DEBUG(llvm::dbgs() << "Reading ELF file " << filename << " for tile "
-                          << tile << '\n');
+static void loadElf(TileImage &image, const std::string &filename) {
+  LLVM_DEBUG(llvm::dbgs() << "Reading ELF file " << filename << '\n');
 
   int elfFd = open(filename.c_str(), O_RDONLY);
   if (elfFd < 0)
     llvm::report_fatal_error(llvm::Twine("Can't open elf file ") + filename);
 
-  elf_version(EV_CURRENT);
   Elf *inElf = elf_begin(elfFd, ELF_C_READ, nullptr);
 
   // check the characteristics
@@ -474,6 +611,9 @@ static void loadElf(TileAddress tile, const std::string &filename) {
     llvm::report_fatal_error(llvm::Twine("cannot get program header count: ") +
                              elf_errmsg(-1));
 
+  size_t elfSize;
+  char *raw = elf_rawfile(inElf, &elfSize);
+
   // iterate through all program headers
   for (unsigned int ndx = 0; ndx < phnum; ndx++) {
     GElf_Phdr phdrMem;
@@ -496,20 +636,14 @@ static void loadElf(TileAddress tile, const std::string &filename) {
     LLVM_DEBUG(llvm::dbgs()
                << llvm::format("ELF flags=0x%x vaddr=0x%lx dest=0x%x\r\n",
                                phdr->p_flags, phdr->p_vaddr, dest));
-    // read data one word at a time and write it to the output list
-    // TODO since we know these are data and not registers, we could likely
-    // bypass the output list and write a section directly into the AIRBIN
-    size_t elfSize;
-    uint32_t offset;
-    char *raw = elf_rawfile(inElf, &elfSize);
-
-    for (offset = phdr->p_offset; offset < phdr->p_offset + phdr->p_filesz;
-         offset += 4) {
-      Address destAddr{tile, dest};
-      uint32_t data = *reinterpret_cast<uint32_t *>(raw + offset);
-      write32(destAddr, data);
-      dest += 4;
-    }
+    if (phdr->p_offset + phdr->p_filesz > elfSize)
+      llvm::report_fatal_error(llvm::Twine("program header entry ") +
+                               std::to_string(ndx) + " is outside of " +
+                               filename);
+
+    // these are data and not registers, so copy the segment a page at a time
+    image.write(dest, reinterpret_cast<uint8_t *>(raw + phdr->p_offset),
+                phdr->p_filesz);
   }
 
   elf_end(inElf);
@@ -520,40 +654,38 @@ static void loadElf(TileAddress tile, const std::string &filename) {
   The SHIM row is always 0.
   SHIM resets are handled by the runtime.
 */
-static void configShimTile(TileOp &tileOp) {
+static void configShimTile(TileOp &tileOp, TileImage &image) {
   assert(tileOp.isShimTile() &&
          "The tile must be a Shim to generate Shim Config");
 
-  TileAddress tileAddress{tileOp};
-
   if (tileOp.isShimNOCTile())
-    tileAddress.clearRange(SHIM_DMA_BD_BASE, sizeof(ShimDMABDBlock));
+    image.clearRange(SHIM_DMA_BD_BASE, sizeof(ShimDMABDBlock));
 
-  tileAddress.clearRange(SHIM_SS_MASTER_BASE, sizeof(ShimSSMasterBlock));
-  tileAddress.clearRange(SHIM_SS_SLAVE_CFG_BASE, sizeof(ShimSSSlaveCfgBlock));
-  tileAddress.clearRange(SHIM_SS_SLAVE_SLOT_BASE, sizeof(ShimSSSlaveSlotBlock));
+  image.clearRange(SHIM_SS_MASTER_BASE, sizeof(ShimSSMasterBlock));
+  image.clearRange(SHIM_SS_SLAVE_CFG_BASE, sizeof(ShimSSSlaveCfgBlock));
+  image.clearRange(SHIM_SS_SLAVE_SLOT_BASE, sizeof(ShimSSSlaveSlotBlock));
 }
 
 /*
   Generate the config for an ME tile
 */
-static void configMETile(TileOp tileOp, const std::string &coreFilesDir) {
-  TileAddress tileAddress{tileOp};
+static void configMETile(TileOp tileOp, const std::string &coreFilesDir,
+                         TileImage &image) {
   // Reset configuration
 
   // clear program and data memory
-  tileAddress.clearRange(ME_PROG_MEM_BASE, PROG_MEM_SIZE);
-  tileAddress.clearRange(ME_DATA_MEM_BASE, DATA_MEM_SIZE);
+  image.clearRange(ME_PROG_MEM_BASE, PROG_MEM_SIZE);
+  image.clearRange(ME_DATA_MEM_BASE, DATA_MEM_SIZE);
 
   // TileDMA
-  tileAddress.clearRange(ME_DMA_BD_BASE, sizeof(DMABDRegBlock));
-  tileAddress.clearRange(ME_DMA_S2MM_BASE, sizeof(DMAS2MMRegBlock));
-  tileAddress.clearRange(ME_DMA_MM2S_BASE, sizeof(DMAMM2SRegBlock));
+  image.clearRange(ME_DMA_BD_BASE, sizeof(DMABDRegBlock));
+  image.clearRange(ME_DMA_S2MM_BASE, sizeof(DMAS2MMRegBlock));
+  image.clearRange(ME_DMA_MM2S_BASE, sizeof(DMAMM2SRegBlock));
 
   // Stream Switches
-  tileAddress.clearRange(ME_SS_MASTER_BASE, sizeof(MESSMasterBlock));
-  tileAddress.clearRange(ME_SS_SLAVE_CFG_BASE, sizeof(MESSSlaveCfgBlock));
-  tileAddress.clearRange(ME_SS_SLAVE_SLOT_BASE, sizeof(MESSSlaveSlotBlock));
+  image.clearRange(ME_SS_MASTER_BASE, sizeof(MESSMasterBlock));
+  image.clearRange(ME_SS_SLAVE_CFG_BASE, sizeof(MESSSlaveCfgBlock));
+  image.clearRange(ME_SS_SLAVE_SLOT_BASE, sizeof(MESSSlaveSlotBlock));
 
   // NOTE: Here is usually where locking is done.
   // However, the runtime will handle that when loading the airbin.
@@ -566,7 +698,7 @@ static void configMETile(TileOp tileOp, const std::string &coreFilesDir) {
     else
       fileName = llvm::formatv("{0}/core_{1}_{2}.elf", coreFilesDir,
                                tileOp.colIndex(), tileOp.rowIndex());
-    loadElf(tileAddress, fileName);
+    loadElf(image, fileName);
   }
 }
 
@@ -607,7 +739,7 @@ static BDInfo getBDInfo(Block &block) {
   return bdInfo;
 }
 
-static void configureDMAs(DeviceOp &targetOp) {
+static void configureDMAs(DeviceOp &targetOp, DeviceImage &image) {
   Field<1> dmaChannelReset;
   Field<0> dmaChannelEnable;
 
@@ -616,14 +748,14 @@ static void configureDMAs(DeviceOp &targetOp) {
     LLVM_DEBUG(llvm::dbgs() << "DMA: tile=" << memOp.getTile());
     // Clear the CTRL and QUEUE registers for the DMA channels.
     for (auto chNum = 0u; chNum < DMA_S2MM_CHANNEL_COUNT; ++chNum) {
-      write32({tile, regDMAS2MMCtrl(chNum)},
-              dmaChannelReset(DISABLE) | dmaChannelEnable(DISABLE));
-      write32({tile, regDMAS2MMQueue(chNum)}, 0);
+      image.write32({tile, regDMAS2MMCtrl(chNum)},
+                    dmaChannelReset(DISABLE) | dmaChannelEnable(DISABLE));
+      image.write32({tile, regDMAS2MMQueue(chNum)}, 0);
     }
     for (auto chNum = 0u; chNum < DMA_MM2S_CHANNEL_COUNT; ++chNum) {
-      write32({tile, regDMAMM2SCtrl(chNum)},
-              dmaChannelReset(DISABLE) | dmaChannelEnable(DISABLE));
-      write32({tile, regDMAMM2SQueue(chNum)}, 0);
+      image.write32({tile, regDMAMM2SCtrl(chNum)},
+                    dmaChannelReset(DISABLE) | dmaChannelEnable(DISABLE));
+      image.write32({tile, regDMAMM2SQueue(chNum)}, 0);
     }
 
     DenseMap<Block *, int> blockMap;
@@ -747,14 +879,14 @@ static void configureDMAs(DeviceOp &targetOp) {
         assert(bdNum < ME_DMA_BD_COUNT && "bdNum >= ME_DMA_BD_COUNT");
         uint64_t bdOffset = regDMAAddrABD(bdNum);
 
-        write32({tile, bdOffset}, bdData.addrA);
-        write32({tile, regDMAAddrBBD(bdNum)}, bdData.addrB);
-        write32({tile, regDMA2DXBD(bdNum)}, bdData.x2d);
-        write32({tile, regDMA2DYBD(bdNum)}, bdData.y2d);
-        write32({tile, regDMAPktBD(bdNum)}, bdData.packet);
-        write32({tile, regDMAIntStateBD(bdNum)}, bdData.interleave);
-        write32({tile, regDMACtrlBD(bdNum)},
-                bdData.control | bdControlValid(true));
+        image.write32({tile, bdOffset}, bdData.addrA);
+        image.write32({tile, regDMAAddrBBD(bdNum)}, bdData.addrB);
+        image.write32({tile, regDMA2DXBD(bdNum)}, bdData.x2d);
+        image.write32({tile, regDMA2DYBD(bdNum)}, bdData.y2d);
+        image.write32({tile, regDMAPktBD(bdNum)}, bdData.packet);
+        image.write32({tile, regDMAIntStateBD(bdNum)}, bdData.interleave);
+        image.write32({tile, regDMACtrlBD(bdNum)},
+                      bdData.control | bdControlValid(true));
       }
     }
 
@@ -766,15 +898,15 @@ static void configureDMAs(DeviceOp &targetOp) {
 
           uint32_t chNum = op.getChannelIndex();
           if (op.getChannelDir() == DMAChannelDir::MM2S) {
-            write32(Address{tile, regDMAMM2SQueue(chNum)},
-                    dmaChannelQueueStartBd(bdNum));
-            write32({tile, regDMAMM2SCtrl(chNum)},
-                    dmaChannelEnable(ENABLE) | dmaChannelReset(DISABLE));
+            image.write32(Address{tile, regDMAMM2SQueue(chNum)},
+                          dmaChannelQueueStartBd(bdNum));
+            image.write32({tile, regDMAMM2SCtrl(chNum)},
+                          dmaChannelEnable(ENABLE) | dmaChannelReset(DISABLE));
           } else {
-            write32(Address{tile, regDMAS2MMQueue(chNum)},
-                    dmaChannelQueueStartBd(bdNum));
-            write32({tile, regDMAS2MMCtrl(chNum)},
-                    dmaChannelEnable(ENABLE) | dmaChannelReset(DISABLE));
+            image.write32(Address{tile, regDMAS2MMQueue(chNum)},
+                          dmaChannelQueueStartBd(bdNum));
+            image.write32({tile, regDMAS2MMCtrl(chNum)},
+                          dmaChannelEnable(ENABLE) | dmaChannelReset(DISABLE));
           }
         }
       }
@@ -851,7 +983,7 @@ static uint8_t computeMasterPort(WireBundle bundle, int index, bool isShim) {
   }
 }
 
-static void configureSwitchBoxes(DeviceOp &targetOp) {
+static void configureSwitchBoxes(DeviceOp &targetOp, DeviceImage &image) {
   for (auto switchboxOp : targetOp.getOps<SwitchboxOp>()) {
     Region &r = switchboxOp.getConnections();
     Block &b = r.front();
@@ -891,13 +1023,14 @@ static void configureSwitchBoxes(DeviceOp &targetOp) {
                        streamMasterDropHeader(dropHeader) |
                        streamMasterConfig(slavePort);
           assert(value < UINT32_MAX);
-          write32(address, value);
+          image.write32(address, value);
         }
 
         // Configure slave side
         {
           Address address{tile, regMESSSlaveCfg(slavePort)};
-          write32(address, STREAM_ENABLE(true) | STREAM_PACKET_ENABLE(false));
+          image.write32(address,
+                        STREAM_ENABLE(true) | STREAM_PACKET_ENABLE(false));
         }
 
         for (auto connectOp : b.getOps<MasterSetOp>()) {
@@ -918,9 +1051,10 @@ static void configureSwitchBoxes(DeviceOp &targetOp) {
                         (mask << STREAM_SWITCH_MSEL_SHIFT) |
                         (arbiter << STREAM_SWITCH_ARB_SHIFT);
           Address dest{tile, regMESSMaster(masterPort)};
-          write32(dest, STREAM_ENABLE(ENABLE) | STREAM_PACKET_ENABLE(ENABLE) |
-                            streamMasterDropHeader(DROP_HEADER) |
-                            streamMasterConfig(config));
+          image.write32(dest, STREAM_ENABLE(ENABLE) |
+                                  STREAM_PACKET_ENABLE(ENABLE) |
+                                  streamMasterDropHeader(DROP_HEADER) |
+                                  streamMasterConfig(config));
         }
       }
     }
@@ -937,8 +1071,8 @@ static void configureSwitchBoxes(DeviceOp &targetOp) {
           auto slavePort =
               computeSlavePort(connectOp.getSourceBundle(),
                                connectOp.sourceIndex(), tile.isShim());
-          write32({tile, regMESSSlaveCfg(slavePort)},
-                  STREAM_ENABLE(ENABLE) | STREAM_PACKET_ENABLE(ENABLE));
+          image.write32({tile, regMESSSlaveCfg(slavePort)},
+                        STREAM_ENABLE(ENABLE) | STREAM_PACKET_ENABLE(ENABLE));
 
           Field<28, 24> streamSlotId;
           Field<20, 16> streamSlotMask;
@@ -950,7 +1084,7 @@ static void configureSwitchBoxes(DeviceOp &targetOp) {
                         streamSlotMask(slotOp.maskInt()) |
                         streamSlotEnable(ENABLE) | streamSlotMSel(msel) |
                         streamSlotArbit(arbiter);
-          write32({tile, regMESSSlaveSlot(slavePort, slot)}, config);
+          image.write32({tile, regMESSSlaveSlot(slavePort, slot)}, config);
           slot++;
         }
       }
@@ -1007,8 +1141,9 @@ static void configureSwitchBoxes(DeviceOp &targetOp) {
 
         // We need to add to the possibly preexisting mask.
         Address addr{currentTile.value(), 0x1F004u};
-        auto currentMask = read32(addr);
-        write32(addr, currentMask |
+        auto currentMask = image.read32(addr);
+        image.write32(addr,
+                      currentMask |
                           INPUT_MASK_FOR(connectOp.getDestBundle(), shiftAmt));
       } else if (connectOp.getDestBundle() == WireBundle::North) {
         // mux
@@ -1033,8 +1168,9 @@ static void configureSwitchBoxes(DeviceOp &targetOp) {
         }();
 
         Address addr{currentTile.value(), 0x1F000u};
-        auto currentMask = read32(addr);
-        write32(addr, currentMask | INPUT_MASK_FOR(connectOp.getSourceBundle(),
+        auto currentMask = image.read32(addr);
+        image.write32(addr,
+                      currentMask | INPUT_MASK_FOR(connectOp.getSourceBundle(),
                                                    shiftAmt));
       }
     }
@@ -1059,8 +1195,8 @@ static void configureSwitchBoxes(DeviceOp &targetOp) {
   */
 }
 
-static void configureCascade(DeviceOp &targetOp) {
-  const auto &target_model = xilinx::AIE::getTargetModel(targetOp);
+static void configureCascade(DeviceOp &targetOp, DeviceImage &image) {
+  const auto &targetModel = xilinx::AIE::getTargetModel(targetOp);
   if (isa<AIE2TargetModel>(targetModel)) {
     for (auto configOp : targetOp.getOps<ConfigureCascadeOp>()) {
       TileOp tile = cast<TileOp>(configOp.getTile().getDefiningOp());
@@ -1081,7 +1217,7 @@ static void configureCascade(DeviceOp &targetOp) {
 
       auto regValue = Output(outputValue) | Input(inputValue);
 
-      write32(address, regValue);
+      image.write32(address, regValue);
     }
   }
 }
@@ -1116,35 +1252,11 @@ static uint8_t secAddr2Index(uint64_t in) {
   }
 }
 
-/*
-        Group the writes into contiguous sections
-*/
-static void groupSections(std::vector<Section *> &sections) {
-  uint64_t lastAddr = 0;
-  Section *section = nullptr;
-
-  for (auto write : memWrites) {
-    if (write.first != lastAddr + 4) {
-      if (section)
-        sections.push_back(section);
-      section = new Section(write.first);
-      LLVM_DEBUG(llvm::dbgs() << "Starting new section @ "
-                              << llvm::format("0x%lx (last=0x%lx)\n",
-                                              write.first, lastAddr));
-    }
-    assert(section && "section is null");
-    section->addData(write.second);
-    lastAddr = write.first;
-  }
-
-  sections.push_back(section);
-}
-
 /*
    Add a string to the section header string table and return the offset of
-   the start of the string
+   the start of the string. `stridx` is the size of the table so far.
 */
-static size_t addString(Elf_Scn *scn, const char *str) {
+static size_t addString(Elf_Scn *scn, const char *str, size_t &stridx) {
   size_t lastidx = stridx;
   size_t size = strlen(str) + 1;
 
@@ -1159,22 +1271,21 @@ static size_t addString(Elf_Scn *scn, const char *str) {
   return lastidx;
 }
 
-Elf_Data *sectionAddData(Elf_Scn *scn, const Section *section) {
-  size_t size = section->getLength();
-  auto *buf = static_cast<uint32_t *>(malloc(size));
+/*
+   The section must outlive the ELF, as its data is not copied
+*/
+static Elf_Data *sectionAddData(Elf_Scn *scn, const Section &section) {
+  size_t size = section.getLength();
 
   // create a data object for the section
   Elf_Data *data = elf_newdata(scn);
-  data->d_buf = buf;
+  data->d_buf = const_cast<uint32_t *>(section.getData());
   data->d_type = ELF_T_BYTE;
   data->d_size = size;
   data->d_off = 0;
   data->d_align = 1;
   data->d_version = EV_CURRENT;
 
-  // fill the data
-  memcpy(buf, section->getData(), size);
-
   return data;
 }
 
@@ -1190,7 +1301,9 @@ mlir::LogicalResult AIETranslateToAirbin(mlir::ModuleOp module,
   GElf_Shdr shdrMem;
   char emptyStr[] = "";
   char strTabName[] = ".shstrtab";
-  std::vector<Section *> sections;
+  uint8_t secNameOffset[SEC_IDX_MAX];
+  size_t stridx = 0;
+  DeviceImage image;
 
   if (module.getOps<DeviceOp>().empty()) {
     LLVM_DEBUG(llvm::dbgs() << "no device ops found");
@@ -1199,24 +1312,31 @@ mlir::LogicalResult AIETranslateToAirbin(mlir::ModuleOp module,
 
   DeviceOp targetOp = *(module.getOps<DeviceOp>().begin());
 
+  elf_version(EV_CURRENT);
+
   // Write the initial configuration for every tile specified in the MLIR.
-  for (auto tileOp : targetOp.getOps<TileOp>()) {
+  // Each tile only writes to its own image, so the tiles, and the core ELFs
+  // they load, are processed in parallel.
+  SmallVector<std::pair<TileOp, TileImage *>> tiles;
+  for (auto tileOp : targetOp.getOps<TileOp>())
+    tiles.push_back({tileOp, &image.getTile(tileOp)});
+  parallelForEach(module.getContext(), tiles, [&](auto &tile) {
+    auto [tileOp, tileImage] = tile;
     LLVM_DEBUG(llvm::dbgs() << "CC: tile=" << tileOp.getTileID());
     if (tileOp.isShimTile())
-      configShimTile(tileOp);
+      configShimTile(tileOp, *tileImage);
     else
-      configMETile(tileOp, coreFilesDir);
-  }
+      configMETile(tileOp, coreFilesDir, *tileImage);
+  });
 
-  configureSwitchBoxes(targetOp);
-  configureCascade(targetOp);
-  configureDMAs(targetOp);
-  groupSections(sections);
+  configureSwitchBoxes(targetOp, image);
+  configureCascade(targetOp, image);
+  configureDMAs(targetOp, image);
+  std::vector<Section> sections = image.groupSections(module.getContext());
 
   LLVM_DEBUG(llvm::dbgs() << llvm::format("mem_writes: %lu in %lu sections\n",
-                                          memWrites.size(), sections.size()));
+                                          image.numWrites(), sections.size()));
 
-  elf_version(EV_CURRENT);
   tmpElfFD =
       open(outputFilename.c_str(), O_RDWR | O_CREAT | O_TRUNC, DEFFILEMODE);
   outElf = elf_begin(tmpElfFD, ELF_C_WRITE, nullptr);
@@ -1247,7 +1367,7 @@ mlir::LogicalResult AIETranslateToAirbin(mlir::ModuleOp module,
         llvm::Twine("cannot create new shstrtab section: ") + elf_errmsg(-1));
 
   // the first entry in the string table must be a NULL string
-  addString(shStrTabScn, emptyStr);
+  addString(shStrTabScn, emptyStr, stridx);
 
   shdr = gelf_getshdr(shStrTabScn, &shdrMem);
   if (!shdr)
@@ -1262,11 +1382,12 @@ mlir::LogicalResult AIETranslateToAirbin(mlir::ModuleOp module,
   shdr->sh_info = SHN_UNDEF;
   shdr->sh_addralign = 1;
   shdr->sh_entsize = 0;
-  shdr->sh_name = addString(shStrTabScn, strTabName);
+  shdr->sh_name = addString(shStrTabScn, strTabName, stridx);
 
   // add all the AIRBIN-specific section names up front and index them
   for (uint8_t secIdx = SEC_IDX_SSMAST; secIdx < SEC_IDX_MAX; secIdx++)
-    secNameOffset[secIdx] = addString(shStrTabScn, secNameStr[secIdx]);
+    secNameOffset[secIdx] =
+        addString(shStrTabScn, secNameStr[secIdx], stridx);
   secNameOffset[SEC_IDX_NULL] = 0;
 
   // We have to store the section strtab index in the ELF header so sections
@@ -1285,8 +1406,8 @@ mlir::LogicalResult AIETranslateToAirbin(mlir::ModuleOp module,
         elf_errmsg(-1));
 
   // output the rest of the sections
-  for (const Section *section : sections) {
-    uint64_t addr = section->getAddr();
+  for (const Section &section : sections) {
+    uint64_t addr = section.getAddr();
     Elf_Scn *scn = elf_newscn(outElf);
     if (!scn)
       llvm::report_fatal_error(llvm::Twine("cannot create new ") +
@@ -1303,7 +1424,7 @@ mlir::LogicalResult AIETranslateToAirbin(mlir::ModuleOp module,
 
     shdr->sh_type = SHT_PROGBITS;
     shdr->sh_flags = SHF_ALLOC;
-    shdr->sh_addr = section->getAddr();
+    shdr->sh_addr = section.getAddr();
     shdr->sh_link = SHN_UNDEF;
     shdr->sh_info = SHN_UNDEF;
     shdr->sh_addralign = 1;
@@ -18,8 +18,12 @@
 
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Support/Endian.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/SwapByteOrder.h"
 
+#include <array>
+#include <cstring>
 #include <vector>
 
 using namespace mlir;
@@ -49,9 +53,84 @@ reserveAndGetTail(std::vector<uint32_t> &instructions, uint64_t tailSize) {
                                          tailSize);
 }
 
-void appendSync(std::vector<uint32_t> &instructions, NpuSyncOp op) {
+// Receives the words of a transaction stream in order. The whole stream is
+// sized before the first word is written.
+class InstructionSink {
+public:
+  virtual ~InstructionSink() = default;
+  virtual void append(llvm::ArrayRef<uint32_t> words) = 0;
+  // Append words given in their little-endian byte representation.
+  virtual void appendBytes(llvm::ArrayRef<char> bytes) {
+    for (size_t i = 0; i < bytes.size(); i += sizeof(uint32_t)) {
+      uint32_t word = llvm::support::endian::read32le(bytes.data() + i);
+      append(word);
+    }
+  }
+};
+
+// Block write payloads are only passed as bytes on little-endian hosts, where
+// they are also the in-memory representation of the words, so sinks storing
+// words in host order can copy them as is.
+class VectorSink : public InstructionSink {
+public:
+  VectorSink(std::vector<uint32_t> &instructions, uint64_t numWords)
+      : instructions(instructions) {
+    instructions.reserve(instructions.size() + numWords);
+  }
+  void append(llvm::ArrayRef<uint32_t> words) override {
+    instructions.insert(instructions.end(), words.begin(), words.end());
+  }
+  void appendBytes(llvm::ArrayRef<char> bytes) override {
+    auto tail =
+        reserveAndGetTail(instructions, bytes.size() / sizeof(uint32_t));
+    std::memcpy(tail.data(), bytes.data(), bytes.size());
+  }
 
-  auto words = reserveAndGetTail(instructions, 4);
+private:
+  std::vector<uint32_t> &instructions;
+};
+
+class BinaryStreamSink : public InstructionSink {
+public:
+  BinaryStreamSink(raw_ostream &output) : output(output) {}
+  void append(llvm::ArrayRef<uint32_t> words) override {
+    output.write(reinterpret_cast<const char *>(words.data()),
+                 words.size() * sizeof(uint32_t));
+  }
+  void appendBytes(llvm::ArrayRef<char> bytes) override {
+    output.write(bytes.data(), bytes.size());
+  }
+
+private:
+  raw_ostream &output;
+};
+
+class TextStreamSink : public InstructionSink {
+public:
+  TextStreamSink(raw_ostream &output) : output(output) {}
+  void append(llvm::ArrayRef<uint32_t> words) override {
+    for (auto w : words)
+      output << llvm::format("%08X\n", w);
+  }
+
+private:
+  raw_ostream &output;
+};
+
+uint32_t getTileAddress(Operation *op, uint32_t address,
+                        std::optional<uint32_t> col,
+                        std::optional<uint32_t> row) {
+  if (col && row) {
+    const AIETargetModel &tm = op->getParentOfType<DeviceOp>().getTargetModel();
+    address = ((*col & 0xff) << tm.getColumnShift()) |
+              ((*row & 0xff) << tm.getRowShift()) | (address & 0xFFFFF);
+  }
+  return address;
+}
+
+void appendSync(InstructionSink &sink, NpuSyncOp op) {
+
+  std::array<uint32_t, 4> words = {};
 
   // XAIE_IO_CUSTOM_OP_TCT
   words[0] = TXN_OPC_TCT;
@@ -65,58 +144,38 @@ void appendSync(std::vector<uint32_t> &instructions, NpuSyncOp op) {
   words[3] |= (op.getRowNum() & 0xff) << 8;
   words[3] |= (op.getColumnNum() & 0xff) << 16;
   words[3] |= (op.getChannel() & 0xff) << 24;
-}
 
-void appendWrite32(std::vector<uint32_t> &instructions, NpuWrite32Op op) {
+  sink.append(words);
+}
 
-  auto words = reserveAndGetTail(instructions, 3);
+void appendWrite32(InstructionSink &sink, NpuWrite32Op op) {
 
-  if (op.getBuffer()) {
-    op.emitOpError("Cannot translate symbolic address");
-    return;
-  }
+  std::array<uint32_t, 3> words = {};
 
   // XAIE_IO_WRITE
   words[0] = TXN_OPC_WRITE;
-  words[1] = op.getAddress();
-  auto col = op.getColumn();
-  auto row = op.getRow();
-  if (col && row) {
-    const AIETargetModel &tm = op->getParentOfType<DeviceOp>().getTargetModel();
-    words[1] = ((*col & 0xff) << tm.getColumnShift()) |
-               ((*row & 0xff) << tm.getRowShift()) | (words[1] & 0xFFFFF);
-  }
+  words[1] = getTileAddress(op, op.getAddress(), op.getColumn(), op.getRow());
   words[2] = op.getValue(); // Value
-}
 
-void appendMaskWrite32(std::vector<uint32_t> &instructions,
-                       NpuMaskWrite32Op op) {
+  sink.append(words);
+}
 
-  auto words = reserveAndGetTail(instructions, 4);
+void appendMaskWrite32(InstructionSink &sink, NpuMaskWrite32Op op) {
 
-  if (op.getBuffer()) {
-    op.emitOpError("Cannot translate symbolic address");
-    return;
-  }
+  std::array<uint32_t, 4> words = {};
 
   // XAIE_IO_MASKWRITE
   words[0] = TXN_OPC_MASKWRITE;
-  words[1] = op.getAddress();
-  auto col = op.getColumn();
-  auto row = op.getRow();
-  if (col && row) {
-    const AIETargetModel &tm = op->getParentOfType<DeviceOp>().getTargetModel();
-    words[1] = ((*col & 0xff) << tm.getColumnShift()) |
-               ((*row & 0xff) << tm.getRowShift()) | (words[1] & 0xFFFFF);
-  }
+  words[1] = getTileAddress(op, op.getAddress(), op.getColumn(), op.getRow());
   words[2] = op.getValue(); // Value
   words[3] = op.getMask();
+
+  sink.append(words);
 }
 
-void appendAddressPatch(std::vector<uint32_t> &instructions,
-                        NpuAddressPatchOp op) {
+void appendAddressPatch(InstructionSink &sink, NpuAddressPatchOp op) {
 
-  auto words = reserveAndGetTail(instructions, 6);
+  std::array<uint32_t, 6> words = {};
 
   // XAIE_IO_CUSTOM_OP_DDR_PATCH
   words[0] = TXN_OPC_DDR_PATCH;
@@ -128,129 +187,196 @@ void appendAddressPatch(std::vector<uint32_t> &instructions,
 
   words[4] = op.getArgPlus();
   words[5] = 0;
+
+  sink.append(words);
 }
 
-void appendBlockWrite(std::vector<uint32_t> &instructions, NpuBlockWriteOp op) {
+// Returns the payload of a block write.
+FailureOr<DenseIntElementsAttr> getBlockWriteData(NpuBlockWriteOp op) {
 
   Value memref = op.getData();
   int64_t width = cast<MemRefType>(memref.getType()).getElementTypeBitWidth();
-  if (width != 32) {
-    op.emitWarning("Only 32-bit data type is supported for now");
-    return;
-  }
+  if (width != 32)
+    return op.emitError("Only 32-bit data type is supported for now");
 
   memref::GetGlobalOp getGlobal = memref.getDefiningOp<memref::GetGlobalOp>();
-  if (!getGlobal) {
-    op.emitError("Only MemRefs from memref.get_global are supported");
-    return;
-  }
+  if (!getGlobal)
+    return op.emitError("Only MemRefs from memref.get_global are supported");
 
   auto global = dyn_cast_if_present<memref::GlobalOp>(
       op->getParentOfType<AIE::DeviceOp>().lookupSymbol(getGlobal.getName()));
-  if (!global) {
-    op.emitError("Global symbol not found");
-    return;
-  }
+  if (!global)
+    return op.emitError("Global symbol not found");
 
   auto initVal = global.getInitialValue();
-  if (!initVal) {
-    op.emitError("Global symbol has no initial value");
-    return;
-  }
+  if (!initVal)
+    return op.emitError("Global symbol has no initial value");
 
   auto data = dyn_cast<DenseIntElementsAttr>(*initVal);
-  if (!data) {
-    op.emitError("Global symbol initial value is not a dense int array");
-    return;
-  }
+  if (!data)
+    return op.emitError("Global symbol initial value is not a dense int array");
+
+  return data;
+}
+
+void appendBlockWrite(InstructionSink &sink, NpuBlockWriteOp op,
+                      DenseIntElementsAttr data) {
 
-  auto words = reserveAndGetTail(instructions, data.size() + 3);
+  std::array<uint32_t, 3> words = {};
 
   // XAIE_IO_BLOCKWRITE
   words[0] = TXN_OPC_BLOCKWRITE;
-  words[1] = op.getAddress();
-  auto col = op.getColumn();
-  auto row = op.getRow();
-  if (col && row) {
-    const AIETargetModel &tm = op->getParentOfType<DeviceOp>().getTargetModel();
-    words[1] = ((*col & 0xff) << tm.getColumnShift()) |
-               ((*row & 0xff) << tm.getRowShift()) | (words[1] & 0xFFFFF);
-  }
-  words[2] = words.size() * sizeof(uint32_t); // Operation Size
+  words[1] = getTileAddress(op, op.getAddress(), op.getColumn(), op.getRow());
+  words[2] = (data.size() + words.size()) * sizeof(uint32_t); // Operation Size
+
+  sink.append(words);
 
-  unsigned i = 3;
-  for (auto d : data)
-    words[i++] = d.getZExtValue();
+  // Copy the payload in bulk when the attribute stores one 32-bit word per
+  // element in host order; otherwise go element by element.
+  if (llvm::sys::IsLittleEndianHost && !data.isSplat() &&
+      data.getElementType().getIntOrFloatBitWidth() == 32) {
+    sink.appendBytes(data.getRawData());
+    return;
+  }
+  for (auto d : data) {
+    uint32_t word = d.getZExtValue();
+    sink.append(word);
+  }
 }
 
-} // namespace
+// A transaction op of the stream together with its size in words.
+struct TransactionOp {
+  Operation *op;
+  uint64_t numWords;
+  // payload of a block write
+  DenseIntElementsAttr data;
+};
+
+// Collect the transaction ops of the selected runtime sequences and size
+// them, so that the header can be written before the ops are translated.
+FailureOr<SmallVector<TransactionOp>>
+collectTransactionOps(DeviceOp deviceOp, StringRef sequenceName) {
+  SmallVector<TransactionOp> txnOps;
+  auto sequenceOps = deviceOp.getOps<AIEX::RuntimeSequenceOp>();
+  for (auto seq : sequenceOps) {
+    if (sequenceName.size() && sequenceName != seq.getSymName())
+      continue;
+    Block &entry = seq.getBody().front();
+    for (auto &o : entry) {
+      LogicalResult result =
+          llvm::TypeSwitch<Operation *, LogicalResult>(&o)
+              .Case<NpuSyncOp>([&](auto op) {
+                txnOps.push_back({op, 4, {}});
+                return success();
+              })
+              .Case<NpuWrite32Op>([&](auto op) -> LogicalResult {
+                if (op.getBuffer())
+                  return op.emitOpError("Cannot translate symbolic address");
+                txnOps.push_back({op, 3, {}});
+                return success();
+              })
+              .Case<NpuMaskWrite32Op>([&](auto op) -> LogicalResult {
+                if (op.getBuffer())
+                  return op.emitOpError("Cannot translate symbolic address");
+                txnOps.push_back({op, 4, {}});
+                return success();
+              })
+              .Case<NpuBlockWriteOp>([&](auto op) -> LogicalResult {
+                auto data = getBlockWriteData(op);
+                if (failed(data))
+                  return failure();
+                txnOps.push_back(
+                    {op, static_cast<uint64_t>(data->size()) + 3, *data});
+                return success();
+              })
+              .Case<NpuAddressPatchOp>([&](auto op) {
+                txnOps.push_back({op, 6, {}});
+                return success();
+              })
+              .Default([](Operation *) { return success(); });
+      if (failed(result))
+        return failure();
+    }
+  }
+  return txnOps;
+}
 
-LogicalResult
-xilinx::AIE::AIETranslateToNPU(ModuleOp module,
-                               std::vector<uint32_t> &instructions,
-                               StringRef sequenceName) {
+// Size in words of the transaction header.
+constexpr uint64_t TXN_HEADER_WORDS = 4;
 
-  auto words = reserveAndGetTail(instructions, 4);
+uint64_t getTransactionSize(ArrayRef<TransactionOp> txnOps) {
+  uint64_t numWords = TXN_HEADER_WORDS;
+  for (const auto &txnOp : txnOps)
+    numWords += txnOp.numWords;
+  return numWords;
+}
 
-  DeviceOp deviceOp = *module.getOps<DeviceOp>().begin();
+void appendTransaction(InstructionSink &sink, DeviceOp deviceOp,
+                       ArrayRef<TransactionOp> txnOps) {
   const AIETargetModel &tm = deviceOp.getTargetModel();
 
   // setup txn header
+  std::array<uint32_t, TXN_HEADER_WORDS> words = {};
   uint8_t major = 1;
   uint8_t minor = 0;
   uint8_t devGen = 3;
   uint8_t numRows = tm.rows();
   uint8_t numCols = tm.columns();
   uint8_t numMemTileRows = tm.getNumMemTileRows();
-  uint32_t count = 0;
   words[0] = (numRows << 24) | (devGen << 16) | (minor << 8) | major;
   words[1] = (numMemTileRows << 8) | numCols;
-
-  auto sequenceOps = deviceOp.getOps<AIEX::RuntimeSequenceOp>();
-  for (auto seq : sequenceOps) {
-    if (sequenceName.size() && sequenceName != seq.getSymName())
-      continue;
-    Block &entry = seq.getBody().front();
-    for (auto &o : entry) {
-      llvm::TypeSwitch<Operation *>(&o)
-          .Case<NpuSyncOp>([&](auto op) {
-            count++;
-            appendSync(instructions, op);
-          })
-          .Case<NpuWrite32Op>([&](auto op) {
-            count++;
-            appendWrite32(instructions, op);
-          })
-          .Case<NpuBlockWriteOp>([&](auto op) {
-            count++;
-            appendBlockWrite(instructions, op);
-          })
-          .Case<NpuMaskWrite32Op>([&](auto op) {
-            count++;
-            appendMaskWrite32(instructions, op);
-          })
-          .Case<NpuAddressPatchOp>([&](auto op) {
-            count++;
-            appendAddressPatch(instructions, op);
-          });
-    }
+  words[2] = txnOps.size();
+  words[3] = getTransactionSize(txnOps) * sizeof(uint32_t); // size of the txn
+  sink.append(words);
+
+  for (const auto &txnOp : txnOps) {
+    llvm::TypeSwitch<Operation *>(txnOp.op)
+        .Case<NpuSyncOp>([&](auto op) { appendSync(sink, op); })
+        .Case<NpuWrite32Op>([&](auto op) { appendWrite32(sink, op); })
+        .Case<NpuBlockWriteOp>(
+            [&](auto op) { appendBlockWrite(sink, op, txnOp.data); })
+        .Case<NpuMaskWrite32Op>([&](auto op) { appendMaskWrite32(sink, op); })
+        .Case<NpuAddressPatchOp>(
+            [&](auto op) { appendAddressPatch(sink, op); });
   }
+}
+
+} // namespace
 
-  // write size fields of the txn header
-  instructions[2] = count;
-  instructions[3] = instructions.size() * sizeof(uint32_t); // size of the txn
+LogicalResult
+xilinx::AIE::AIETranslateToNPU(ModuleOp module,
+                               std::vector<uint32_t> &instructions,
+                               StringRef sequenceName) {
+  DeviceOp deviceOp = *module.getOps<DeviceOp>().begin();
+  auto txnOps = collectTransactionOps(deviceOp, sequenceName);
+  if (failed(txnOps))
+    return failure();
+  VectorSink sink(instructions, getTransactionSize(*txnOps));
+  appendTransaction(sink, deviceOp, *txnOps);
   return success();
 }
 
 LogicalResult xilinx::AIE::AIETranslateToNPU(ModuleOp module,
                                              raw_ostream &output,
                                              StringRef sequenceName) {
-  std::vector<uint32_t> instructions;
-  auto r = AIETranslateToNPU(module, instructions, sequenceName);
-  if (failed(r))
-    return r;
-  for (auto w : instructions)
-    output << llvm::format("%08X\n", w);
+  DeviceOp deviceOp = *module.getOps<DeviceOp>().begin();
+  auto txnOps = collectTransactionOps(deviceOp, sequenceName);
+  if (failed(txnOps))
+    return failure();
+  TextStreamSink sink(output);
+  appendTransaction(sink, deviceOp, *txnOps);
+  return success();
+}
+
+LogicalResult xilinx::AIE::AIETranslateToNPUBinary(ModuleOp module,
+                                                   raw_ostream &output,
+                                                   StringRef sequenceName) {
+  DeviceOp deviceOp = *module.getOps<DeviceOp>().begin();
+  auto txnOps = collectTransactionOps(deviceOp, sequenceName);
+  if (failed(txnOps))
+    return failure();
+  BinaryStreamSink sink(output);
+  appendTransaction(sink, deviceOp, *txnOps);
   return success();
 }
 
@@ -31,6 +31,7 @@
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/JSON.h"
+#include "llvm/Support/Path.h"
 
 #include <set>
 
@@ -110,6 +111,32 @@ LogicalResult AIETranslateToTargetArch(ModuleOp module, raw_ostream &output) {
   return success();
 }
 
+// Writes the output of `translate` for every core of the design to
+// <dir>/core_<col>_<row>.<ext>.
+static LogicalResult translatePerCore(
+    ModuleOp module, StringRef dir, StringRef ext,
+    llvm::function_ref<LogicalResult(ModuleOp, raw_ostream &, int, int)>
+        translate) {
+  if (module.getOps<DeviceOp>().empty())
+    return module.emitOpError("expected AIE.device operation at toplevel");
+  DeviceOp targetOp = *(module.getOps<DeviceOp>().begin());
+  for (auto coreOp : targetOp.getOps<CoreOp>()) {
+    int col = coreOp.colIndex();
+    int row = coreOp.rowIndex();
+    SmallString<128> path(dir);
+    llvm::sys::path::append(path, "core_" + std::to_string(col) + "_" +
+                                      std::to_string(row) + "." + ext);
+    std::error_code ec;
+    llvm::raw_fd_ostream os(path, ec);
+    if (ec)
+      return module.emitError("unable to write ") << path << ": "
+                                                  << ec.message();
+    if (failed(translate(module, os, col, row)))
+      return failure();
+  }
+  return success();
+}
+
 void registerAIETranslations() {
   static llvm::cl::opt<int> tileCol(
       "tilecol", llvm::cl::desc("column coordinate of core to translate"),
@@ -259,6 +286,23 @@ void registerAIETranslations() {
       },
       registerDialects);
 
+  TranslateFromMLIRRegistration registrationLDScripts(
+      "aie-generate-ldscripts",
+      "Generate the AIE loader script of every core into work-dir-path",
+      [](ModuleOp module, raw_ostream &) {
+        return translatePerCore(module, workDirPath, "ld.script",
+                                AIETranslateToLdScript);
+      },
+      registerDialects);
+
+  TranslateFromMLIRRegistration registrationBCFs(
+      "aie-generate-bcfs",
+      "Generate the AIE bcf of every core into work-dir-path",
+      [](ModuleOp module, raw_ostream &) {
+        return translatePerCore(module, workDirPath, "bcf", AIETranslateToBCF);
+      },
+      registerDialects);
+
   TranslateFromMLIRRegistration registrationTargetArch(
       "aie-generate-target-arch", "Get the target architecture",
       AIETranslateToTargetArch, registerDialects);
@@ -346,15 +390,8 @@ void registerAIETranslations() {
   TranslateFromMLIRRegistration registrationNPU(
       "aie-npu-instgen", "Translate npu instructions to binary",
       [](ModuleOp module, raw_ostream &output) {
-        if (outputBinary == true) {
-          std::vector<uint32_t> instructions;
-          auto r = AIETranslateToNPU(module, instructions, sequenceName);
-          if (failed(r))
-            return r;
-          output.write(reinterpret_cast<const char *>(instructions.data()),
-                       instructions.size() * sizeof(uint32_t));
-          return success();
-        }
+        if (outputBinary == true)
+          return AIETranslateToNPUBinary(module, output, sequenceName);
         return AIETranslateToNPU(module, output, sequenceName);
       },
       registerDialects);
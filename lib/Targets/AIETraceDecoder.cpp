@@ -0,0 +1,305 @@
+//===- AIETraceDecoder.cpp --------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc. All rights reserved.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Targets/AIETraceDecoder.h"
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIEX/IR/AIEXDialect.h"
+
+#include "llvm/ADT/bit.h"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+namespace {
+
+// The kinds of events of python/utils/trace_events_enum.py.
+enum class EventKind { Core, Mem, PL, MemTile };
+
+struct TraceEvent {
+  EventKind kind;
+  uint32_t code;
+  const char *name;
+};
+
+const TraceEvent traceEvents[] = {
+#define AIE_TRACE_EVENT(Kind, Name, Code) {EventKind::Kind, Code, #Name},
+#include "aie/Targets/AIETraceEvents.inc"
+};
+
+// Every 8th word of the trace is the header of a packet of 7 words.
+constexpr uint64_t kPacketWords = 8;
+// Words filling the end of a packet.
+constexpr uint32_t kPaddingWord = 0xA5A5A5A5;
+
+// Returns true if `word` has the odd parity and the clear reserved bits of a
+// packet header.
+bool isPacketHeader(uint32_t word) {
+  return llvm::popcount(word) % 2 == 1 && !((word >> 5) & 0x7F) &&
+         !((word >> 19) & 0x1) && !((word >> 28) & 0x7);
+}
+
+// Returns the number of bytes of the command starting with `byte`.
+unsigned getCommandLength(uint8_t byte) {
+  if ((byte & 0xFB) == 0xF0) // Start
+    return 8;
+  if ((byte & 0xFC) == 0xDC) // Reserved
+    return 4;
+  if ((byte & 0x80) == 0x00) // Single0
+    return 1;
+  if ((byte & 0xE0) == 0x80) // Single1
+    return 2;
+  if ((byte & 0xE0) == 0xA0) // Single2
+    return 3;
+  if ((byte & 0xF0) == 0xC0) // Multiple0
+    return 2;
+  if ((byte & 0xFC) == 0xD0) // Multiple1
+    return 3;
+  if ((byte & 0xFC) == 0xD4) // Multiple2
+    return 4;
+  if ((byte & 0xF0) == 0xE0) // Repeat0
+    return 1;
+  if ((byte & 0xFC) == 0xD8) // Repeat1
+    return 2;
+  // Filler, event sync and unknown bytes.
+  return 1;
+}
+
+const char *getTraceName(TracePacketType type) {
+  switch (type) {
+  case TracePacketType::Core:
+    return "core_trace";
+  case TracePacketType::Mem:
+    return "mem_trace";
+  case TracePacketType::Shim:
+    return "intfc_trace";
+  case TracePacketType::MemTile:
+    return "memtile_trace";
+  }
+  llvm_unreachable("unknown trace packet type");
+}
+
+} // namespace
+
+StringRef xilinx::AIE::getTraceEventName(TracePacketType type, uint32_t code) {
+  EventKind kind;
+  switch (type) {
+  case TracePacketType::Core:
+    kind = EventKind::Core;
+    break;
+  case TracePacketType::Mem:
+    kind = EventKind::Mem;
+    break;
+  case TracePacketType::Shim:
+    kind = EventKind::PL;
+    break;
+  case TracePacketType::MemTile:
+    kind = EventKind::MemTile;
+    break;
+  }
+  for (const TraceEvent &event : traceEvents)
+    if (event.kind == kind && event.code == code)
+      return event.name;
+  return "Unknown";
+}
+
+bool TraceDecoder::configure(int col, int row, uint32_t address,
+                             uint32_t value) {
+  assert(!started && "events must be configured before decoding");
+  // The Trace_Event0 and Trace_Event1 registers of the AIE2 register maps.
+  TracePacketType type;
+  switch (address & ~0x4u) {
+  case 0x340E0:
+    type = row == 0 ? TracePacketType::Shim : TracePacketType::Core;
+    break;
+  case 0x140E0:
+    type = TracePacketType::Mem;
+    break;
+  case 0x940E0:
+    type = TracePacketType::MemTile;
+    break;
+  default:
+    return false;
+  }
+
+  TileID tile = {col, row};
+  auto &stream = streams[static_cast<unsigned>(type)]
+                     .try_emplace(tile, Stream{type, tile})
+                     .first->second;
+  unsigned first = address & 0x4u ? kNumTraceSlots / 2 : 0;
+  for (unsigned i = 0; i < kNumTraceSlots / 2; i++)
+    stream.events[first + i] = (value >> (8 * i)) & 0xFF;
+  return true;
+}
+
+void TraceDecoder::configure(ModuleOp module, int colShift) {
+  module.walk([&](AIEX::NpuWrite32Op op) {
+    if (op.getBuffer())
+      return;
+    uint32_t address = op.getAddress();
+    if (op.getColumn() && op.getRow()) {
+      configure(*op.getColumn() + colShift, *op.getRow(), address,
+                op.getValue());
+      return;
+    }
+    // Without a tile, the address is one in the whole array.
+    auto device = op->getParentOfType<DeviceOp>();
+    if (!device)
+      return;
+    const AIETargetModel &tm = device.getTargetModel();
+    uint32_t rowShift = tm.getRowShift();
+    uint32_t colShiftBits = tm.getColumnShift();
+    int col = address >> colShiftBits;
+    int row = (address >> rowShift) & ((1u << (colShiftBits - rowShift)) - 1);
+    configure(col + colShift, row, address & ((1u << rowShift) - 1),
+              op.getValue());
+  });
+}
+
+void TraceDecoder::writeMetadata() {
+  json.arrayBegin();
+  unsigned pid = 0;
+  for (auto &typeStreams : streams) {
+    for (auto &[tile, stream] : typeStreams) {
+      stream.pid = pid++;
+      for (unsigned slot = 0; slot < kNumTraceSlots; slot++)
+        stream.eventNames[slot] =
+            getTraceEventName(stream.type, stream.events[slot]);
+      json.object([&] {
+        json.attribute("name", "process_name");
+        json.attribute("ph", "M");
+        json.attribute("pid", stream.pid);
+        json.attributeObject("args", [&] {
+          json.attribute("name", (llvm::Twine(getTraceName(stream.type)) +
+                                  " for tile" + llvm::Twine(tile.row) + "," +
+                                  llvm::Twine(tile.col))
+                                     .str());
+        });
+      });
+      for (unsigned slot = 0; slot < kNumTraceSlots; slot++) {
+        json.object([&] {
+          json.attribute("name", "thread_name");
+          json.attribute("ph", "M");
+          json.attribute("pid", stream.pid);
+          json.attribute("tid", slot);
+          json.attributeObject("args", [&] {
+            json.attribute("name", stream.eventNames[slot]);
+          });
+        });
+      }
+    }
+  }
+}
+
+void TraceDecoder::writeEvent(const Stream &stream, unsigned slot,
+                              const char *phase) {
+  ++numEvents;
+  json.object([&] {
+    json.attribute("name", stream.eventNames[slot]);
+    json.attribute("ts", static_cast<int64_t>(stream.timer));
+    json.attribute("ph", phase);
+    json.attribute("pid", stream.pid);
+    json.attribute("tid", slot);
+    json.attributeObject("args", [] {});
+  });
+}
+
+void TraceDecoder::record(Stream &stream, uint32_t events, uint32_t cycles) {
+  // Events stop one cycle after the previous command, unless they are still
+  // recorded without any cycle in between; those recorded start after the
+  // cycles of the command.
+  stream.timer += 1;
+  for (unsigned slot = 0; slot < kNumTraceSlots; slot++) {
+    uint32_t bit = 1u << slot;
+    if ((stream.active & bit) && (cycles > 0 || !(events & bit)))
+      writeEvent(stream, slot, "E");
+  }
+  stream.active &= cycles > 0 ? 0 : events;
+  stream.timer += cycles;
+  for (unsigned slot = 0; slot < kNumTraceSlots; slot++) {
+    uint32_t bit = 1u << slot;
+    if ((events & bit) && !(stream.active & bit)) {
+      writeEvent(stream, slot, "B");
+      stream.active |= bit;
+    }
+  }
+}
+
+void TraceDecoder::decodeByte(Stream &stream, uint8_t byte) {
+  stream.pending.push_back(byte);
+  ArrayRef<uint8_t> b = stream.pending;
+  if (b.size() < getCommandLength(b[0]))
+    return;
+
+  if ((b[0] & 0x80) == 0x00) { // Single0
+    record(stream, 1u << ((b[0] >> 4) & 0x7), b[0] & 0xF);
+  } else if ((b[0] & 0xE0) == 0x80) { // Single1
+    record(stream, 1u << ((b[0] >> 2) & 0x7), (b[0] & 0x3) << 8 | b[1]);
+  } else if ((b[0] & 0xE0) == 0xA0) { // Single2
+    record(stream, 1u << ((b[0] >> 2) & 0x7),
+           (b[0] & 0x3) << 16 | b[1] << 8 | b[2]);
+  } else if ((b[0] & 0xF0) == 0xC0) { // Multiple0
+    record(stream, (b[0] & 0xF) << 4 | b[1] >> 4, b[1] & 0xF);
+  } else if ((b[0] & 0xFC) == 0xD0) { // Multiple1
+    record(stream, (b[0] & 0x3) << 6 | b[1] >> 2, (b[1] & 0x3) << 8 | b[2]);
+  } else if ((b[0] & 0xFC) == 0xD4) { // Multiple2
+    record(stream, (b[0] & 0x3) << 6 | b[1] >> 2,
+           (b[1] & 0x3) << 16 | b[2] << 8 | b[3]);
+  } else if ((b[0] & 0xF0) == 0xE0) { // Repeat0
+    stream.timer += b[0] & 0xF;
+  } else if ((b[0] & 0xFC) == 0xD8) { // Repeat1
+    stream.timer += (b[0] & 0x3) << 8 | b[1];
+  }
+  // As in parse_trace.py, the timer values of the start commands and the
+  // event syncs are ignored, so that the traces of the tiles line up.
+  stream.pending.clear();
+}
+
+void TraceDecoder::decode(uint32_t word) {
+  if (!started) {
+    writeMetadata();
+    started = true;
+  }
+
+  // Headers with a wrong parity or reserved bits set are data; the packet
+  // continues the previous one.
+  if (numWords++ % kPacketWords == 0 && isPacketHeader(word)) {
+    ++numPackets;
+    auto type = static_cast<TracePacketType>((word >> 12) & 0x3);
+    TileID tile = {static_cast<int>((word >> 21) & 0x7F),
+                   static_cast<int>((word >> 16) & 0x1F)};
+    auto &typeStreams = streams[static_cast<unsigned>(type)];
+    auto it = typeStreams.find(tile);
+    if (it == typeStreams.end()) {
+      unconfiguredStreams.insert({type, tile});
+      current = nullptr;
+    } else {
+      current = &it->second;
+    }
+    return;
+  }
+
+  // The trace buffer is zero past the end of the trace; zero words still take
+  // their place in the packet, but carry no commands.
+  if (!current || word == 0 || word == kPaddingWord)
+    return;
+  for (int shift = 24; shift >= 0; shift -= 8)
+    decodeByte(*current, (word >> shift) & 0xFF);
+}
+
+void TraceDecoder::finish() {
+  if (!started) {
+    writeMetadata();
+    started = true;
+  }
+  json.arrayEnd();
+  json.flush();
+}
@@ -0,0 +1,275 @@
+//===- AIETransactionReplay.cpp ---------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc. All rights reserved.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Targets/AIETransactionReplay.h"
+
+#include "llvm/Support/Format.h"
+
+#include <cstring>
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+namespace {
+
+// Size in bytes of the transaction header.
+constexpr size_t kHeaderSize = 16;
+
+// A range of registers holding one value per entry, e.g. the BDs of a tile.
+struct RegisterArray {
+  uint32_t base;
+  uint32_t stride;
+  uint32_t numEntries;
+  uint32_t numWords;
+};
+
+// The BDs and the lock values in the AIE2 shim, mem and core tile register
+// maps.
+std::optional<std::pair<RegisterArray, RegisterArray>>
+getBdsAndLocks(const AIETargetModel &tm, int col, int row) {
+  if (tm.getTargetArch() == AIEArch::AIE1)
+    return std::nullopt;
+  uint32_t numBds = tm.getNumBDs(col, row);
+  uint32_t numLocks = tm.getNumLocks(col, row);
+  if (tm.isMemTile(col, row))
+    return std::make_pair(RegisterArray{0xA0000, 0x20, numBds, 8},
+                          RegisterArray{0xC0000, 0x10, numLocks, 1});
+  if (tm.isShimNOCorPLTile(col, row))
+    return std::make_pair(RegisterArray{0x1D000, 0x20, numBds, 8},
+                          RegisterArray{0x14000, 0x10, numLocks, 1});
+  return std::make_pair(RegisterArray{0x1D000, 0x20, numBds, 6},
+                        RegisterArray{0x1F000, 0x10, numLocks, 1});
+}
+
+// Writes to the DMA task queues push a task rather than store a value, so
+// they are never redundant nor overwritten. The offsets are those of the
+// AIE2 register maps; they are matched in every tile type.
+bool isTaskQueueRegister(uint32_t offset) {
+  auto inQueueRange = [&](uint32_t first, uint32_t numChannels) {
+    return offset >= first && offset < first + numChannels * 8 &&
+           (offset - first) % 8 == 0;
+  };
+  return inQueueRange(0x1D204, 4) || inQueueRange(0xA0604, 12) ||
+         inQueueRange(0x1DE04, 4);
+}
+
+uint32_t read32(ArrayRef<uint8_t> data, size_t offset) {
+  uint32_t word;
+  std::memcpy(&word, &data[offset], sizeof(word));
+  return word;
+}
+
+} // namespace
+
+std::optional<TransactionHeader>
+xilinx::AIE::parseTransactionHeader(ArrayRef<uint8_t> data) {
+  if (data.size() < kHeaderSize)
+    return std::nullopt;
+  TransactionHeader header;
+  header.major = data[0];
+  header.minor = data[1];
+  header.numRows = data[3];
+  header.numCols = data[4];
+  header.numOps = read32(data, 8);
+  header.size = read32(data, 12);
+  return header;
+}
+
+void TransactionReplay::write(uint64_t address, uint32_t value,
+                              uint32_t mask) {
+  uint32_t rowShift = targetModel.getRowShift();
+  uint32_t colShift = targetModel.getColumnShift();
+  TileID tile = {static_cast<int>(address >> colShift),
+                 static_cast<int>((address >> rowShift) &
+                                  ((1u << (colShift - rowShift)) - 1))};
+  uint32_t offset = address & ((1u << rowShift) - 1);
+  Register &reg = registers[tile][offset];
+
+  ++numRegisterWrites;
+  if (!isTaskQueueRegister(offset)) {
+    if ((reg.known & mask) == mask && (reg.value & mask) == (value & mask))
+      ++numRedundantWrites;
+    // Only the last write to a register is tracked: an earlier write some
+    // bits of which the last one left alone is not counted even if they are
+    // written again.
+    auto [it, inserted] = pendingBits.try_emplace(address, 0);
+    if (!inserted && it->second && !(it->second & ~mask))
+      ++numOverwrittenWrites;
+    it->second = mask;
+  }
+
+  reg.value = (reg.value & ~mask) | (value & mask);
+  reg.known |= mask;
+}
+
+LogicalResult TransactionReplay::replay(ArrayRef<uint8_t> data) {
+  std::optional<TransactionHeader> header = parseTransactionHeader(data);
+  if (!header) {
+    llvm::errs() << "Transaction binary is too short for its header\n";
+    return failure();
+  }
+  bool v0_1 = header->major == 0 && header->minor == 1;
+  bool v1_0 = header->major == 1 && header->minor == 0;
+  if (!v0_1 && !v1_0) {
+    llvm::errs() << "Unsupported TXN binary version: "
+                 << static_cast<unsigned>(header->major) << "."
+                 << static_cast<unsigned>(header->minor) << "\n";
+    return failure();
+  }
+  if (header->size > data.size()) {
+    llvm::errs() << "Transaction binary is shorter than its header says\n";
+    return failure();
+  }
+  data = data.take_front(header->size);
+
+  size_t i = kHeaderSize;
+  auto count = [&](TransactionOpcode opcode, size_t size) {
+    OpcodeCount &c = counts[static_cast<unsigned>(opcode)];
+    ++c.ops;
+    c.bytes += size;
+  };
+  for (uint32_t n = 0; n < header->numOps; n++) {
+    auto has = [&](size_t size) { return i + size <= data.size(); };
+    if (!has(4)) {
+      llvm::errs() << "Transaction binary ends after " << n << " of "
+                   << header->numOps << " operations\n";
+      return failure();
+    }
+
+    uint8_t opc = data[i];
+    size_t size;
+    if (opc == 0x00 && v0_1 && has(24)) {
+      uint64_t addr = static_cast<uint64_t>(read32(data, i + 12)) << 32 |
+                      read32(data, i + 8);
+      write(addr, read32(data, i + 16), ~0u);
+      size = read32(data, i + 20);
+      count(TransactionOpcode::Write, size);
+    } else if (opc == 0x00 && v1_0 && has(12)) {
+      write(read32(data, i + 4), read32(data, i + 8), ~0u);
+      size = 12;
+      count(TransactionOpcode::Write, size);
+    } else if (opc == 0x01 && has(v0_1 ? 16 : 12)) {
+      size_t payload = v0_1 ? 16 : 12;
+      uint32_t addr = read32(data, i + (v0_1 ? 8 : 4));
+      size = read32(data, i + (v0_1 ? 12 : 8));
+      if (size < payload || !has(size)) {
+        llvm::errs() << "Malformed block write at byte " << i << "\n";
+        return failure();
+      }
+      for (size_t w = payload; w + 4 <= size; w += 4)
+        write(addr + w - payload, read32(data, i + w), ~0u);
+      count(TransactionOpcode::BlockWrite, size);
+    } else if (opc == 0x03 && v0_1 && has(28)) {
+      uint64_t addr = static_cast<uint64_t>(read32(data, i + 12)) << 32 |
+                      read32(data, i + 8);
+      write(addr, read32(data, i + 16), read32(data, i + 20));
+      size = read32(data, i + 24);
+      count(TransactionOpcode::MaskWrite, size);
+    } else if (opc == 0x03 && v1_0 && has(16)) {
+      write(read32(data, i + 4), read32(data, i + 8), read32(data, i + 12));
+      size = 16;
+      count(TransactionOpcode::MaskWrite, size);
+    } else if ((opc == 0x80 || opc == 0x81) && v1_0 && has(8)) {
+      // Syncs and address patches only take effect on the device.
+      size = read32(data, i + 4);
+      count(opc == 0x80 ? TransactionOpcode::Sync
+                        : TransactionOpcode::AddressPatch,
+            size);
+    } else {
+      llvm::errs() << "Unhandled opcode " << std::to_string(opc)
+                   << " at byte " << i << "\n";
+      return failure();
+    }
+
+    if (size == 0 || !has(size)) {
+      llvm::errs() << "Malformed operation at byte " << i << "\n";
+      return failure();
+    }
+    i += size;
+  }
+  return success();
+}
+
+void TransactionReplay::print(raw_ostream &os) const {
+  static const char *opcodeNames[kNumTransactionOpcodes] = {
+      "write", "blockwrite", "maskwrite", "sync", "address_patch"};
+  uint64_t numOps = 0, numBytes = 0;
+  for (const OpcodeCount &c : counts) {
+    numOps += c.ops;
+    numBytes += c.bytes;
+  }
+  os << "operations: " << numOps << " (" << numBytes << " bytes)\n";
+  for (unsigned opc = 0; opc < kNumTransactionOpcodes; opc++)
+    os << "  " << opcodeNames[opc] << ": " << counts[opc].ops << " ("
+       << counts[opc].bytes << " bytes)\n";
+  os << "register writes: " << numRegisterWrites << "\n";
+  os << "redundant writes: " << numRedundantWrites << "\n";
+  os << "overwritten writes: " << numOverwrittenWrites << "\n";
+
+  auto printWord = [&](const Register &reg) {
+    if (reg.known)
+      os << llvm::format_hex_no_prefix(reg.value, 8);
+    else
+      os << "--------";
+  };
+
+  for (const auto &[tile, tileRegisters] : registers) {
+    os << "tile (" << tile.col << ", " << tile.row << ")";
+    if (targetModel.isMemTile(tile.col, tile.row))
+      os << " mem";
+    else if (targetModel.isShimNOCorPLTile(tile.col, tile.row))
+      os << " shim";
+    else if (targetModel.isCoreTile(tile.col, tile.row))
+      os << " core";
+    os << "\n";
+
+    auto bdsAndLocks = getBdsAndLocks(targetModel, tile.col, tile.row);
+    auto getEntry = [&](const RegisterArray &array,
+                        uint32_t offset) -> std::optional<uint32_t> {
+      if (offset < array.base ||
+          offset >= array.base + array.numEntries * array.stride)
+        return std::nullopt;
+      if ((offset - array.base) % array.stride >= array.numWords * 4)
+        return std::nullopt;
+      return (offset - array.base) / array.stride;
+    };
+    auto printEntries = [&](const char *name, const RegisterArray &array) {
+      std::optional<uint32_t> last;
+      for (const auto &[offset, reg] : tileRegisters) {
+        std::optional<uint32_t> entry = getEntry(array, offset);
+        if (!entry || entry == last)
+          continue;
+        last = entry;
+        os << "  " << name << " " << *entry << ":";
+        for (uint32_t w = 0; w < array.numWords; w++) {
+          auto it = tileRegisters.find(array.base + *entry * array.stride +
+                                       w * 4);
+          os << " ";
+          printWord(it == tileRegisters.end() ? Register{} : it->second);
+        }
+        os << "\n";
+      }
+    };
+    if (bdsAndLocks) {
+      printEntries("bd", bdsAndLocks->first);
+      printEntries("lock", bdsAndLocks->second);
+    }
+
+    for (const auto &[offset, reg] : tileRegisters) {
+      if (bdsAndLocks && (getEntry(bdsAndLocks->first, offset) ||
+                          getEntry(bdsAndLocks->second, offset)))
+        continue;
+      os << "  " << llvm::format_hex(offset, 10) << ": ";
+      printWord(reg);
+      os << "\n";
+    }
+  }
+}
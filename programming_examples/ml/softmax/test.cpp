@@ -32,27 +32,37 @@ using INOUT1_DATATYPE = std::bfloat16_t;
 namespace po = boost::program_options;
 
 // ----------------------------------------------------------------------------
-// Verify results (specific to our design example)
+// Scalar reference: numerically stable softmax of each tile, computed in float
 // ----------------------------------------------------------------------------
 template <typename T>
-int verify(int size, int tile_size, std::vector<T> A, std::vector<T> B,
-           int verbosity) {
+std::vector<float> softmax_reference(int size, int tile_size,
+                                     const std::vector<T> &A) {
+  std::vector<float> RefVec(size);
+  for (int t = 0; t < size; t += tile_size) {
+    float max_val = (float)A[t];
+    for (int i = 1; i < tile_size; i++)
+      max_val = std::max(max_val, (float)A[t + i]);
 
-  int errors = 0;
-  std::vector<T> RefVec(size);
-
-  for (uint32_t t = 0; t < size; t += tile_size) {
     float running = 0.0;
-    for (uint32_t i = 0; i < tile_size; i++) {
-      float ez = (float)(exp(A[t + i]));
-      running += ez;
-      RefVec[t + i] = exp(A[t + i]);
+    for (int i = 0; i < tile_size; i++) {
+      RefVec[t + i] = std::exp((float)A[t + i] - max_val);
+      running += RefVec[t + i];
     }
-
-    for (uint32_t i = 0; i < tile_size; i++) {
+    for (int i = 0; i < tile_size; i++)
       RefVec[t + i] /= running;
-    }
   }
+  return RefVec;
+}
+
+// ----------------------------------------------------------------------------
+// Verify results (specific to our design example)
+// ----------------------------------------------------------------------------
+template <typename T>
+int verify(int size, int tile_size, std::vector<T> A, std::vector<T> B,
+           int verbosity) {
+
+  int errors = 0;
+  std::vector<float> RefVec = softmax_reference(size, tile_size, A);
 
   for (uint32_t i = 0; i < size; i++) {
 
@@ -66,6 +76,19 @@ int verify(int size, int tile_size, std::vector<T> A, std::vector<T> B,
                   << std::endl;
     }
   }
+
+  // The outputs of each tile are a probability distribution, up to the
+  // rounding of the bf16 outputs.
+  for (uint32_t t = 0; t < size; t += tile_size) {
+    float sum = 0.0;
+    for (uint32_t i = 0; i < tile_size; i++)
+      sum += (float)B[t + i];
+    if (std::abs(sum - 1.0f) > 0.04) {
+      std::cout << "Error in tile " << t / tile_size << ": outputs sum to "
+                << sum << std::endl;
+      errors++;
+    }
+  }
   return errors;
 }
 
@@ -121,6 +121,19 @@ NB_MODULE(_aie, m) {
       },
       "ctx"_a, "binary"_a);
 
+  m.def(
+      "decode_trace",
+      [](MlirOperation op, nb::bytes trace, const std::string &outputPath,
+         int colShift) {
+        MlirStringRef words = {static_cast<const char *>(trace.data()),
+                               trace.size()};
+        if (mlirLogicalResultIsFailure(aieDecodeTrace(
+                op, words, {outputPath.data(), outputPath.size()}, colShift)))
+          throw nb::value_error(
+              (llvm::Twine("Failed to write ") + outputPath).str().c_str());
+      },
+      "module"_a, "trace"_a, "output_path"_a, "colshift"_a = 0);
+
   m.def(
       "npu_instgen",
       [&stealCStr](MlirOperation op) {
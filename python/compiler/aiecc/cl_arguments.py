@@ -33,6 +33,13 @@ def parse_args(args=None):
         default=None,
         help="directory used for temporary file storage",
     )
+    parser.add_argument(
+        "--core-cache-dir",
+        dest="core_cache_dir",
+        metavar="dir",
+        default=None,
+        help="Reuse the core ELFs cached in this directory when the LLVM IR, linker script, linked objects, target and compiler of a core are unchanged",
+    )
     parser.add_argument(
         "--verbose",
         "-v",
@@ -148,7 +155,7 @@ def parse_args(args=None):
         "--alloc-scheme",
         dest="alloc_scheme",
         default="bank-aware",
-        help="Allocation scheme for AIE buffers: basic-sequential, bank-aware (default).",
+        help="Allocation scheme for AIE buffers: basic-sequential, bank-aware (default), bin-packing.",
     )
     parser.add_argument(
         "--generate-ctrl-pkt-overlay",
@@ -164,6 +171,13 @@ def parse_args(args=None):
         action="store_true",
         help="Use dynamic object fifos for the for loops",
     )
+    parser.add_argument(
+        "--schedule-runtime-sequence",
+        dest="schedule_runtime_sequence",
+        default=False,
+        action="store_true",
+        help="Overlap the host transfers of the runtime sequences, assuming that the buffers passed to a sequence do not overlap",
+    )
     parser.add_argument(
         "--aie-generate-airbin",
         dest="airbin",
@@ -190,7 +204,7 @@ def parse_args(args=None):
         dest="profiling",
         default=False,
         action="store_true",
-        help="Profile commands to find the most expensive executions.",
+        help="Profile the stages of the flow and the commands to find the most expensive ones.",
     )
     parser.add_argument(
         "--unified",
@@ -9,7 +9,9 @@ aiecc - AIE compiler driver for MLIR tools
 """
 
 import asyncio
+import contextlib
 import glob
+import hashlib
 import json
 import os
 import random
@@ -93,18 +95,46 @@ AIE_LOWER_TO_LLVM = (
     + LOWER_TO_LLVM_PIPELINE
 )
 
+# Lowers every core of the design into output_dir/core_<col>_<row>.mlir in a
+# single aie-opt run.
+AIE_SPLIT_CORE_MODULES = lambda output_dir: (
+    Pipeline()
+    .Nested(
+        "aie.device",
+        Pipeline()
+        .add_pass("aie-localize-locks")
+        .add_pass("aie-normalize-address-spaces"),
+    )
+    .add_pass(
+        "aie-split-core-modules",
+        output_dir=output_dir,
+        core_pipeline="{" + str(LOWER_TO_LLVM_PIPELINE) + "}",
+    )
+)
+
 CREATE_PATH_FINDER_FLOWS = Pipeline().Nested(
     "aie.device", Pipeline().add_pass("aie-create-pathfinder-flows")
 )
 
-DMA_TO_NPU = Pipeline().Nested(
+# With schedule_runtime_sequence, the waits of the runtime sequences are sunk
+# past independent transfers, assuming that the buffers passed to a sequence do
+# not overlap.
+DMA_TO_NPU = lambda schedule_runtime_sequence: Pipeline().Nested(
     "aie.device",
     Pipeline()
     .add_pass("aie-materialize-bd-chains")
     .add_pass("aie-substitute-shim-dma-allocations")
     .add_pass("aie-assign-runtime-sequence-bd-ids")
     .add_pass("aie-dma-tasks-to-npu")
-    .add_pass("aie-dma-to-npu"),
+    .add_pass("aie-split-access-patterns")
+    + (
+        Pipeline().add_pass(
+            "aie-schedule-runtime-sequence", assume_distinct_buffers=True
+        )
+        if schedule_runtime_sequence
+        else Pipeline()
+    )
+    + Pipeline().add_pass("aie-dma-to-npu"),
 )
 
 
@@ -210,9 +240,10 @@ mem_topology = {
 }
 
 
-def emit_partition(mlir_module_str, kernel_id="0x901", start_columns=None):
-    with Context(), Location.unknown():
-        module = Module.parse(mlir_module_str)
+def emit_partition(module, kernel_id="0x901", start_columns=None):
+    if isinstance(module, str):
+        with Context(), Location.unknown():
+            module = Module.parse(module)
     device = find_ops(
         module.operation,
         lambda o: isinstance(o.operation.opview, aiedialect.DeviceOp),
@@ -275,20 +306,21 @@ def emit_partition(mlir_module_str, kernel_id="0x901", start_columns=None):
     }
 
 
-def generate_cores_list(mlir_module_str):
-    with Context(), Location.unknown():
-        module = Module.parse(mlir_module_str)
-        return [
-            (
-                c.tile.owner.opview.col.value,
-                c.tile.owner.opview.row.value,
-                c.elf_file.value if c.elf_file is not None else None,
-            )
-            for c in find_ops(
-                module.operation,
-                lambda o: isinstance(o.operation.opview, aiedialect.CoreOp),
-            )
-        ]
+def generate_cores_list(module):
+    if isinstance(module, str):
+        with Context(), Location.unknown():
+            module = Module.parse(module)
+    return [
+        (
+            c.tile.owner.opview.col.value,
+            c.tile.owner.opview.row.value,
+            c.elf_file.value if c.elf_file is not None else None,
+        )
+        for c in find_ops(
+            module.operation,
+            lambda o: isinstance(o.operation.opview, aiedialect.CoreOp),
+        )
+    ]
 
 
 def emit_design_bif(root_path, has_cores=True, enable_cores=True, unified=False):
@@ -332,17 +364,24 @@ def do_run(command, verbose=False):
     return ret
 
 
-def run_passes(pass_pipeline, mlir_module_str, outputfile=None, verbose=False):
+# Runs pass_pipeline in place on module, a Module or an Operation, in the
+# context the module belongs to.
+def run_passes_in_place(pass_pipeline, module, verbose=False):
     if verbose:
         print("Running:", pass_pipeline)
-    with Context() as ctx, Location.unknown():
-        module = Module.parse(mlir_module_str)
+    with module.operation.context, Location.unknown():
         pm = PassManager.parse(pass_pipeline)
         try:
             pm.run(module.operation)
         except Exception as e:
             print("Error running pass pipeline: ", pass_pipeline, e)
             raise e
+
+
+def run_passes(pass_pipeline, mlir_module_str, outputfile=None, verbose=False):
+    with Context() as ctx, Location.unknown():
+        module = Module.parse(mlir_module_str)
+        run_passes_in_place(pass_pipeline, module, verbose)
         mlir_module_str = str(module)
         if outputfile:
             with open(outputfile, "w") as g:
@@ -350,11 +389,39 @@ def run_passes(pass_pipeline, mlir_module_str, outputfile=None, verbose=False):
     return mlir_module_str
 
 
+# The tools run as subprocesses read MLIR bytecode as well as text, and parse it
+# much faster.
+def write_bytecode(module, path):
+    with open(path, "wb") as f:
+        module.operation.write_bytecode(f)
+
+
 def corefile(dirname, core, ext):
     col, row, _ = core
     return os.path.join(dirname, f"core_{col}_{row}.{ext}")
 
 
+# Bump when the way core ELFs are built changes without the inputs hashed by
+# core_cache_key changing.
+CORE_CACHE_VERSION = "1"
+
+
+def file_digest(path):
+    with open(path, "rb") as f:
+        return hashlib.sha256(f.read()).hexdigest()
+
+
+# Identifies an installed tool by its path, size and modification time, which
+# change whenever the tool is upgraded.
+def tool_fingerprint(tool):
+    path = shutil.which(tool) or tool
+    try:
+        st = os.stat(path)
+    except OSError:
+        return path
+    return f"{path}:{st.st_size}:{st.st_mtime_ns}"
+
+
 def aie_target_defines(aie_target):
     if aie_target == "AIE2":
         return ["-D__AIEARCH__=20"]
@@ -394,6 +461,7 @@ class FlowRunner:
         self.opts = opts
         self.tmpdirname = tmpdirname
         self.runtimes = dict()
+        self.stage_runtimes = dict()
         self.progress_bar = None
         self.maxtasks = 5
         self.stopall = False
@@ -404,6 +472,35 @@ class FlowRunner:
     def prepend_tmp(self, x):
         return os.path.join(self.tmpdirname, x)
 
+    # Times the stage of the flow run in its body, both the passes run in
+    # process and the commands it calls.
+    @contextlib.contextmanager
+    def stage(self, name):
+        start = time.time()
+        try:
+            yield
+        finally:
+            end = time.time()
+            if self.opts.verbose:
+                print(f"Stage done in {end - start:.3f} sec: {name}")
+            self.stage_runtimes[name] = end - start
+
+    # Writes module as bytecode for the subprocesses to read, and as text next
+    # to it for inspection in the project directory.
+    def write_module(self, module, name):
+        path = self.prepend_tmp(name + ".mlirbc")
+        write_bytecode(module, path)
+        with open(self.prepend_tmp(name + ".mlir"), "w") as f:
+            f.write(str(module))
+        return path
+
+    def copy_elfs(self):
+        for elf in glob.glob("*.elf") + glob.glob("*.elf.map"):
+            try:
+                shutil.copy(elf, self.tmpdirname)
+            except shutil.SameFileError:
+                pass
+
     async def do_call(self, task, command, force=False):
         if self.stopall:
             return
@@ -435,12 +532,38 @@ class FlowRunner:
             print("Error encountered while running: " + commandstr, file=sys.stderr)
             sys.exit(ret)
 
-    # In order to run xchesscc on modern ll code, we need a bunch of hacks.
-    async def chesshack(self, task, llvmir, aie_target):
+    # Returns the key under which the ELF of a core is cached: a hash of
+    # everything the compilation and the link of the core depend on.
+    def core_cache_key(
+        self, aie_target, file_core_llvmir, file_core_linker_script, commands
+    ):
+        h = hashlib.sha256()
+        h.update(CORE_CACHE_VERSION.encode())
+        h.update(aie_target.encode())
+        h.update(file_digest(file_core_llvmir).encode())
+        linker_script = open(file_core_linker_script).read()
+        h.update(linker_script.encode())
+        linked_objs = re.findall(r"^INPUT\((.*)\)", linker_script, re.MULTILINE)
+        linked_objs += re.findall(r"^_include _file (.*)", linker_script, re.MULTILINE)
+        for obj in linked_objs:
+            h.update(obj.encode())
+            if os.path.exists(obj):
+                h.update(file_digest(obj).encode())
+        # The exact arguments of the commands building the ELF. The files of
+        # the project directory they use are either hashed above or outputs,
+        # so only their names count, and projects share the cache.
+        for command in commands:
+            h.update(tool_fingerprint(command[0]).encode())
+            for arg in command[1:]:
+                h.update(arg.replace(self.tmpdirname, "").encode() + b"\0")
+            h.update(b"\n")
+        return h.hexdigest()
+
+    # Returns the path of the chess-compatible version of llvmir that chesshack
+    # links, and the command linking it.
+    def chesshack_command(self, llvmir, aie_target):
         llvmir_chesshack = llvmir + "chesshack.ll"
         llvmir_chesslinked_path = llvmir + "chesslinked.ll"
-        if not self.opts.execute:
-            return llvmir_chesslinked_path
 
         install_path = aie.compiler.aiecc.configure.install_path()
         runtime_lib_path = os.path.join(install_path, "aie_runtime_lib")
@@ -448,34 +571,40 @@ class FlowRunner:
             runtime_lib_path, aie_target.upper(), "chess_intrinsic_wrapper.ll"
         )
 
-        llvmir_ir = await read_file_async(llvmir)
-        llvmir_hacked_ir = downgrade_ir_for_chess(llvmir_ir)
-        await write_file_async(llvmir_hacked_ir, llvmir_chesshack)
-
         if aie_target.casefold() == "AIE2".casefold():
             target = "target_aie_ml"
         elif aie_target.casefold() == "AIE2P".casefold():
             target = "target_aie2p"
         else:
             target = "target"
+        return llvmir_chesslinked_path, [
+            # The path below is cheating a bit since it refers directly to the AIE1
+            # version of llvm-link, rather than calling the architecture-specific
+            # tool version.
+            opts.aietools_path
+            + "/tps/lnx64/"
+            + target
+            + "/bin/LNa64bin/chess-llvm-link",
+            llvmir_chesshack,
+            chess_intrinsic_wrapper_ll_path,
+            "-S",
+            "-o",
+            llvmir_chesslinked_path,
+        ]
+
+    # In order to run xchesscc on modern ll code, we need a bunch of hacks.
+    async def chesshack(self, task, llvmir, aie_target):
+        llvmir_chesslinked_path, command = self.chesshack_command(llvmir, aie_target)
+        if not self.opts.execute:
+            return llvmir_chesslinked_path
+
+        llvmir_chesshack = llvmir + "chesshack.ll"
+        llvmir_ir = await read_file_async(llvmir)
+        llvmir_hacked_ir = downgrade_ir_for_chess(llvmir_ir)
+        await write_file_async(llvmir_hacked_ir, llvmir_chesshack)
+
         assert os.path.exists(llvmir_chesshack)
-        await self.do_call(
-            task,
-            [
-                # The path below is cheating a bit since it refers directly to the AIE1
-                # version of llvm-link, rather than calling the architecture-specific
-                # tool version.
-                opts.aietools_path
-                + "/tps/lnx64/"
-                + target
-                + "/bin/LNa64bin/chess-llvm-link",
-                llvmir_chesshack,
-                chess_intrinsic_wrapper_ll_path,
-                "-S",
-                "-o",
-                llvmir_chesslinked_path,
-            ],
-        )
+        await self.do_call(task, command)
 
         return llvmir_chesslinked_path
 
@@ -511,54 +640,78 @@ class FlowRunner:
 
             # fmt: off
             corecol, corerow, elf_file = core
-            if not opts.unified:
-                file_core = corefile(self.tmpdirname, core, "mlir")
-                await self.do_call(task, ["aie-opt", "--aie-localize-locks", "--aie-normalize-address-spaces", "--aie-standard-lowering=tilecol=%d tilerow=%d" % core[0:2], "--aiex-standard-lowering", file_with_addresses, "-o", file_core])
-                file_opt_core = corefile(self.tmpdirname, core, "opt.mlir")
-                await self.do_call(task, ["aie-opt", f"--pass-pipeline={LOWER_TO_LLVM_PIPELINE}", file_core, "-o", file_opt_core])
-            if self.opts.xbridge:
-                file_core_bcf = corefile(self.tmpdirname, core, "bcf")
-                await self.do_call(task, ["aie-translate", file_with_addresses, "--aie-generate-bcf", "--tilecol=%d" % corecol, "--tilerow=%d" % corerow, "-o", file_core_bcf])
-            else:
-                file_core_ldscript = corefile(self.tmpdirname, core, "ld.script")
-                await self.do_call(task, ["aie-translate", file_with_addresses, "--aie-generate-ldscript", "--tilecol=%d" % corecol, "--tilerow=%d" % corerow, "-o", file_core_ldscript])
+            # The core modules and the bcfs or linker scripts are generated for
+            # all the cores at once by run_flow.
+            file_core_bcf = corefile(self.tmpdirname, core, "bcf")
+            file_core_ldscript = corefile(self.tmpdirname, core, "ld.script")
             if not self.opts.unified:
+                file_opt_core = corefile(self.tmpdirname, core, "mlir")
                 file_core_llvmir = corefile(self.tmpdirname, core, "ll")
                 await self.do_call(task, ["aie-translate", "--mlir-to-llvmir", file_opt_core, "-o", file_core_llvmir])
                 file_core_obj = corefile(self.tmpdirname, core, "o")
 
             file_core_elf = elf_file if elf_file else corefile(".", core, "elf")
 
-            if opts.compile and opts.xchesscc:
-                if not opts.unified:
-                    file_core_llvmir_chesslinked = await self.chesshack(task, file_core_llvmir, aie_target)
-                    if self.opts.link and self.opts.xbridge:
-                        link_with_obj = await extract_input_files(file_core_bcf)
-                        await self.do_call(task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-d", "+Wclang,-xir", "-f", file_core_llvmir_chesslinked, link_with_obj, "+l", file_core_bcf, "-o", file_core_elf])
-                    elif self.opts.link:
-                        await self.do_call(task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-c", "-d", "+Wclang,-xir", "-f", file_core_llvmir_chesslinked, "-o", file_core_obj])
-                        await self.do_call(task, [self.peano_clang_path, "-O2", "--target=" + aie_peano_target, file_core_obj, *clang_link_args, "-Wl,-T," + file_core_ldscript, "-o", file_core_elf])
-                else:
-                    file_core_obj = self.unified_file_core_obj
-                    if opts.link and opts.xbridge:
-                        link_with_obj = await extract_input_files(file_core_bcf)
-                        await self.do_call(task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-d", "-f", file_core_obj, link_with_obj, "+l", file_core_bcf, "-o", file_core_elf])
-                    elif opts.link:
-                        await self.do_call(task, [self.peano_clang_path, "-O2", "--target=" + aie_peano_target, file_core_obj, *clang_link_args, "-Wl,-T," + file_core_ldscript, "-o", file_core_elf])
+            # The commands compiling the core and linking its ELF, in the order
+            # they run. They are all built first, so that the ELF can be cached
+            # under a hash of their exact arguments.
+            commands = []
+            chesshack = opts.compile and opts.xchesscc and not opts.unified
+            if chesshack:
+                file_core_llvmir_chesslinked, chesshack_command = self.chesshack_command(file_core_llvmir, aie_target)
+                if self.opts.link and self.opts.xbridge:
+                    link_with_obj = await extract_input_files(file_core_bcf)
+                    commands.append(["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-d", "+Wclang,-xir", "-f", file_core_llvmir_chesslinked, link_with_obj, "+l", file_core_bcf, "-o", file_core_elf])
+                elif self.opts.link:
+                    commands.append(["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-c", "-d", "+Wclang,-xir", "-f", file_core_llvmir_chesslinked, "-o", file_core_obj])
+                    commands.append([self.peano_clang_path, "-O2", "--target=" + aie_peano_target, file_core_obj, *clang_link_args, "-Wl,-T," + file_core_ldscript, "-o", file_core_elf])
+            elif opts.compile and opts.xchesscc:
+                file_core_obj = self.unified_file_core_obj
+                if opts.link and opts.xbridge:
+                    link_with_obj = await extract_input_files(file_core_bcf)
+                    commands.append(["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-d", "-f", file_core_obj, link_with_obj, "+l", file_core_bcf, "-o", file_core_elf])
+                elif opts.link:
+                    commands.append([self.peano_clang_path, "-O2", "--target=" + aie_peano_target, file_core_obj, *clang_link_args, "-Wl,-T," + file_core_ldscript, "-o", file_core_elf])
 
             elif opts.compile:
                 if not opts.unified:
                     file_core_llvmir_stripped = corefile(self.tmpdirname, core, "stripped.ll")
-                    await self.do_call(task, [self.peano_opt_path, "--passes=default<O2>,strip", "-S", file_core_llvmir, "-o", file_core_llvmir_stripped])
-                    await self.do_call(task, [self.peano_llc_path, file_core_llvmir_stripped, "-O2", "--march=" + aie_target.lower(), "--function-sections", "--filetype=obj", "-o", file_core_obj])
+                    commands.append([self.peano_opt_path, "--passes=default<O2>,strip", "-S", file_core_llvmir, "-o", file_core_llvmir_stripped])
+                    commands.append([self.peano_llc_path, file_core_llvmir_stripped, "-O2", "--march=" + aie_target.lower(), "--function-sections", "--filetype=obj", "-o", file_core_obj])
                 else:
                     file_core_obj = self.unified_file_core_obj
 
                 if opts.link and opts.xbridge:
                     link_with_obj = await extract_input_files(file_core_bcf)
-                    await self.do_call(task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-d", "-f", file_core_obj, link_with_obj, "+l", file_core_bcf, "-o", file_core_elf])
+                    commands.append(["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-d", "-f", file_core_obj, link_with_obj, "+l", file_core_bcf, "-o", file_core_elf])
                 elif opts.link:
-                    await self.do_call(task, [self.peano_clang_path, "-O2", "--target=" + aie_peano_target, file_core_obj, *clang_link_args, "-Wl,-T," + file_core_ldscript, "-o", file_core_elf])
+                    commands.append([self.peano_clang_path, "-O2", "--target=" + aie_peano_target, file_core_obj, *clang_link_args, "-Wl,-T," + file_core_ldscript, "-o", file_core_elf])
+
+            cached_elf = None
+            if self.opts.core_cache_dir and opts.compile and opts.link and opts.execute and not opts.unified:
+                file_core_linker_script = file_core_bcf if opts.xbridge else file_core_ldscript
+                hashed_commands = [chesshack_command] + commands if chesshack else commands
+                key = self.core_cache_key(aie_target, file_core_llvmir, file_core_linker_script, hashed_commands)
+                cached_elf = os.path.join(self.opts.core_cache_dir, key + ".elf")
+
+            if cached_elf and os.path.exists(cached_elf):
+                if opts.verbose:
+                    print(f"Reusing {cached_elf} for core ({corecol}, {corerow})")
+                shutil.copyfile(cached_elf, file_core_elf)
+                cached_elf = None
+            else:
+                if chesshack:
+                    await self.chesshack(task, file_core_llvmir, aie_target)
+                for command in commands:
+                    await self.do_call(task, command)
+
+            if cached_elf and not self.stopall:
+                # Copy then rename, so that concurrent runs sharing the cache
+                # never see a partial ELF.
+                os.makedirs(self.opts.core_cache_dir, exist_ok=True)
+                cached_elf_tmp = f"{cached_elf}.{uuid.uuid4().hex}.tmp"
+                shutil.copyfile(file_core_elf, cached_elf_tmp)
+                os.replace(cached_elf_tmp, cached_elf)
 
             self.progress_bar.update(self.progress_bar.task_completed, advance=1)
             if task:
@@ -568,71 +721,32 @@ class FlowRunner:
     async def process_cdo(self):
         from aie.dialects.aie import generate_cdo
 
-        with Context(), Location.unknown():
-            for elf in glob.glob("*.elf"):
-                try:
-                    shutil.copy(elf, self.tmpdirname)
-                except shutil.SameFileError:
-                    pass
-            for elf_map in glob.glob("*.elf.map"):
-                try:
-                    shutil.copy(elf_map, self.tmpdirname)
-                except shutil.SameFileError:
-                    pass
-            input_physical = Module.parse(
-                await read_file_async(self.prepend_tmp("input_physical.mlir"))
-            )
-            generate_cdo(input_physical.operation, self.tmpdirname)
+        self.copy_elfs()
+        generate_cdo(self.physical.operation, self.tmpdirname)
 
     async def process_txn(self):
-
-        with Context(), Location.unknown():
-            for elf in glob.glob("*.elf"):
-                try:
-                    shutil.copy(elf, self.tmpdirname)
-                except shutil.SameFileError:
-                    pass
-            for elf_map in glob.glob("*.elf.map"):
-                try:
-                    shutil.copy(elf_map, self.tmpdirname)
-                except shutil.SameFileError:
-                    pass
-            input_physical = await read_file_async(
-                self.prepend_tmp("input_physical.mlir")
-            )
-            run_passes(
-                "builtin.module(aie.device(convert-aie-to-transaction{elf-dir="
-                + self.tmpdirname
-                + "}))",
-                input_physical,
-                self.prepend_tmp("txn.mlir"),
-                self.opts.verbose,
-            )
+        self.copy_elfs()
+        txn = self.physical.operation.clone()
+        run_passes_in_place(
+            "builtin.module(aie.device(convert-aie-to-transaction{elf-dir="
+            + self.tmpdirname
+            + "}))",
+            txn,
+            self.opts.verbose,
+        )
+        await write_file_async(str(txn), self.prepend_tmp("txn.mlir"))
 
     async def process_ctrlpkt(self):
-
-        with Context(), Location.unknown():
-            for elf in glob.glob("*.elf"):
-                try:
-                    shutil.copy(elf, self.tmpdirname)
-                except shutil.SameFileError:
-                    pass
-            for elf_map in glob.glob("*.elf.map"):
-                try:
-                    shutil.copy(elf_map, self.tmpdirname)
-                except shutil.SameFileError:
-                    pass
-            input_physical = await read_file_async(
-                self.prepend_tmp("input_physical.mlir")
-            )
-            run_passes(
-                "builtin.module(aie.device(convert-aie-to-control-packets{elf-dir="
-                + self.tmpdirname
-                + "}))",
-                input_physical,
-                self.prepend_tmp("ctrlpkt.mlir"),
-                self.opts.verbose,
-            )
+        self.copy_elfs()
+        ctrlpkt = self.physical.operation.clone()
+        run_passes_in_place(
+            "builtin.module(aie.device(convert-aie-to-control-packets{elf-dir="
+            + self.tmpdirname
+            + " pack-bursts=true}))",
+            ctrlpkt,
+            self.opts.verbose,
+        )
+        await write_file_async(str(ctrlpkt), self.prepend_tmp("ctrlpkt.mlir"))
 
     async def process_xclbin_gen(self):
         if opts.progress:
@@ -648,7 +762,7 @@ class FlowRunner:
         )
 
         await write_file_async(
-            json.dumps(emit_partition(self.mlir_module_str, opts.kernel_id), indent=2),
+            json.dumps(emit_partition(self.module, opts.kernel_id), indent=2),
             self.prepend_tmp("aie_partition.json"),
         )
 
@@ -694,7 +808,7 @@ class FlowRunner:
                                   "--force", "--quiet", "--output", opts.xclbin_name])
         # fmt: on
 
-    async def process_host_cgen(self, aie_target, file_with_addresses):
+    async def process_host_cgen(self, aie_target, file_physical):
         async with self.limit:
             if self.stopall:
                 return
@@ -707,18 +821,6 @@ class FlowRunner:
                 task = None
 
             # Generate the included host interface
-            file_physical = self.prepend_tmp("input_physical.mlir")
-            await self.do_call(
-                task,
-                [
-                    "aie-opt",
-                    "--aie-create-pathfinder-flows",
-                    file_with_addresses,
-                    "-o",
-                    file_physical,
-                ],
-            )
-
             if opts.airbin:
                 file_airbin = self.prepend_tmp("air.bin")
                 await self.do_call(
@@ -903,7 +1005,7 @@ class FlowRunner:
             "include",
         )
         sim_genwrapper = os.path.join(runtime_simlib_path, "genwrapper_for_ps.cpp")
-        file_physical = self.prepend_tmp("input_physical.mlir")
+        file_physical = self.prepend_tmp("input_physical.mlirbc")
         memory_allocator = os.path.join(
             runtime_testlib_path, "libmemory_allocator_sim_aie.a"
         )
@@ -1068,20 +1170,22 @@ class FlowRunner:
                 "[green] MLIR compilation:", total=1, command="1 Worker"
             )
 
-            file_with_addresses = self.prepend_tmp("input_with_addresses.mlir")
-
-            pass_pipeline = INPUT_WITH_ADDRESSES_PIPELINE(
-                opts.alloc_scheme, opts.dynamic_objFifos, opts.ctrl_pkt_overlay
-            ).materialize(module=True)
-
-            run_passes(
-                pass_pipeline,
-                self.mlir_module_str,
-                file_with_addresses,
-                self.opts.verbose,
-            )
+            # The design is parsed once, and every pass pipeline run in process
+            # works on it or on a clone of it. The tools run as subprocesses
+            # read it as bytecode.
+            with self.stage("input with addresses"):
+                self.context = Context()
+                with self.context, Location.unknown():
+                    self.module = Module.parse(self.mlir_module_str)
+                pass_pipeline = INPUT_WITH_ADDRESSES_PIPELINE(
+                    opts.alloc_scheme, opts.dynamic_objFifos, opts.ctrl_pkt_overlay
+                ).materialize(module=True)
+                run_passes_in_place(pass_pipeline, self.module, self.opts.verbose)
+                file_with_addresses = self.write_module(
+                    self.module, "input_with_addresses"
+                )
 
-            cores = generate_cores_list(await read_file_async(file_with_addresses))
+            cores = generate_cores_list(self.module)
             t = do_run(
                 [
                     "aie-translate",
@@ -1100,39 +1204,48 @@ class FlowRunner:
             aie_peano_target = aie_target.lower() + "-none-elf"
 
             # Optionally generate insts.txt for NPU instruction stream
-            if opts.npu or opts.only_npu:
-                generated_insts_mlir = self.prepend_tmp("generated_npu_insts.mlir")
-                await self.do_call(
-                    progress_bar.task,
-                    [
-                        "aie-opt",
-                        f"--pass-pipeline={DMA_TO_NPU}",
-                        file_with_addresses,
-                        "-o",
-                        generated_insts_mlir,
-                    ],
-                )
-                await self.do_call(
-                    progress_bar.task,
-                    [
-                        "aie-translate",
-                        "--aie-npu-instgen",
-                        generated_insts_mlir,
-                        "-o",
-                        opts.insts_name,
-                    ],
-                )
-                if opts.only_npu:
-                    return
+            if (opts.npu or opts.only_npu) and opts.execute:
+                with self.stage("npu instructions"):
+                    npu_insts = self.module.operation.clone()
+                    run_passes_in_place(
+                        DMA_TO_NPU(opts.schedule_runtime_sequence).materialize(
+                            module=True
+                        ),
+                        npu_insts,
+                        self.opts.verbose,
+                    )
+                    if self.opts.verbose:
+                        await write_file_async(
+                            str(npu_insts),
+                            self.prepend_tmp("generated_npu_insts.mlir"),
+                        )
+                    insts = aiedialect.npu_instgen(npu_insts)
+                    if not insts:
+                        print("Error generating NPU instructions", file=sys.stderr)
+                        sys.exit(1)
+                    await write_file_async(
+                        "".join(inst + "\n" for inst in insts), opts.insts_name
+                    )
 
-            # fmt: off
-            if opts.unified:
-                file_opt_with_addresses = self.prepend_tmp("input_opt_with_addresses.mlir")
-                await self.do_call(progress_bar.task, ["aie-opt", f"--pass-pipeline={AIE_LOWER_TO_LLVM()}", file_with_addresses, "-o", file_opt_with_addresses])
+            if opts.only_npu:
+                return
 
+            if opts.unified:
                 file_llvmir = self.prepend_tmp("input.ll")
-                await self.do_call(progress_bar.task, ["aie-translate", "--mlir-to-llvmir", file_opt_with_addresses, "-o", file_llvmir])
-
+                if opts.execute:
+                    with self.stage("unified lowering"):
+                        unified = self.module.operation.clone()
+                        run_passes_in_place(
+                            AIE_LOWER_TO_LLVM().materialize(module=True),
+                            unified,
+                            self.opts.verbose,
+                        )
+                        await write_file_async(
+                            aiedialect.translate_mlir_to_llvmir(unified),
+                            file_llvmir,
+                        )
+
+                # fmt: off
                 self.unified_file_core_obj = self.prepend_tmp("input.o")
                 if opts.compile and opts.xchesscc:
                     file_llvmir_hacked = await self.chesshack(progress_bar.task, file_llvmir, aie_target)
@@ -1141,7 +1254,7 @@ class FlowRunner:
                     file_llvmir_opt = self.prepend_tmp("input.opt.ll")
                     await self.do_call(progress_bar.task, [self.peano_opt_path, "--passes=default<O2>", "-inline-threshold=10", "-S", file_llvmir, "-o", file_llvmir_opt])
                     await self.do_call(progress_bar.task, [self.peano_llc_path, file_llvmir_opt, "-O2", "--march=" + aie_target.lower(), "--function-sections", "--filetype=obj", "-o", self.unified_file_core_obj])
-            # fmt: on
+                # fmt: on
 
             progress_bar.update(progress_bar.task, advance=0, visible=False)
             progress_bar.task_completed = progress_bar.add_task(
@@ -1150,38 +1263,74 @@ class FlowRunner:
                 command="%d Workers" % nworkers,
             )
 
-            processes = [self.process_host_cgen(aie_target, file_with_addresses)]
-            await asyncio.gather(
-                *processes
-            )  # ensure that process_host_cgen finishes before running gen_sim
-            processes = []
-            if opts.aiesim:
-                processes.append(self.gen_sim(progress_bar.task, aie_target))
-            for core in cores:
-                processes.append(
-                    self.process_core(
-                        core,
-                        aie_target,
-                        aie_peano_target,
-                        file_with_addresses,
+            with self.stage("core modules"):
+                if not opts.unified and opts.execute:
+                    run_passes_in_place(
+                        AIE_SPLIT_CORE_MODULES(self.tmpdirname).materialize(
+                            module=True
+                        ),
+                        self.module.operation.clone(),
+                        self.opts.verbose,
                     )
-                )
-            await asyncio.gather(*processes)
+                # fmt: off
+                if opts.xbridge:
+                    await self.do_call(progress_bar.task, ["aie-translate", file_with_addresses, "--aie-generate-bcfs", "--work-dir-path=" + self.tmpdirname, "-o", os.devnull])
+                else:
+                    await self.do_call(progress_bar.task, ["aie-translate", file_with_addresses, "--aie-generate-ldscripts", "--work-dir-path=" + self.tmpdirname, "-o", os.devnull])
+                # fmt: on
+
+            file_physical = self.prepend_tmp("input_physical.mlirbc")
+            if opts.execute:
+                with self.stage("physical"):
+                    self.physical = self.module.operation.clone()
+                    run_passes_in_place(
+                        CREATE_PATH_FINDER_FLOWS.materialize(module=True),
+                        self.physical,
+                        self.opts.verbose,
+                    )
+                    self.write_module(self.physical, "input_physical")
+
+            with self.stage("host"):
+                # ensure that process_host_cgen finishes before running gen_sim
+                await self.process_host_cgen(aie_target, file_physical)
+
+            with self.stage("cores"):
+                processes = []
+                if opts.aiesim:
+                    processes.append(self.gen_sim(progress_bar.task, aie_target))
+                for core in cores:
+                    processes.append(
+                        self.process_core(
+                            core,
+                            aie_target,
+                            aie_peano_target,
+                            file_with_addresses,
+                        )
+                    )
+                await asyncio.gather(*processes)
 
             # Must have elfs, before we build the final binary assembly
             if opts.cdo and opts.execute:
-                await self.process_cdo()
+                with self.stage("cdo"):
+                    await self.process_cdo()
 
             if opts.cdo or opts.xcl:
-                await self.process_xclbin_gen()
+                with self.stage("xclbin"):
+                    await self.process_xclbin_gen()
 
             if opts.txn and opts.execute:
-                await self.process_txn()
+                with self.stage("transaction"):
+                    await self.process_txn()
 
             if opts.ctrlpkt and opts.execute:
-                await self.process_ctrlpkt()
+                with self.stage("control packets"):
+                    await self.process_ctrlpkt()
 
     def dumpprofile(self):
+        print("Stages:")
+        for stage, runtime in self.stage_runtimes.items():
+            print(f"{runtime:.4f} sec: {stage}")
+        print("Commands:")
         sortedruntimes = sorted(
             self.runtimes.items(), key=lambda item: item[1], reverse=True
         )
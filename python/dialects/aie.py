@@ -29,6 +29,7 @@ from .._mlir_libs._aie import (
     ObjectFifoType,
     get_target_model,
     aie_llvm_link,
+    decode_trace,
     generate_bcf,
     generate_cdo,
     generate_xaie,
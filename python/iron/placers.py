@@ -14,6 +14,7 @@ from .runtime import Runtime
 from .worker import Worker
 from .device import AnyComputeTile, AnyMemTile, AnyShimTile, Tile
 from .dataflow import ObjectFifoHandle
+from ..passmanager import PassManager
 
 
 class Placer(metaclass=ABCMeta):
@@ -39,6 +40,14 @@ class Placer(metaclass=ABCMeta):
         """
         ...
 
+    def finalize_placement(self, module):
+        """Adjust the placement once the MLIR of the program is generated. Does nothing by default.
+
+        Args:
+            module (Module): The module of the program.
+        """
+        pass
+
 
 class SequentialPlacer(Placer):
     """SequentialPlacer is a simple implementation of a placer. The SequentialPlacer is to named
@@ -130,3 +139,85 @@ class SequentialPlacer(Placer):
             if t.col == col:
                 return t
         raise ValueError(f"Failed to find a tile matching column {col}")
+
+
+class AnnealingPlacer(Placer):
+    """AnnealingPlacer places workers and object fifo endpoints with the aie-place-tiles pass, which searches
+    by simulated annealing for the placement that minimizes the wirelength of the object fifos while fitting
+    in the DMA channels and the memory of each tile and avoiding switchbox congestion, as given by the
+    target model of the device.
+
+    Each component that is not placed yet is first given a tile of its own, as long as there are free tiles
+    of its kind, near the compute tiles it communicates with. Once the MLIR of the program is generated, the
+    pass moves these tiles; the tiles of the components placed by the user stay in place.
+    """
+
+    def __init__(self, iterations: int = 20000, seed: int = 1):
+        """Initialize an AnnealingPlacer.
+
+        Args:
+            iterations (int, optional): The number of moves of the search. Defaults to 20000.
+            seed (int, optional): The seed of the random moves. Defaults to 1.
+        """
+        super().__init__()
+        self._iterations = iterations
+        self._seed = seed
+        self._fixed_tiles = set()
+
+    def make_placement(
+        self,
+        device: Device,
+        rt: Runtime,
+        workers: list[Worker],
+        object_fifos: list[ObjectFifoHandle],
+    ):
+        # Sort the fifos so that the placement does not depend on the set order
+        object_fifos = sorted(object_fifos, key=lambda of: of.name)
+
+        self._fixed_tiles = set()
+        for worker in workers:
+            if isinstance(worker.tile, Tile):
+                self._fixed_tiles.add(worker.tile)
+        for of in object_fifos:
+            for ofe in of.all_of_endpoints():
+                if isinstance(ofe.tile, Tile):
+                    self._fixed_tiles.add(ofe.tile)
+        used = set(self._fixed_tiles)
+
+        def take(col: int, tiles: list[Tile], kind: str) -> Tile:
+            # Prefer a free tile, then the tile closest to the column
+            if not tiles:
+                raise ValueError(f"Device {device} has no {kind} tiles")
+            tile = min(tiles, key=lambda t: (t in used, abs(t.col - col), t.col, t.row))
+            used.add(tile)
+            return tile
+
+        computes = device.get_compute_tiles()
+        for worker in workers:
+            if worker.tile == AnyComputeTile:
+                free = [t for t in computes if t not in used]
+                if not free:
+                    raise ValueError("Ran out of compute tiles for placement!")
+                worker.place(take(free[0].col, free, "compute"))
+            for buffer in worker.buffers:
+                buffer.place(worker.tile)
+
+        for of in object_fifos:
+            of_endpoints = of.all_of_endpoints()
+            cols = [ofe.tile.col for ofe in of_endpoints if isinstance(ofe.tile, Tile)]
+            col = round(statistics.mean(cols)) if cols else 0
+            for ofe in of_endpoints:
+                if ofe.tile == AnyMemTile:
+                    ofe.place(take(col, device.get_mem_tiles(), "mem"))
+                elif ofe.tile == AnyComputeTile:
+                    ofe.place(take(col, computes, "compute"))
+                elif ofe.tile == AnyShimTile:
+                    ofe.place(take(col, device.get_shim_tiles(), "shim"))
+
+    def finalize_placement(self, module):
+        options = [f"iterations={self._iterations}", f"seed={self._seed}"]
+        if self._fixed_tiles:
+            fixed = sorted(self._fixed_tiles, key=lambda t: (t.col, t.row))
+            options.append("fixed-tiles=" + ",".join(f"{t.col}:{t.row}" for t in fixed))
+        pipeline = f"builtin.module(aie.device(aie-place-tiles{{{' '.join(options)}}}))"
+        PassManager.parse(pipeline, context=module.context).run(module.operation)
@@ -90,6 +90,9 @@ class Program:
                 # In/Out Sequence
                 self._rt.resolve()
 
+            if placer:
+                placer.finalize_placement(ctx.module)
+
             self._print_verify(ctx)
             return ctx.module
 
@@ -194,6 +194,15 @@ def write_out_trace(trace, file_name):
         f.write(out_str)
 
 
+def write_trace_json(trace, module, file_name, colshift=0):
+    """Decode the trace words `trace`, e.g. as returned by extract_trace, into
+    a Chrome/Perfetto JSON trace in `file_name`, naming the events from the
+    npu.write32 ops configuring them in the design `module`. The trace is
+    decoded in C++ as it is written out, so large trace buffers are fine."""
+    words = np.asarray(trace, dtype=np.uint32).tobytes()
+    decode_trace(module.operation, words, file_name, colshift)
+
+
 def pack4bytes(b3, b2, b1, b0):
     w = (b3 & 0xFF) << 24
     w |= (b2 & 0xFF) << 16
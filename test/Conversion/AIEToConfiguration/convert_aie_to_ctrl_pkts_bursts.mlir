@@ -0,0 +1,39 @@
+//===- convert_aie_to_ctrl_pkts_bursts.mlir --------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt -convert-aie-to-control-packets="elf-dir=%S/convert_aie_to_ctrl_pkts_elfs/ pack-bursts=true sort-by-tile=true" %s | FileCheck %s
+// RUN: aie-opt -convert-aie-to-control-packets="elf-dir=%S/convert_aie_to_ctrl_pkts_elfs/" -mlir-pass-statistics %s -o /dev/null 2> %t.unpacked
+// RUN: aie-opt -convert-aie-to-control-packets="elf-dir=%S/convert_aie_to_ctrl_pkts_elfs/ pack-bursts=true" -mlir-pass-statistics %s -o /dev/null 2> %t.packed
+// RUN: cat %t.unpacked %t.packed | FileCheck %s --check-prefix=STATS
+
+// Packets carry at most four words.
+
+// CHECK-LABEL: aiex.runtime_sequence @configure
+// CHECK:       aiex.control_packet {address = {{.*}} : ui32, data = array<i32: {{.*}}, {{.*}}, {{.*}}, {{.*}}>
+// CHECK-NOT:   data = array<i32: {{[^,>]*}}, {{[^,>]*}}, {{[^,>]*}}, {{[^,>]*}}, {{[^,>]*}}
+
+// Packing takes fewer packets for the same words.
+
+// STATS:       ConvertAIEToControlPackets
+// STATS-NEXT:    (S) [[UNPACKED:[0-9]+]] num-packets
+// STATS-NEXT:    (S) [[WORDS:[0-9]+]] num-words
+// STATS:       ConvertAIEToControlPackets
+// STATS-NOT:     (S) [[UNPACKED]] num-packets
+// STATS:         (S) [[WORDS]] num-words
+aie.device(npu1_1col) {
+  %12 = aie.tile(0, 2)
+  %buf = aie.buffer(%12) : memref<256xi32>
+  %4 = aie.core(%12)  {
+    %0 = arith.constant 0 : i32
+    %1 = arith.constant 0 : index
+    memref.store %0, %buf[%1] : memref<256xi32>
+    aie.end
+  }
+}
@@ -0,0 +1,135 @@
+//===- convert_aie_to_transaction_delta.mlir -------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt -split-input-file -convert-aie-to-transaction-delta="elf-dir=%S/convert_aie_to_ctrl_pkts_elfs/ from-elf-dir=%S/convert_aie_to_ctrl_pkts_elfs/" %s | FileCheck %s
+// RUN: aie-opt -split-input-file -convert-aie-to-transaction-delta="elf-dir=%S/convert_aie_to_ctrl_pkts_elfs/ from-elf-dir=%S/convert_aie_to_ctrl_pkts_elfs/" -mlir-pass-statistics %s -o /dev/null 2>&1 | FileCheck %s --check-prefix=STATS
+
+// Only the switchbox of the mem tile changes: the core keeps its ELF, and
+// the only writes are the ones to the stream switch of the mem tile.
+
+// STATS:       ConvertAIEToTransactionDelta
+// STATS-NEXT:    (S) 1 num-changed-tiles
+
+// CHECK-LABEL: aie.device(npu1_1col)
+// CHECK-NOT:   aiex.runtime_sequence
+// CHECK-LABEL: aie.device(npu1_1col)
+// CHECK:       aiex.runtime_sequence @configure
+// CHECK-NOT:   aiex.npu.blockwrite
+// CHECK:       aiex.npu.write32 {address = {{[0-9]+}} : ui32, value = {{[0-9]+}} : ui32}
+// CHECK-NOT:   aiex.npu.blockwrite
+// CHECK:       }
+module {
+  aie.device(npu1_1col) {
+    %t01 = aie.tile(0, 1)
+    %t02 = aie.tile(0, 2)
+    %buf = aie.buffer(%t02) : memref<256xi32>
+    %core = aie.core(%t02) {
+      aie.end
+    }
+    %sb = aie.switchbox(%t01) {
+      aie.connect<DMA : 0, North : 0>
+    }
+  }
+  aie.device(npu1_1col) {
+    %t01 = aie.tile(0, 1)
+    %t02 = aie.tile(0, 2)
+    %buf = aie.buffer(%t02) : memref<256xi32>
+    %core = aie.core(%t02) {
+      aie.end
+    }
+    %sb = aie.switchbox(%t01) {
+      aie.connect<DMA : 1, North : 1>
+    }
+  }
+}
+
+// -----
+
+// Moving to the same design changes nothing.
+
+// STATS:       ConvertAIEToTransactionDelta
+// STATS-NEXT:    (S) 0 num-changed-tiles
+// STATS-NEXT:    (S) 0 num-operations
+
+// CHECK-LABEL: aie.device(npu1_1col)
+// CHECK-LABEL: aiex.runtime_sequence @configure
+// CHECK-NOT:   aiex.npu
+module {
+  aie.device(npu1_1col) {
+    %t02 = aie.tile(0, 2)
+    %core = aie.core(%t02) {
+      aie.end
+    }
+  }
+  aie.device(npu1_1col) {
+    %t02 = aie.tile(0, 2)
+    %core = aie.core(%t02) {
+      aie.end
+    }
+  }
+}
+
+
+// -----
+
+// Only the initial value of a lock changes. All the locks of the mem tile are
+// cleared before the lock is initialized again.
+
+// STATS:       ConvertAIEToTransactionDelta
+// STATS-NEXT:    (S) 1 num-changed-tiles
+
+// CHECK-LABEL: aie.device(npu1_1col)
+// CHECK-NOT:   aiex.runtime_sequence
+// CHECK-LABEL: aie.device(npu1_1col)
+// CHECK:       aiex.runtime_sequence @configure
+// CHECK:       aiex.npu.write32 {address = 1835008 : ui32, value = 0 : ui32}
+// CHECK:       aiex.npu.write32 {address = 1835024 : ui32, value = 0 : ui32}
+// CHECK:       aiex.npu.write32 {address = 1835008 : ui32, value = 2 : ui32}
+// CHECK:       }
+module {
+  aie.device(npu1_1col) {
+    %t01 = aie.tile(0, 1)
+    %l0 = aie.lock(%t01, 0) {init = 1 : i32}
+    %l1 = aie.lock(%t01, 1) {init = 1 : i32}
+  }
+  aie.device(npu1_1col) {
+    %t01 = aie.tile(0, 1)
+    %l0 = aie.lock(%t01, 0) {init = 2 : i32}
+  }
+}
+
+// -----
+
+// The mem tile is only used by the old design: it is reset, its locks are
+// cleared and its stream switch settings are undone.
+
+// STATS:       ConvertAIEToTransactionDelta
+// STATS-NEXT:    (S) 1 num-changed-tiles
+
+// CHECK-LABEL: aie.device(npu1_1col)
+// CHECK-NOT:   aiex.runtime_sequence
+// CHECK-LABEL: aie.device(npu1_1col)
+// CHECK:       aiex.runtime_sequence @configure
+// CHECK:       aiex.npu.write32 {address = 1835008 : ui32, value = 0 : ui32}
+// CHECK-NOT:   aiex.npu.write32 {address = 1835008 : ui32, value = 1 : ui32}
+// CHECK:       aiex.npu.write32 {address = {{[0-9]+}} : ui32, value = 0 : ui32}
+// CHECK:       }
+module {
+  aie.device(npu1_1col) {
+    %t01 = aie.tile(0, 1)
+    %l0 = aie.lock(%t01, 0) {init = 1 : i32}
+    %sb = aie.switchbox(%t01) {
+      aie.connect<DMA : 0, North : 0>
+    }
+  }
+  aie.device(npu1_1col) {
+    %t02 = aie.tile(0, 2)
+  }
+}
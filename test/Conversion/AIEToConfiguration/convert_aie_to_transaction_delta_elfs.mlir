@@ -0,0 +1,39 @@
+//===- convert_aie_to_transaction_delta_elfs.mlir --------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt -convert-aie-to-transaction-delta="elf-dir=%S/convert_aie_to_ctrl_pkts_elfs/" %s | FileCheck %s
+// RUN: aie-opt -convert-aie-to-transaction-delta="elf-dir=%S/convert_aie_to_ctrl_pkts_elfs/" -mlir-pass-statistics %s -o /dev/null 2>&1 | FileCheck %s --check-prefix=STATS
+
+// Without from-elf-dir the ELF the core runs is unknown, so the ELF of the
+// new design is loaded even though the designs are the same: a changed
+// program is never mistaken for the old one.
+
+// STATS:       ConvertAIEToTransactionDelta
+// STATS-NEXT:    (S) 1 num-changed-tiles
+
+// CHECK-LABEL: aie.device(npu1_1col)
+// CHECK-NOT:   aiex.runtime_sequence
+// CHECK-LABEL: aie.device(npu1_1col)
+// CHECK:       aiex.runtime_sequence @configure
+// CHECK:       aiex.npu.blockwrite
+module {
+  aie.device(npu1_1col) {
+    %t02 = aie.tile(0, 2)
+    %core = aie.core(%t02) {
+      aie.end
+    }
+  }
+  aie.device(npu1_1col) {
+    %t02 = aie.tile(0, 2)
+    %core = aie.core(%t02) {
+      aie.end
+    }
+  }
+}
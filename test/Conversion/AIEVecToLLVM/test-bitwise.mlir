@@ -0,0 +1,88 @@
+// RUN: aie-opt %s -split-input-file -convert-aievec-to-llvm | FileCheck %s
+
+// The bitwise operations and aievec.neg deliberately stay generic LLVM
+// operations: XLLVM has no intrinsic for them, and the backend selects the
+// vector instructions for the LLVM operations.
+
+func.func @i8_band(%arg0 : vector<64xi8>, %arg1 : vector<64xi8>) -> vector<64xi8> {
+  %0 = aievec.band %arg0, %arg1 : vector<64xi8>, vector<64xi8>, vector<64xi8>
+  return %0 : vector<64xi8>
+}
+
+// CHECK-LABEL: @i8_band
+// CHECK-SAME: %[[ARG0:.*]]: vector<64xi8>,
+// CHECK-SAME: %[[ARG1:.*]]: vector<64xi8>
+// CHECK: %[[LHS:.*]] = llvm.bitcast %[[ARG0]] : vector<64xi8> to vector<16xi32>
+// CHECK-NEXT: %[[RHS:.*]] = llvm.bitcast %[[ARG1]] : vector<64xi8> to vector<16xi32>
+// CHECK-NEXT: %[[AND:.*]] = llvm.and %[[LHS]], %[[RHS]] : vector<16xi32>
+// CHECK-NEXT: %[[RES:.*]] = llvm.bitcast %[[AND]] : vector<16xi32> to vector<64xi8>
+// CHECK-NEXT: return %[[RES]] : vector<64xi8>
+
+// -----
+
+func.func @i16_bor(%arg0 : vector<32xi16>, %arg1 : vector<32xi16>) -> vector<32xi16> {
+  %0 = aievec.bor %arg0, %arg1 : vector<32xi16>, vector<32xi16>, vector<32xi16>
+  return %0 : vector<32xi16>
+}
+
+// CHECK-LABEL: @i16_bor
+// CHECK-SAME: %[[ARG0:.*]]: vector<32xi16>,
+// CHECK-SAME: %[[ARG1:.*]]: vector<32xi16>
+// CHECK: %[[LHS:.*]] = llvm.bitcast %[[ARG0]] : vector<32xi16> to vector<16xi32>
+// CHECK-NEXT: %[[RHS:.*]] = llvm.bitcast %[[ARG1]] : vector<32xi16> to vector<16xi32>
+// CHECK-NEXT: %[[OR:.*]] = llvm.or %[[LHS]], %[[RHS]] : vector<16xi32>
+// CHECK-NEXT: %[[RES:.*]] = llvm.bitcast %[[OR]] : vector<16xi32> to vector<32xi16>
+// CHECK-NEXT: return %[[RES]] : vector<32xi16>
+
+// -----
+
+func.func @i32_bxor(%arg0 : vector<16xi32>, %arg1 : vector<16xi32>) -> vector<16xi32> {
+  %0 = aievec.bxor %arg0, %arg1 : vector<16xi32>, vector<16xi32>, vector<16xi32>
+  return %0 : vector<16xi32>
+}
+
+// CHECK-LABEL: @i32_bxor
+// CHECK-SAME: %[[ARG0:.*]]: vector<16xi32>,
+// CHECK-SAME: %[[ARG1:.*]]: vector<16xi32>
+// CHECK: %[[XOR:.*]] = llvm.xor %[[ARG0]], %[[ARG1]] : vector<16xi32>
+// CHECK-NEXT: return %[[XOR]] : vector<16xi32>
+
+// -----
+
+func.func @bf16_bneg(%arg0 : vector<32xbf16>) -> vector<32xbf16> {
+  %0 = aievec.bneg %arg0 : vector<32xbf16>
+  return %0 : vector<32xbf16>
+}
+
+// CHECK-LABEL: @bf16_bneg
+// CHECK-SAME: %[[ARG0:.*]]: vector<32xbf16>
+// CHECK: %[[SRC:.*]] = llvm.bitcast %[[ARG0]] : vector<32xbf16> to vector<16xi32>
+// CHECK-NEXT: %[[ONES:.*]] = llvm.mlir.constant(dense<-1> : vector<16xi32>) : vector<16xi32>
+// CHECK-NEXT: %[[XOR:.*]] = llvm.xor %[[SRC]], %[[ONES]] : vector<16xi32>
+// CHECK-NEXT: %[[RES:.*]] = llvm.bitcast %[[XOR]] : vector<16xi32> to vector<32xbf16>
+// CHECK-NEXT: return %[[RES]] : vector<32xbf16>
+
+// -----
+
+func.func @i32_neg(%arg0 : vector<16xi32>) -> vector<16xi32> {
+  %0 = aievec.neg %arg0 : vector<16xi32>
+  return %0 : vector<16xi32>
+}
+
+// CHECK-LABEL: @i32_neg
+// CHECK-SAME: %[[ARG0:.*]]: vector<16xi32>
+// CHECK: %[[ZERO:.*]] = llvm.mlir.constant(dense<0> : vector<16xi32>) : vector<16xi32>
+// CHECK-NEXT: %[[NEG:.*]] = llvm.sub %[[ZERO]], %[[ARG0]] : vector<16xi32>
+// CHECK-NEXT: return %[[NEG]] : vector<16xi32>
+
+// -----
+
+func.func @f32_neg(%arg0 : vector<16xf32>) -> vector<16xf32> {
+  %0 = aievec.neg %arg0 : vector<16xf32>
+  return %0 : vector<16xf32>
+}
+
+// CHECK-LABEL: @f32_neg
+// CHECK-SAME: %[[ARG0:.*]]: vector<16xf32>
+// CHECK: %[[NEG:.*]] = llvm.fneg %[[ARG0]] : vector<16xf32>
+// CHECK-NEXT: return %[[NEG]] : vector<16xf32>
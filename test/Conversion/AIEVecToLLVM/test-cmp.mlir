@@ -0,0 +1,126 @@
+// RUN: aie-opt %s -split-input-file -convert-aievec-to-llvm | FileCheck %s
+
+func.func @i32_sgt(%arg0 : vector<16xi32>, %arg1 : vector<16xi32>) -> ui32 {
+  %0 = aievec.cmp %arg0, %arg1 {pred = "sgt"} : vector<16xi32>, vector<16xi32>, ui32
+  return %0 : ui32
+}
+
+// CHECK-LABEL: @i32_sgt
+// CHECK-SAME: %[[ARG0:.*]]: vector<16xi32>,
+// CHECK-SAME: %[[ARG1:.*]]: vector<16xi32>
+// CHECK: %[[SIGN:.*]] = llvm.mlir.constant(1 : i32) : i32
+// CHECK-NEXT: %[[VMAX:.*]] = "xllvm.intr.aie2.vmax.lt32"(
+// CHECK-SAME: %[[ARG1]], %[[ARG0]], %[[SIGN]]) :
+// CHECK-SAME: (vector<16xi32>, vector<16xi32>, i32) -> !llvm.struct<(vector<16xi32>, i32)>
+// CHECK-NEXT: %[[MASK:.*]] = llvm.extractvalue %[[VMAX]][1] : !llvm.struct<(vector<16xi32>, i32)>
+// CHECK-NEXT: %[[RES:.*]] = builtin.unrealized_conversion_cast %[[MASK]] : i32 to ui32
+// CHECK-NEXT: return %[[RES]] : ui32
+
+// -----
+
+func.func @i16_ult(%arg0 : vector<32xi16>, %arg1 : vector<32xi16>) -> ui32 {
+  %0 = aievec.cmp %arg0, %arg1 {pred = "ult"} : vector<32xi16>, vector<32xi16>, ui32
+  return %0 : ui32
+}
+
+// CHECK-LABEL: @i16_ult
+// CHECK-SAME: %[[ARG0:.*]]: vector<32xi16>,
+// CHECK-SAME: %[[ARG1:.*]]: vector<32xi16>
+// CHECK: %[[SIGN:.*]] = llvm.mlir.constant(0 : i32) : i32
+// CHECK-NEXT: %[[VMAX:.*]] = "xllvm.intr.aie2.vmax.lt16"(
+// CHECK-SAME: %[[ARG0]], %[[ARG1]], %[[SIGN]]) :
+// CHECK-SAME: (vector<32xi16>, vector<32xi16>, i32) -> !llvm.struct<(vector<32xi16>, i32)>
+// CHECK-NEXT: %[[MASK:.*]] = llvm.extractvalue %[[VMAX]][1] : !llvm.struct<(vector<32xi16>, i32)>
+
+// -----
+
+func.func @i8_uge(%arg0 : vector<64xi8>, %arg1 : vector<64xi8>) -> ui64 {
+  %0 = aievec.cmp %arg0, %arg1 {pred = "uge"} : vector<64xi8>, vector<64xi8>, ui64
+  return %0 : ui64
+}
+
+// CHECK-LABEL: @i8_uge
+// CHECK-SAME: %[[ARG0:.*]]: vector<64xi8>,
+// CHECK-SAME: %[[ARG1:.*]]: vector<64xi8>
+// CHECK: %[[SIGN:.*]] = llvm.mlir.constant(0 : i32) : i32
+// CHECK-NEXT: %[[VMIN:.*]] = "xllvm.intr.aie2.vmin.ge8"(
+// CHECK-SAME: %[[ARG0]], %[[ARG1]], %[[SIGN]]) :
+// CHECK-SAME: (vector<64xi8>, vector<64xi8>, i32) -> !llvm.struct<(vector<64xi8>, vector<2xi32>)>
+// CHECK-NEXT: %[[MASK:.*]] = llvm.extractvalue %[[VMIN]][1] : !llvm.struct<(vector<64xi8>, vector<2xi32>)>
+// CHECK-NEXT: %[[MASK64:.*]] = llvm.bitcast %[[MASK]] : vector<2xi32> to i64
+// CHECK-NEXT: %[[RES:.*]] = builtin.unrealized_conversion_cast %[[MASK64]] : i64 to ui64
+
+// -----
+
+func.func @bf16_sle(%arg0 : vector<32xbf16>, %arg1 : vector<32xbf16>) -> ui32 {
+  %0 = aievec.cmp %arg0, %arg1 {pred = "sle"} : vector<32xbf16>, vector<32xbf16>, ui32
+  return %0 : ui32
+}
+
+// CHECK-LABEL: @bf16_sle
+// CHECK-SAME: %[[ARG0:.*]]: vector<32xbf16>,
+// CHECK-SAME: %[[ARG1:.*]]: vector<32xbf16>
+// CHECK: %[[VMIN:.*]] = "xllvm.intr.aie2.vmin.gebf16"(%[[ARG1]], %[[ARG0]]) :
+// CHECK-SAME: (vector<32xbf16>, vector<32xbf16>) -> !llvm.struct<(vector<32xbf16>, i32)>
+// CHECK-NEXT: %[[MASK:.*]] = llvm.extractvalue %[[VMIN]][1] : !llvm.struct<(vector<32xbf16>, i32)>
+
+// -----
+
+// Equalities, and every comparison of f32 lanes, deliberately stay generic
+// LLVM comparisons: XLLVM has no intrinsic for them, and the backend lowers
+// llvm.icmp and llvm.fcmp itself.
+
+func.func @i32_eq(%arg0 : vector<16xi32>, %arg1 : vector<16xi32>) -> ui32 {
+  %0 = aievec.cmp %arg0, %arg1 {pred = "eq"} : vector<16xi32>, vector<16xi32>, ui32
+  return %0 : ui32
+}
+
+// CHECK-LABEL: @i32_eq
+// CHECK-SAME: %[[ARG0:.*]]: vector<16xi32>,
+// CHECK-SAME: %[[ARG1:.*]]: vector<16xi32>
+// CHECK: %[[CMP:.*]] = llvm.icmp "eq" %[[ARG0]], %[[ARG1]] : vector<16xi32>
+// CHECK-NEXT: %[[MASK:.*]] = llvm.bitcast %[[CMP]] : vector<16xi1> to i16
+// CHECK-NEXT: %[[MASK32:.*]] = llvm.zext %[[MASK]] : i16 to i32
+
+// -----
+
+func.func @f32_slt(%arg0 : vector<16xf32>, %arg1 : vector<16xf32>) -> ui32 {
+  %0 = aievec.cmp %arg0, %arg1 {pred = "slt"} : vector<16xf32>, vector<16xf32>, ui32
+  return %0 : ui32
+}
+
+// CHECK-LABEL: @f32_slt
+// CHECK-SAME: %[[ARG0:.*]]: vector<16xf32>,
+// CHECK-SAME: %[[ARG1:.*]]: vector<16xf32>
+// CHECK: %[[CMP:.*]] = llvm.fcmp "olt" %[[ARG0]], %[[ARG1]] : vector<16xf32>
+// CHECK-NEXT: %[[MASK:.*]] = llvm.bitcast %[[CMP]] : vector<16xi1> to i16
+// CHECK-NEXT: %[[MASK32:.*]] = llvm.zext %[[MASK]] : i16 to i32
+
+// -----
+
+func.func @i16_ne(%arg0 : vector<32xi16>, %arg1 : vector<32xi16>) -> ui32 {
+  %0 = aievec.cmp %arg0, %arg1 {pred = "ne"} : vector<32xi16>, vector<32xi16>, ui32
+  return %0 : ui32
+}
+
+// CHECK-LABEL: @i16_ne
+// CHECK-SAME: %[[ARG0:.*]]: vector<32xi16>,
+// CHECK-SAME: %[[ARG1:.*]]: vector<32xi16>
+// CHECK: %[[CMP:.*]] = llvm.icmp "ne" %[[ARG0]], %[[ARG1]] : vector<32xi16>
+// CHECK-NEXT: %[[MASK:.*]] = llvm.bitcast %[[CMP]] : vector<32xi1> to i32
+// CHECK-NEXT: %[[RES:.*]] = builtin.unrealized_conversion_cast %[[MASK]] : i32 to ui32
+// CHECK-NEXT: return %[[RES]] : ui32
+
+// -----
+
+func.func @f32_eq(%arg0 : vector<16xf32>, %arg1 : vector<16xf32>) -> ui32 {
+  %0 = aievec.cmp %arg0, %arg1 {pred = "eq"} : vector<16xf32>, vector<16xf32>, ui32
+  return %0 : ui32
+}
+
+// CHECK-LABEL: @f32_eq
+// CHECK-SAME: %[[ARG0:.*]]: vector<16xf32>,
+// CHECK-SAME: %[[ARG1:.*]]: vector<16xf32>
+// CHECK: %[[CMP:.*]] = llvm.fcmp "oeq" %[[ARG0]], %[[ARG1]] : vector<16xf32>
+// CHECK-NEXT: %[[MASK:.*]] = llvm.bitcast %[[CMP]] : vector<16xi1> to i16
+// CHECK-NEXT: %[[MASK32:.*]] = llvm.zext %[[MASK]] : i16 to i32
@@ -0,0 +1,74 @@
+// RUN: aie-opt %s -split-input-file -convert-aievec-to-llvm | FileCheck %s
+
+func.func @i8_mul_conv_32x8(%arg0 : vector<64xi8>, %arg1 : vector<64xi8>) -> vector<32xi32> {
+  %0 = aievec.mul_conv %arg0, %arg1 {M = 32 : i32, N = 8 : i32} : vector<64xi8>, vector<64xi8>, vector<32xi32>
+  return %0 : vector<32xi32>
+}
+
+// CHECK-LABEL: @i8_mul_conv_32x8
+// CHECK-SAME: %[[ARG0:.*]]: vector<64xi8>,
+// CHECK-SAME: %[[ARG1:.*]]: vector<64xi8>
+// CHECK: %[[CST:.*]] = llvm.mlir.constant(872 : i32) : i32
+// CHECK-NEXT: %[[BITCAST1:.*]] = llvm.bitcast %[[ARG1]] : vector<64xi8> to vector<16xi32>
+// CHECK-NEXT: %[[MULCONF:.*]] = "xllvm.intr.aie2.I512.I512.acc32.mul.conf"(
+// CHECK-SAME: %[[ARG0]], %[[BITCAST1]], %[[CST]]) :
+// CHECK-SAME: (vector<64xi8>, vector<16xi32>, i32) -> vector<16xi64>
+// CHECK-NEXT: %[[RES:.*]] = llvm.bitcast %[[MULCONF]] : vector<16xi64> to vector<32xi32>
+// CHECK-NEXT: return %[[RES]] : vector<32xi32>
+
+// -----
+
+func.func @i16_mul_conv_16x4(%arg0 : vector<32xi16>, %arg1 : vector<32xi16>) -> vector<16xi64> {
+  %0 = aievec.mul_conv %arg0, %arg1 {M = 16 : i32, N = 4 : i32} : vector<32xi16>, vector<32xi16>, vector<16xi64>
+  return %0 : vector<16xi64>
+}
+
+// CHECK-LABEL: @i16_mul_conv_16x4
+// CHECK-SAME: %[[ARG0:.*]]: vector<32xi16>,
+// CHECK-SAME: %[[ARG1:.*]]: vector<32xi16>
+// CHECK: %[[CST:.*]] = llvm.mlir.constant(890 : i32) : i32
+// CHECK-NEXT: %[[BITCAST0:.*]] = llvm.bitcast %[[ARG0]] : vector<32xi16> to vector<64xi8>
+// CHECK-NEXT: %[[BITCAST1:.*]] = llvm.bitcast %[[ARG1]] : vector<32xi16> to vector<16xi32>
+// CHECK-NEXT: %[[MULCONF:.*]] = "xllvm.intr.aie2.I512.I512.acc64.mul.conf"(
+// CHECK-SAME: %[[BITCAST0]], %[[BITCAST1]], %[[CST]]) :
+// CHECK-SAME: (vector<64xi8>, vector<16xi32>, i32) -> vector<16xi64>
+// CHECK-NEXT: return %[[MULCONF]] : vector<16xi64>
+
+// -----
+
+func.func @i8_fma_conv_32x8(%arg0 : vector<64xi8>, %arg1 : vector<64xi8>, %arg2 : vector<32xi32>) -> vector<32xi32> {
+  %0 = aievec.fma_conv %arg0, %arg1, %arg2 {M = 32 : i32, N = 8 : i32} : vector<64xi8>, vector<64xi8>, vector<32xi32>
+  return %0 : vector<32xi32>
+}
+
+// CHECK-LABEL: @i8_fma_conv_32x8
+// CHECK-SAME: %[[ARG0:.*]]: vector<64xi8>,
+// CHECK-SAME: %[[ARG1:.*]]: vector<64xi8>,
+// CHECK-SAME: %[[ARG2:.*]]: vector<32xi32>
+// CHECK: %[[CST:.*]] = llvm.mlir.constant(872 : i32) : i32
+// CHECK-NEXT: %[[BITCAST1:.*]] = llvm.bitcast %[[ARG1]] : vector<64xi8> to vector<16xi32>
+// CHECK-NEXT: %[[BITCAST2:.*]] = llvm.bitcast %[[ARG2]] : vector<32xi32> to vector<16xi64>
+// CHECK-NEXT: %[[MACCONF:.*]] = "xllvm.intr.aie2.I512.I512.ACC1024.acc32.mac.conf"(
+// CHECK-SAME: %[[ARG0]], %[[BITCAST1]], %[[BITCAST2]], %[[CST]]) :
+// CHECK-SAME: (vector<64xi8>, vector<16xi32>, vector<16xi64>, i32) -> vector<16xi64>
+// CHECK-NEXT: %[[RES:.*]] = llvm.bitcast %[[MACCONF]] : vector<16xi64> to vector<32xi32>
+// CHECK-NEXT: return %[[RES]] : vector<32xi32>
+
+// -----
+
+func.func @i16_fms_conv_16x4(%arg0 : vector<32xi16>, %arg1 : vector<32xi16>, %arg2 : vector<16xi64>) -> vector<16xi64> {
+  %0 = aievec.fma_conv %arg0, %arg1, %arg2 {M = 16 : i32, N = 4 : i32, fmsub = true} : vector<32xi16>, vector<32xi16>, vector<16xi64>
+  return %0 : vector<16xi64>
+}
+
+// CHECK-LABEL: @i16_fms_conv_16x4
+// CHECK-SAME: %[[ARG0:.*]]: vector<32xi16>,
+// CHECK-SAME: %[[ARG1:.*]]: vector<32xi16>,
+// CHECK-SAME: %[[ARG2:.*]]: vector<16xi64>
+// CHECK: %[[CST:.*]] = llvm.mlir.constant(2938 : i32) : i32
+// CHECK-NEXT: %[[BITCAST0:.*]] = llvm.bitcast %[[ARG0]] : vector<32xi16> to vector<64xi8>
+// CHECK-NEXT: %[[BITCAST1:.*]] = llvm.bitcast %[[ARG1]] : vector<32xi16> to vector<16xi32>
+// CHECK-NEXT: %[[MACCONF:.*]] = "xllvm.intr.aie2.I512.I512.ACC1024.acc64.mac.conf"(
+// CHECK-SAME: %[[BITCAST0]], %[[BITCAST1]], %[[ARG2]], %[[CST]]) :
+// CHECK-SAME: (vector<64xi8>, vector<16xi32>, vector<16xi64>, i32) -> vector<16xi64>
+// CHECK-NEXT: return %[[MACCONF]] : vector<16xi64>
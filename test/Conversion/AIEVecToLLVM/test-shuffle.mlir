@@ -64,3 +64,19 @@ func.func @shuffle_two_operands_cast(%lhs : vector<32xbf16>,
   // CHECK: return %[[R]] : vector<32xbf16>
   return %0 : vector<32xbf16>
 }
+
+// -----
+
+// CHECK-LABEL: @legacyshuffle
+// CHECK-SAME: %[[V:.*]]: vector<64xi8>
+func.func @legacyshuffle(%src : vector<64xi8>) -> vector<64xi8> {
+  // CHECK: %[[M:.*]] = llvm.mlir.constant(0 : i32) : i32
+  // CHECK: %[[RHS:.*]] = "xllvm.intr.aie2.v16int32"() : () -> vector<16xi32>
+  // CHECK: %[[LHS:.*]] = llvm.bitcast %[[V]] : vector<64xi8> to vector<16xi32>
+  // CHECK: %[[S:.*]] = "xllvm.intr.aie2.vshuffle"(%[[LHS]], %[[RHS]], %[[M]]) :
+  // CHECK-SAME:         (vector<16xi32>, vector<16xi32>, i32) -> vector<16xi32>
+  // CHECK: %[[R:.*]] = llvm.bitcast %[[S]] : vector<16xi32> to vector<64xi8>
+  %0 = aievec.legacyshuffle %src {mode = 0 : i32} : vector<64xi8>, vector<64xi8>
+  // CHECK: return %[[R]] : vector<64xi8>
+  return %0 : vector<64xi8>
+}
@@ -0,0 +1,124 @@
+//===- dma_to_npu_bd_limits.mlir -------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --split-input-file --aie-dma-to-npu --verify-diagnostics %s
+
+// Transfers exceeding the fields of a BD are legal in the IR, so that
+// aie-split-access-patterns can split them, but cannot be lowered as they are.
+
+module {
+  aie.device(npu1_4col) {
+    aiex.runtime_sequence(%in : memref<1920x1080xi32>, %buf : memref<32xi32>, %out : memref<1920x1080xi32>) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c1920 = arith.constant 1920 : i64
+      %c1080 = arith.constant 1080 : i64
+      // expected-error@+2 {{failed to legalize operation 'aiex.npu.dma_memcpy_nd' that was explicitly marked illegal}}
+      // expected-error@+1 {{Size 0 exceeds the [0:1023] range}}
+      aiex.npu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c1080,%c1920][%c0,%c0,%c1920,%c1]) { metadata = @of_fromMem, id = 0 : i64 } : memref<1920x1080xi32>
+    }
+    aie.shim_dma_allocation @of_fromMem (MM2S, 0, 0)
+  }
+}
+
+// -----
+
+module {
+  aie.device(npu1_4col) {
+    aiex.runtime_sequence(%in : memref<128x4x2x8xi32>, %buf : memref<32xi32>, %out : memref<8192xi32>) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c2 = arith.constant 2 : i64
+      %c4 = arith.constant 4 : i64
+      %c8 = arith.constant 8 : i64
+      %c16 = arith.constant 16 : i64
+      %c32 = arith.constant 32 : i64
+      %c128 = arith.constant 128 : i64
+      // expected-error@+2 {{failed to legalize operation 'aiex.npu.dma_memcpy_nd' that was explicitly marked illegal}}
+      // expected-error@+1 {{Size 3 exceeds the [1:64] range}}
+      aiex.npu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c128,%c2,%c2,%c8][%c0,%c16,%c8,%c1]) { metadata = @of_fromMem, id = 0 : i64 } : memref<128x4x2x8xi32>
+    }
+    aie.shim_dma_allocation @of_fromMem (MM2S, 0, 0)
+  }
+}
+
+// -----
+
+module {
+  aie.device(npu1_4col) {
+    aiex.runtime_sequence(%in : memref<8388608xi32>, %buf : memref<32xi32>, %out : memref<8388608xi32>) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c2 = arith.constant 2 : i64
+      %c2097152 = arith.constant 2097152 : i64
+      // expected-error@+2 {{failed to legalize operation 'aiex.npu.dma_memcpy_nd' that was explicitly marked illegal}}
+      // expected-error@+1 {{Stride 1 exceeds the [1:1048576] range}}
+      aiex.npu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c2,%c2][%c0,%c0,%c2097152,%c1]) { metadata = @of_fromMem, id = 0 : i64 } : memref<8388608xi32>
+    }
+    aie.shim_dma_allocation @of_fromMem (MM2S, 0, 0)
+  }
+}
+
+// -----
+
+// 2048 i8s are 512 words, which fit into size 0.
+
+module {
+  aie.device(npu1_4col) {
+    aiex.runtime_sequence(%a : memref<8xi8>) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c2 = arith.constant 2 : i64
+      %c4 = arith.constant 4 : i64
+      %c2048 = arith.constant 2048 : i64
+      aiex.npu.dma_memcpy_nd (0, 0, %a[%c0,%c0,%c0,%c0][%c1,%c1,%c2,%c2048][%c0,%c0,%c4,%c1]) { metadata = @objectfifo, id = 0 : i64 } : memref<8xi8>
+    }
+    aie.shim_dma_allocation @objectfifo (MM2S, 0, 0)
+  }
+}
+
+module {
+  aie.device(npu1_4col) {
+    aiex.runtime_sequence(%a : memref<8xi16>) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c2 = arith.constant 2 : i64
+      %c4 = arith.constant 4 : i64
+      %c8 = arith.constant 8 : i64
+      %c2048 = arith.constant 2048 : i64
+      // expected-error@+2 {{failed to legalize operation 'aiex.npu.dma_memcpy_nd' that was explicitly marked illegal}}
+      // expected-error@+1 {{Size 0 exceeds the [0:1023] range}}
+      aiex.npu.dma_memcpy_nd (0, 0, %a[%c0,%c0,%c0,%c0][%c1,%c1,%c2,%c2048][%c0,%c0,%c4,%c1]) { metadata = @objectfifo, id = 0 : i64 } : memref<8xi16>
+    }
+    aie.shim_dma_allocation @objectfifo (MM2S, 0, 0)
+  }
+}
+
+// -----
+
+// first (highest-dimension) stride can go beyond the limit, as long as the corresponding wrap is 1
+
+module {
+  aie.device(npu1_4col) {
+    aiex.runtime_sequence(%a : memref<8xi32>) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c2 = arith.constant 2 : i64
+      %c3 = arith.constant 3 : i64
+      %c8 = arith.constant 8 : i64
+      %c1572864 = arith.constant 1572864 : i64
+      aiex.npu.dma_memcpy_nd (0, 0, %a[%c1,%c0,%c0,%c0][%c1,%c1,%c1,%c2][%c1572864,%c0,%c0,%c1]) { metadata = @objectfifo, id = 0 : i64 } : memref<8xi32>
+      // expected-error@+2 {{failed to legalize operation 'aiex.npu.dma_memcpy_nd' that was explicitly marked illegal}}
+      // expected-error@+1 {{Stride 3 exceeds the [1:1048576] range.}}
+      aiex.npu.dma_memcpy_nd (0, 0, %a[%c1,%c0,%c0,%c0][%c2,%c1,%c1,%c2][%c1572864,%c0,%c0,%c1]) { metadata = @objectfifo, id = 1 : i64 } : memref<8xi32>
+    }
+    aie.shim_dma_allocation @objectfifo (MM2S, 0, 0)
+  }
+}
@@ -0,0 +1,65 @@
+//===- two_cores.mlir ------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: cp %S/core_6_2.elf %t/core_6_2.elf && cp %S/core_6_2.elf %t/core_7_2.elf
+// RUN: aie-translate %s --aie-generate-airbin --airbin-output-filepath=%t/airbin.elf --airbin-aux-core-dir-path=%t
+// RUN: %LLVM_TOOLS_DIR/obj2yaml %t/airbin.elf | FileCheck %s
+
+// Each tile gets the same sections, in address order: its cleared data memory,
+// DMA BDs and channel registers, program memory holding the loaded ELF, and
+// stream switch registers. The tiles are configured in parallel, but their
+// sections are still emitted tile by tile.
+
+// CHECK:      Sections:
+// CHECK:      - Name:            .data.mem
+// CHECK:        Address:         0x3080000
+// CHECK:      - Name:            .sdma.bd
+// CHECK:        Address:         0x309D000
+// CHECK:      - Name:            .tdma.ctl
+// CHECK:        Address:         0x309DE00
+// CHECK:      - Name:            .prgm.mem
+// CHECK:        Address:         0x30A0000
+// CHECK:        Content:         0B00644A03C0034021CA61CA
+// CHECK:      - Name:            .ssmast
+// CHECK:        Address:         0x30BF000
+// CHECK:      - Name:            .ssslve
+// CHECK:        Address:         0x30BF100
+// CHECK:      - Name:            .sspckt
+// CHECK:        Address:         0x30BF200
+// CHECK:      - Name:            '.data.mem (1)'
+// CHECK:        Address:         0x3880000
+// CHECK:      - Name:            '.sdma.bd (1)'
+// CHECK:        Address:         0x389D000
+// CHECK:      - Name:            '.tdma.ctl (1)'
+// CHECK:        Address:         0x389DE00
+// CHECK:      - Name:            '.prgm.mem (1)'
+// CHECK:        Address:         0x38A0000
+// CHECK:        Content:         0B00644A03C0034021CA61CA
+// CHECK:      - Name:            '.ssmast (1)'
+// CHECK:        Address:         0x38BF000
+// CHECK:      - Name:            '.ssslve (1)'
+// CHECK:        Address:         0x38BF100
+// CHECK:      - Name:            '.sspckt (1)'
+// CHECK:        Address:         0x38BF200
+// CHECK-NOT:  - Name:
+
+module {
+  aie.device(xcvc1902) {
+    %tile_6_2 = aie.tile(6, 2)
+    %tile_7_2 = aie.tile(7, 2)
+    %core_6_2 = aie.core(%tile_6_2) {
+      aie.end
+    }
+    %core_7_2 = aie.core(%tile_7_2) {
+      aie.end
+    }
+  }
+}
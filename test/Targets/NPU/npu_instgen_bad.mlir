@@ -0,0 +1,27 @@
+//===- npu_instgen_bad.mlir ------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// A block write whose payload is not made of 32-bit words fails the
+// translation instead of writing a truncated payload.
+
+// RUN: not aie-translate --aie-npu-instgen %s 2>&1 | FileCheck %s
+// RUN: not aie-translate --aie-npu-instgen --aie-output-binary %s -o %t.bin 2>&1 | FileCheck %s
+
+// CHECK: error: Only 32-bit data type is supported for now
+
+module {
+  aie.device(npu1_4col) {
+    memref.global "private" constant @data : memref<4xi16> = dense<[1, 2, 3, 4]>
+    aiex.runtime_sequence(%arg0: memref<16xi32>) {
+      %0 = memref.get_global @data : memref<4xi16>
+      aiex.npu.blockwrite (%0) {address = 0x1000 : ui32} : memref<4xi16>
+    }
+  }
+}
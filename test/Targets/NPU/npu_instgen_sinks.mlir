@@ -0,0 +1,45 @@
+//===- npu_instgen_sinks.mlir ----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// The text and binary outputs hold the same words. The payload of @data is
+// copied in bulk, that of the splat @fill word by word.
+
+// RUN: aie-translate --aie-npu-instgen %s | FileCheck %s
+// RUN: aie-translate --aie-npu-instgen --aie-output-binary %s -o %t.bin
+// RUN: od -An -v -tx4 -w4 %t.bin | FileCheck %s --ignore-case
+
+// CHECK:      06030001
+// CHECK-NEXT: 00000104
+// CHECK-NEXT: 00000002
+// CHECK-NEXT: 00000038
+// CHECK-NEXT: 00000001
+// CHECK-NEXT: 00001000
+// CHECK-NEXT: 00000014
+// CHECK-NEXT: 00000001
+// CHECK-NEXT: 00000002
+// CHECK-NEXT: 00000001
+// CHECK-NEXT: 00002000
+// CHECK-NEXT: 00000014
+// CHECK-NEXT: 00000007
+// CHECK-NEXT: 00000007
+// CHECK-NOT:  {{.}}
+
+module {
+  aie.device(npu1_4col) {
+    memref.global "private" constant @data : memref<2xi32> = dense<[1, 2]>
+    memref.global "private" constant @fill : memref<2xi32> = dense<7>
+    aiex.runtime_sequence(%arg0: memref<16xi32>) {
+      %0 = memref.get_global @data : memref<2xi32>
+      aiex.npu.blockwrite (%0) {address = 0x1000 : ui32} : memref<2xi32>
+      %1 = memref.get_global @fill : memref<2xi32>
+      aiex.npu.blockwrite (%1) {address = 0x2000 : ui32} : memref<2xi32>
+    }
+  }
+}
@@ -0,0 +1,51 @@
+//===- npu_trace_decode.mlir -----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc. All rights reserved.
+//
+//===----------------------------------------------------------------------===//
+
+// A core trace packet of tile (0, 2) recording INSTR_EVENT_0 for one cycle
+// after 3 cycles then INSTR_EVENT_1 after 2 more, padded, followed by a
+// packet of tile (1, 2), whose events are not configured.
+
+// RUN: echo 00020000 0312ffff a5a5a5a5 a5a5a5a5 a5a5a5a5 a5a5a5a5 a5a5a5a5 a5a5a5a5 00220001 01020304 > %t.txt
+// RUN: aie-trace-decode %t.txt --mlir %s -o %t.json 2>&1 | FileCheck %s --check-prefix=WARN
+// RUN: FileCheck %s < %t.json
+
+// WARN: warning: no trace events configured for packet type 0 of tile (1, 2), its packets were skipped
+
+// CHECK:      [{"name":"process_name","ph":"M","pid":0,"args":{"name":"core_trace for tile2,0"}}
+// CHECK-SAME: {"name":"thread_name","ph":"M","pid":0,"tid":0,"args":{"name":"INSTR_EVENT_0"}}
+// CHECK-SAME: {"name":"thread_name","ph":"M","pid":0,"tid":1,"args":{"name":"INSTR_EVENT_1"}}
+// CHECK-SAME: {"name":"thread_name","ph":"M","pid":0,"tid":7,"args":{"name":"NONE"}}
+// CHECK-SAME: {"name":"INSTR_EVENT_0","ts":4,"ph":"B","pid":0,"tid":0,"args":{}}
+// CHECK-SAME: {"name":"INSTR_EVENT_0","ts":5,"ph":"E","pid":0,"tid":0,"args":{}}
+// CHECK-SAME: {"name":"INSTR_EVENT_1","ts":7,"ph":"B","pid":0,"tid":1,"args":{}}]
+
+// The same packet with a zero word inside, which still counts towards the 8
+// words of the packet. The word in the place of the next header has a wrong
+// parity, so it is data of the packet: INSTR_EVENT_0 again after 3 cycles.
+// The header of the packet of tile (1, 2) follows 8 words later.
+
+// RUN: echo 00020000 00000000 0312ffff a5a5a5a5 a5a5a5a5 a5a5a5a5 a5a5a5a5 a5a5a5a5 ffffff03 a5a5a5a5 a5a5a5a5 a5a5a5a5 a5a5a5a5 a5a5a5a5 a5a5a5a5 a5a5a5a5 00220001 01020304 > %t.data.txt
+// RUN: aie-trace-decode %t.data.txt --mlir %s -o %t.data.json 2>&1 | FileCheck %s --check-prefix=WARN
+// RUN: FileCheck %s --check-prefix=DATA < %t.data.json
+
+// DATA:      {"name":"INSTR_EVENT_0","ts":4,"ph":"B","pid":0,"tid":0,"args":{}}
+// DATA-SAME: {"name":"INSTR_EVENT_0","ts":5,"ph":"E","pid":0,"tid":0,"args":{}}
+// DATA-SAME: {"name":"INSTR_EVENT_1","ts":7,"ph":"B","pid":0,"tid":1,"args":{}}
+// DATA-SAME: {"name":"INSTR_EVENT_1","ts":8,"ph":"E","pid":0,"tid":1,"args":{}}
+// DATA-SAME: {"name":"INSTR_EVENT_0","ts":11,"ph":"B","pid":0,"tid":0,"args":{}}]
+
+module {
+  aie.device(npu1_1col) {
+    aiex.runtime_sequence(%arg0: memref<16xi32>) {
+      aiex.npu.write32 { column = 0 : i32, row = 2 : i32, address = 0x340E0 : ui32, value = 0x2221 : ui32 }
+      aiex.npu.write32 { column = 0 : i32, row = 2 : i32, address = 0x340E4 : ui32, value = 0 : ui32 }
+    }
+  }
+}
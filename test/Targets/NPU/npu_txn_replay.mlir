@@ -0,0 +1,54 @@
+//===- npu_txn_replay.mlir -------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc. All rights reserved.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-npu-instgen %s -o %t.txt
+// RUN: aie-txn-replay %t.txt | FileCheck %s
+// RUN: aie-translate --aie-npu-instgen --aie-output-binary %s -o %t.bin
+// RUN: aie-txn-replay %t.bin | FileCheck %s
+// RUN: aie-txn-replay %t.bin %t.bin | FileCheck %s --check-prefix=TWICE
+
+// CHECK:      operations: 6 (112 bytes)
+// CHECK-NEXT:   write: 3 (36 bytes)
+// CHECK-NEXT:   blockwrite: 1 (44 bytes)
+// CHECK-NEXT:   maskwrite: 1 (16 bytes)
+// CHECK-NEXT:   sync: 1 (16 bytes)
+// CHECK-NEXT:   address_patch: 0 (0 bytes)
+// CHECK-NEXT: register writes: 12
+// CHECK-NEXT: redundant writes: 1
+// CHECK-NEXT: overwritten writes: 1
+// CHECK-NEXT: tile (0, 0) shim
+// CHECK-NEXT:   bd 0: 00000064 00000065 00000066 00000067 00000068 00000069 0000006a 0000006b
+// CHECK-NEXT: tile (0, 2) core
+// CHECK-NEXT:   lock 0: 00000002
+// CHECK-NEXT:   0x00032000: 00000003
+
+// Replayed a second time, the transaction rewrites the lock, the BD and the
+// mask with the values they already hold, each write overwriting the
+// previous one to its register.
+
+// TWICE:      register writes: 24
+// TWICE-NEXT: redundant writes: 11
+// TWICE-NEXT: overwritten writes: 12
+module {
+  aie.device(npu1_1col) {
+    memref.global "private" constant @bd_data : memref<8xi32> = dense<[100, 101, 102, 103, 104, 105, 106, 107]>
+    aiex.runtime_sequence(%arg0: memref<16xf32>) {
+      aiex.npu.write32 { column = 0 : i32, row = 2 : i32, address = 0x1F000 : ui32, value = 2 : ui32 }
+      aiex.npu.write32 { column = 0 : i32, row = 2 : i32, address = 0x32000 : ui32, value = 1 : ui32 }
+      // Overwrites the previous write.
+      aiex.npu.write32 { column = 0 : i32, row = 2 : i32, address = 0x32000 : ui32, value = 3 : ui32 }
+      // Leaves the register unchanged.
+      aiex.npu.maskwrite32 { column = 0 : i32, row = 2 : i32, address = 0x32000 : ui32, value = 1 : ui32, mask = 1 : ui32 }
+      %0 = memref.get_global @bd_data : memref<8xi32>
+      aiex.npu.blockwrite (%0) { column = 0 : i32, row = 0 : i32, address = 0x1D000 : ui32} : memref<8xi32>
+      aiex.npu.sync { column = 0 : i32, row = 0 : i32, direction = 0 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+    }
+  }
+}
@@ -0,0 +1,49 @@
+//===- core_cache.mlir -----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// REQUIRES: peano
+
+// The first run builds the ELF of the core and caches it, the second reuses
+// it, and changing the core builds and caches a new one.
+
+// RUN: rm -rf %t && mkdir -p %t && cd %t
+// RUN: %PYTHON aiecc.py --no-unified --compile --link --no-xchesscc --no-xbridge --no-compile-host -v --core-cache-dir=%t/cache %s | FileCheck %s --check-prefix=MISS
+// RUN: test -f core_1_2.elf
+// RUN: rm core_1_2.elf
+// RUN: %PYTHON aiecc.py --no-unified --compile --link --no-xchesscc --no-xbridge --no-compile-host -v --core-cache-dir=%t/cache %s | FileCheck %s --check-prefix=HIT
+// RUN: test -f core_1_2.elf
+// RUN: sed 's/arith.constant 0 : i32/arith.constant 1 : i32/' %s > %t/changed.mlir
+// RUN: %PYTHON aiecc.py --no-unified --compile --link --no-xchesscc --no-xbridge --no-compile-host -v --core-cache-dir=%t/cache %t/changed.mlir | FileCheck %s --check-prefix=MISS
+// RUN: ls %t/cache | FileCheck %s --check-prefix=CACHE
+
+// MISS-NOT: Reusing
+// MISS:     {{^[^ ]*llc}}
+// MISS:     -Wl,-T,{{.*}}core_1_2.ld.script
+// MISS-NOT: Reusing
+
+// HIT-NOT:  {{^[^ ]*llc}}
+// HIT:      Reusing {{.*}}/cache/{{[0-9a-f]+}}.elf for core (1, 2)
+// HIT-NOT:  {{^[^ ]*llc}}
+
+// CACHE-COUNT-2: {{^[0-9a-f]+}}.elf
+// CACHE-NOT:     .tmp
+
+module {
+  aie.device(npu1_4col) {
+    %12 = aie.tile(1, 2)
+    %buf = aie.buffer(%12) : memref<256xi32>
+    %4 = aie.core(%12) {
+      %0 = arith.constant 0 : i32
+      %1 = arith.constant 0 : index
+      memref.store %0, %buf[%1] : memref<256xi32>
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,32 @@
+//===- profile.mlir --------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: %PYTHON aiecc.py --no-compile --no-link --no-compile-host -n --profile %s | FileCheck %s
+// RUN: test -f profile.mlir.prj/input_with_addresses.mlirbc
+
+// CHECK: Stages:
+// CHECK-NEXT: {{[0-9.]+}} sec: input with addresses
+// CHECK-NEXT: {{[0-9.]+}} sec: core modules
+// CHECK-NEXT: {{[0-9.]+}} sec: host
+// CHECK-NEXT: {{[0-9.]+}} sec: cores
+// CHECK-NEXT: Commands:
+
+module {
+  aie.device(npu1_4col) {
+    %12 = aie.tile(1, 2)
+    %buf = aie.buffer(%12) : memref<256xi32>
+    %4 = aie.core(%12) {
+      %0 = arith.constant 0 : i32
+      %1 = arith.constant 0 : index
+      memref.store %0, %buf[%1] : memref<256xi32>
+      aie.end
+    }
+  }
+}
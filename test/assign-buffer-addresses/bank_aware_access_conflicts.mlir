@@ -0,0 +1,54 @@
+//===- bank_aware_access_conflicts.mlir ------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// %io is used by the core and by a DMA channel. Round-robin would put it next
+// to %t1 in bank 0; it goes to the only bank without a buffer the core uses.
+
+// RUN: aie-opt --aie-assign-buffer-addresses="alloc-scheme=bank-aware report-bank-conflicts=true" %s 2>&1 | FileCheck %s
+
+// CHECK-NOT: remark
+// CHECK: %t1 = aie.buffer(%tile_0_2) {address = 1024 : i32, mem_bank = 0 : i32, sym_name = "t1"} : memref<1024xi32>
+// CHECK: %t2 = aie.buffer(%tile_0_2) {address = 16384 : i32, mem_bank = 1 : i32, sym_name = "t2"} : memref<768xi32>
+// CHECK: %t3 = aie.buffer(%tile_0_2) {address = 32768 : i32, mem_bank = 2 : i32, sym_name = "t3"} : memref<512xi32>
+// CHECK: %u = aie.buffer(%tile_0_2) {address = 49152 : i32, mem_bank = 3 : i32, sym_name = "u"} : memref<256xi32>
+// CHECK: %io = aie.buffer(%tile_0_2) {address = 50176 : i32, mem_bank = 3 : i32, sym_name = "io"} : memref<128xi32>
+
+module @test {
+  aie.device(npu1_4col) {
+    %tile_0_2 = aie.tile(0, 2)
+    %t1 = aie.buffer(%tile_0_2) { sym_name = "t1" } : memref<1024xi32>
+    %t2 = aie.buffer(%tile_0_2) { sym_name = "t2" } : memref<768xi32>
+    %t3 = aie.buffer(%tile_0_2) { sym_name = "t3" } : memref<512xi32>
+    %u = aie.buffer(%tile_0_2) { sym_name = "u" } : memref<256xi32>
+    %io = aie.buffer(%tile_0_2) { sym_name = "io" } : memref<128xi32>
+    %prod_lock = aie.lock(%tile_0_2, 0) {init = 1 : i32}
+    %cons_lock = aie.lock(%tile_0_2, 1) {init = 0 : i32}
+    aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      aie.use_lock(%cons_lock, AcquireGreaterEqual, 1)
+      %x = memref.load %io[%c0] : memref<128xi32>
+      memref.store %x, %t1[%c0] : memref<1024xi32>
+      memref.store %x, %t2[%c0] : memref<768xi32>
+      memref.store %x, %t3[%c0] : memref<512xi32>
+      aie.use_lock(%prod_lock, Release, 1)
+      aie.end
+    }
+    %mem_0_2 = aie.mem(%tile_0_2) {
+      %0 = aie.dma_start(S2MM, 0, ^bb1, ^bb2)
+    ^bb1:
+      aie.use_lock(%prod_lock, AcquireGreaterEqual, 1)
+      aie.dma_bd(%io : memref<128xi32>, 0, 128)
+      aie.use_lock(%cons_lock, Release, 1)
+      aie.next_bd ^bb1
+    ^bb2:
+      aie.end
+    }
+  }
+}
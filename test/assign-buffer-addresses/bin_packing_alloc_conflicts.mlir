@@ -0,0 +1,49 @@
+//===- bin_packing_alloc_conflicts.mlir ------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// %io is accessed by both the core and a DMA channel, so it is kept out of
+// the banks holding the other buffers the core uses.
+
+// RUN: aie-opt --aie-assign-buffer-addresses="alloc-scheme=bin-packing" %s | FileCheck %s
+
+// CHECK: %a = aie.buffer(%tile_3_3) {address = 8192 : i32, mem_bank = 1 : i32, sym_name = "a"} : memref<1792xi32>
+// CHECK: %b = aie.buffer(%tile_3_3) {address = 16384 : i32, mem_bank = 2 : i32, sym_name = "b"} : memref<1536xi32>
+// CHECK: %c = aie.buffer(%tile_3_3) {address = 24576 : i32, mem_bank = 3 : i32, sym_name = "c"} : memref<640xi32>
+// CHECK: %u = aie.buffer(%tile_3_3) {address = 1024 : i32, mem_bank = 0 : i32, sym_name = "u"} : memref<384xi32>
+// CHECK: %v = aie.buffer(%tile_3_3) {address = 2560 : i32, mem_bank = 0 : i32, sym_name = "v"} : memref<384xi32>
+// CHECK: %io = aie.buffer(%tile_3_3) {address = 4096 : i32, mem_bank = 0 : i32, sym_name = "io"} : memref<128xi32>
+
+module @test {
+  aie.device(xcvc1902) {
+    %0 = aie.tile(3, 3)
+    %a = aie.buffer(%0) { sym_name = "a" } : memref<1792xi32>
+    %b = aie.buffer(%0) { sym_name = "b" } : memref<1536xi32>
+    %c = aie.buffer(%0) { sym_name = "c" } : memref<640xi32>
+    %u = aie.buffer(%0) { sym_name = "u" } : memref<384xi32>
+    %v = aie.buffer(%0) { sym_name = "v" } : memref<384xi32>
+    %io = aie.buffer(%0) { sym_name = "io" } : memref<128xi32>
+    aie.core(%0) {
+      %c0 = arith.constant 0 : index
+      %x = memref.load %a[%c0] : memref<1792xi32>
+      memref.store %x, %b[%c0] : memref<1536xi32>
+      memref.store %x, %c[%c0] : memref<640xi32>
+      memref.store %x, %io[%c0] : memref<128xi32>
+      aie.end
+    }
+    %mem = aie.mem(%0) {
+      %1 = aie.dma_start(MM2S, 0, ^bd0, ^end)
+    ^bd0:
+      aie.dma_bd(%io : memref<128xi32>, 0, 128)
+      aie.next_bd ^bd0
+    ^end:
+      aie.end
+    }
+  }
+}
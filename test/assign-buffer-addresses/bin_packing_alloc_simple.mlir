@@ -0,0 +1,44 @@
+//===- bin_packing_alloc_simple.mlir ---------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// The buffers fill the four banks exactly. Round-robin placement cannot find
+// that packing; the search can, and the default scheme falls back to it.
+
+// RUN: aie-opt --aie-assign-buffer-addresses="alloc-scheme=bin-packing" %s | FileCheck %s
+// RUN: not aie-opt --aie-assign-buffer-addresses="alloc-scheme=bank-aware" %s 2>&1 | FileCheck %s --check-prefix=BANK
+// RUN: aie-opt --aie-assign-buffer-addresses %s 2>&1 | FileCheck %s --check-prefixes=BANK,CHECK
+
+// BANK: error: Failed to allocate buffer: "h" with size: 2048 bytes.
+
+// CHECK: %a = aie.buffer(%tile_3_3) {address = 1024 : i32, mem_bank = 0 : i32, sym_name = "a"} : memref<1792xi32>
+// CHECK: %b = aie.buffer(%tile_3_3) {address = 8192 : i32, mem_bank = 1 : i32, sym_name = "b"} : memref<1216xi32>
+// CHECK: %c = aie.buffer(%tile_3_3) {address = 16384 : i32, mem_bank = 2 : i32, sym_name = "c"} : memref<1088xi32>
+// CHECK: %d = aie.buffer(%tile_3_3) {address = 20736 : i32, mem_bank = 2 : i32, sym_name = "d"} : memref<960xi32>
+// CHECK: %e = aie.buffer(%tile_3_3) {address = 13056 : i32, mem_bank = 1 : i32, sym_name = "e"} : memref<832xi32>
+// CHECK: %f = aie.buffer(%tile_3_3) {address = 24576 : i32, mem_bank = 3 : i32, sym_name = "f"} : memref<768xi32>
+// CHECK: %g = aie.buffer(%tile_3_3) {address = 27648 : i32, mem_bank = 3 : i32, sym_name = "g"} : memref<768xi32>
+// CHECK: %h = aie.buffer(%tile_3_3) {address = 30720 : i32, mem_bank = 3 : i32, sym_name = "h"} : memref<512xi32>
+
+module @test {
+  aie.device(xcvc1902) {
+    %0 = aie.tile(3, 3)
+    %a = aie.buffer(%0) { sym_name = "a" } : memref<1792xi32>
+    %b = aie.buffer(%0) { sym_name = "b" } : memref<1216xi32>
+    %c = aie.buffer(%0) { sym_name = "c" } : memref<1088xi32>
+    %d = aie.buffer(%0) { sym_name = "d" } : memref<960xi32>
+    %e = aie.buffer(%0) { sym_name = "e" } : memref<832xi32>
+    %f = aie.buffer(%0) { sym_name = "f" } : memref<768xi32>
+    %g = aie.buffer(%0) { sym_name = "g" } : memref<768xi32>
+    %h = aie.buffer(%0) { sym_name = "h" } : memref<512xi32>
+    aie.core(%0) {
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,52 @@
+//===- report_bank_conflicts.mlir ------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Sequential allocation puts all buffers in bank 0. %a and %b are guarded by
+// the same AIE1 lock and %b and %c are only used by one DMA channel, so the
+// core access to %a and the DMA access to %c are the only conflict.
+
+// RUN: aie-opt --aie-assign-buffer-addresses="alloc-scheme=basic-sequential report-bank-conflicts=true" %s 2>&1 | FileCheck %s
+
+// CHECK: remark: 1 predicted bank conflict(s)
+// CHECK: note: a and c share a bank and may be accessed at the same time
+// CHECK-NOT: note:
+
+module @test {
+  aie.device(xcvc1902) {
+    %t = aie.tile(3, 3)
+    %a = aie.buffer(%t) { sym_name = "a" } : memref<512xi32>
+    %b = aie.buffer(%t) { sym_name = "b" } : memref<256xi32>
+    %c = aie.buffer(%t) { sym_name = "c" } : memref<128xi32>
+    %l = aie.lock(%t, 0)
+    %m = aie.lock(%t, 1)
+    aie.core(%t) {
+      %c0 = arith.constant 0 : index
+      aie.use_lock(%l, Acquire, 1)
+      %x = memref.load %a[%c0] : memref<512xi32>
+      aie.use_lock(%l, Release, 0)
+      aie.end
+    }
+    %mem = aie.mem(%t) {
+      %0 = aie.dma_start(MM2S, 0, ^bd0, ^end)
+    ^bd0:
+      aie.use_lock(%l, Acquire, 0)
+      aie.dma_bd(%b : memref<256xi32>, 0, 256)
+      aie.use_lock(%l, Release, 1)
+      aie.next_bd ^bd1
+    ^bd1:
+      aie.use_lock(%m, Acquire, 1)
+      aie.dma_bd(%c : memref<128xi32>, 0, 128)
+      aie.use_lock(%m, Release, 0)
+      aie.next_bd ^bd0
+    ^end:
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,68 @@
+//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 AMD Inc.
+
+// RUN: aie-opt --aie-assign-runtime-sequence-bd-ids %s | FileCheck %s
+
+// This test ensures that awaiting a task also frees the BD IDs of the tasks started before it on the
+// same channel, and that a task started again keeps its BD IDs until it completes after its last start.
+
+module {
+  aie.device(npu1_4col) {
+    %tile_0_0 = aie.tile(0, 0)
+
+    aiex.runtime_sequence(%arg0: memref<8xi16>) {
+      %t1 = aiex.dma_configure_task(%tile_0_0, MM2S, 0) {
+      // CHECK:  aie.dma_bd(%arg0 : memref<8xi16>, 0, 8) {bd_id = 0 : i32}
+        aie.dma_bd(%arg0 : memref<8xi16>, 0, 8)
+        aie.end
+      }
+      %t2 = aiex.dma_configure_task(%tile_0_0, MM2S, 0) {
+      // CHECK:  aie.dma_bd(%arg0 : memref<8xi16>, 0, 8) {bd_id = 1 : i32}
+        aie.dma_bd(%arg0 : memref<8xi16>, 0, 8)
+        aie.end
+      }
+      %t3 = aiex.dma_configure_task(%tile_0_0, MM2S, 1) {
+      // CHECK:  aie.dma_bd(%arg0 : memref<8xi16>, 0, 8) {bd_id = 2 : i32}
+        aie.dma_bd(%arg0 : memref<8xi16>, 0, 8)
+        aie.end
+      }
+      aiex.dma_start_task(%t1)
+      aiex.dma_start_task(%t2)
+      aiex.dma_start_task(%t3)
+      // Completes %t1 and %t2, but not %t3 which runs on another channel.
+      aiex.dma_await_task(%t2)
+
+      %t4 = aiex.dma_configure_task(%tile_0_0, MM2S, 0) {
+      // CHECK:  aie.dma_bd(%arg0 : memref<8xi16>, 0, 8) {bd_id = 0 : i32}
+        aie.dma_bd(%arg0 : memref<8xi16>, 0, 8)
+        aie.end
+      }
+      %t5 = aiex.dma_configure_task(%tile_0_0, S2MM, 0) {
+      // CHECK:  aie.dma_bd(%arg0 : memref<8xi16>, 0, 8) {bd_id = 1 : i32}
+        aie.dma_bd(%arg0 : memref<8xi16>, 0, 8)
+        aie.end
+      }
+      aiex.dma_start_task(%t5)
+      aiex.dma_await_task(%t5)
+      aiex.dma_start_task(%t5)
+
+      %t6 = aiex.dma_configure_task(%tile_0_0, S2MM, 0) {
+      // CHECK:  aie.dma_bd(%arg0 : memref<8xi16>, 0, 8) {bd_id = 3 : i32}
+        aie.dma_bd(%arg0 : memref<8xi16>, 0, 8)
+        aie.end
+      }
+      aiex.dma_await_task(%t5)
+
+      %t7 = aiex.dma_configure_task(%tile_0_0, S2MM, 0) {
+      // CHECK:  aie.dma_bd(%arg0 : memref<8xi16>, 0, 8) {bd_id = 1 : i32}
+        aie.dma_bd(%arg0 : memref<8xi16>, 0, 8)
+        aie.end
+      }
+    }
+  }
+}
@@ -0,0 +1,31 @@
+//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 AMD Inc.
+
+// RUN: aie-opt --aie-assign-runtime-sequence-bd-ids %s | FileCheck %s
+
+// This test ensures that BD IDs on memtiles are allocated from the pool of the channel the task runs on.
+
+module {
+  aie.device(npu1_4col) {
+    %tile_0_1 = aie.tile(0, 1)
+    %buf = aie.buffer(%tile_0_1) : memref<8xi16>
+
+    aiex.runtime_sequence() {
+      %t1 = aiex.dma_configure_task(%tile_0_1, MM2S, 0) {
+      // CHECK:  aie.dma_bd(%{{.*}} : memref<8xi16>, 0, 8) {bd_id = 0 : i32}
+        aie.dma_bd(%buf : memref<8xi16>, 0, 8)
+        aie.end
+      }
+      %t2 = aiex.dma_configure_task(%tile_0_1, MM2S, 1) {
+      // CHECK:  aie.dma_bd(%{{.*}} : memref<8xi16>, 0, 8) {bd_id = 24 : i32}
+        aie.dma_bd(%buf : memref<8xi16>, 0, 8)
+        aie.end
+      }
+    }
+  }
+}
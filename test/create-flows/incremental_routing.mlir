@@ -0,0 +1,98 @@
+//===- incremental_routing.mlir --------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -f %t.json
+// RUN: aie-opt --aie-create-pathfinder-flows="routing-solution=%t.json" %s -o %t.first
+// RUN: FileCheck %s --check-prefix=JSON < %t.json
+// RUN: aie-opt --aie-create-pathfinder-flows="routing-solution=%t.json" %s -o %t.second
+// RUN: diff %t.first %t.second
+// RUN: aie-opt --aie-find-flows %t.second | FileCheck %s
+
+// Changing the destination of one flow only reroutes that flow: the others
+// keep their previous route.
+// RUN: sed 's/%%t23, DMA : 0)/%%t23, DMA : 1)/' %s > %t.changed.mlir
+// RUN: aie-opt --aie-create-pathfinder-flows="routing-solution=%t.json routing-report=%t.report.json" %t.changed.mlir -o %t.changed
+// RUN: FileCheck %s --check-prefix=REPORT < %t.report.json
+// RUN: aie-opt --aie-find-flows %t.changed | FileCheck %s --check-prefix=CHANGED
+
+// RUN: echo "{}" > %t.bad.json
+// RUN: aie-opt --aie-create-pathfinder-flows="routing-solution=%t.bad.json" %s 2>&1 | FileCheck %s --check-prefix=BAD
+
+// JSON: "devices": {
+// JSON: "npu1_4col": {
+// JSON: "flows": [
+// JSON: "channels": [
+// JSON: "dsts": [
+// JSON: "bundle": "DMA",
+// JSON: "src": {
+
+// REPORT:      "flows": [
+// REPORT:        "packet": false,
+// REPORT-NEXT:   "reused": true,
+// REPORT-NEXT:   "src": {
+// REPORT-NEXT:     "bundle": "DMA",
+// REPORT-NEXT:     "channel": 0,
+// REPORT-NEXT:     "col": 2,
+// REPORT-NEXT:     "row": 0
+// REPORT:        "packet": false,
+// REPORT-NEXT:   "reused": true,
+// REPORT-NEXT:   "src": {
+// REPORT-NEXT:     "bundle": "DMA",
+// REPORT-NEXT:     "channel": 0,
+// REPORT-NEXT:     "col": 2,
+// REPORT-NEXT:     "row": 1
+// REPORT:        "packet": false,
+// REPORT-NEXT:   "reused": false,
+// REPORT-NEXT:   "src": {
+// REPORT-NEXT:     "bundle": "DMA",
+// REPORT-NEXT:     "channel": 1,
+// REPORT-NEXT:     "col": 2,
+// REPORT-NEXT:     "row": 1
+// REPORT:        "packet": false,
+// REPORT-NEXT:   "reused": true,
+// REPORT-NEXT:   "src": {
+// REPORT-NEXT:     "bundle": "DMA",
+// REPORT-NEXT:     "channel": 0,
+// REPORT-NEXT:     "col": 2,
+// REPORT-NEXT:     "row": 2
+
+// CHANGED: %[[T20:.*]] = aie.tile(2, 0)
+// CHANGED: %[[T21:.*]] = aie.tile(2, 1)
+// CHANGED: %[[T22:.*]] = aie.tile(2, 2)
+// CHANGED: %[[T23:.*]] = aie.tile(2, 3)
+// CHANGED: aie.flow(%[[T20]], DMA : 0, %[[T21]], DMA : 0)
+// CHANGED: aie.flow(%[[T21]], DMA : 0, %[[T22]], DMA : 0)
+// CHANGED: aie.flow(%[[T21]], DMA : 1, %[[T23]], DMA : 1)
+// CHANGED: aie.flow(%[[T22]], DMA : 0, %[[T20]], DMA : 0)
+
+// BAD: warning: Ignoring malformed routing solution
+
+// CHECK: %[[T20:.*]] = aie.tile(2, 0)
+// CHECK: %[[T21:.*]] = aie.tile(2, 1)
+// CHECK: %[[T22:.*]] = aie.tile(2, 2)
+// CHECK: %[[T23:.*]] = aie.tile(2, 3)
+// CHECK: aie.flow(%[[T20]], DMA : 0, %[[T21]], DMA : 0)
+// CHECK: aie.flow(%[[T21]], DMA : 0, %[[T22]], DMA : 0)
+// CHECK: aie.flow(%[[T21]], DMA : 1, %[[T23]], DMA : 0)
+// CHECK: aie.flow(%[[T22]], DMA : 0, %[[T20]], DMA : 0)
+
+module {
+  aie.device(npu1_4col) {
+    %t20 = aie.tile(2, 0)
+    %t21 = aie.tile(2, 1)
+    %t22 = aie.tile(2, 2)
+    %t23 = aie.tile(2, 3)
+
+    aie.flow(%t20, DMA : 0, %t21, DMA : 0)
+    aie.flow(%t21, DMA : 0, %t22, DMA : 0)
+    aie.flow(%t21, DMA : 1, %t23, DMA : 0)
+    aie.flow(%t22, DMA : 0, %t20, DMA : 0)
+  }
+}
@@ -0,0 +1,42 @@
+//===- incremental_routing_devices.mlir ------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// The solutions of the devices of a module are stored side by side in the
+// routing solution file, each one under the name of its target, numbered
+// from the second device with the same target on.
+
+// RUN: rm -f %t.json
+// RUN: aie-opt --aie-create-pathfinder-flows="routing-solution=%t.json" %s -o %t.first
+// RUN: FileCheck %s < %t.json
+// RUN: aie-opt --aie-create-pathfinder-flows="routing-solution=%t.json" %s -o %t.second
+// RUN: diff %t.first %t.second
+
+// CHECK:      "devices": {
+// CHECK-DAG:  "npu1_4col": {
+// CHECK-DAG:  "npu1_4col_1": {
+// CHECK-DAG:  "xcve2302": {
+
+module {
+  aie.device(npu1_4col) {
+    %t20 = aie.tile(2, 0)
+    %t22 = aie.tile(2, 2)
+    aie.flow(%t20, DMA : 0, %t22, DMA : 0)
+  }
+  aie.device(npu1_4col) {
+    %t30 = aie.tile(3, 0)
+    %t33 = aie.tile(3, 3)
+    aie.flow(%t30, DMA : 0, %t33, DMA : 1)
+  }
+  aie.device(xcve2302) {
+    %t12 = aie.tile(1, 2)
+    %t13 = aie.tile(1, 3)
+    aie.flow(%t12, DMA : 0, %t13, DMA : 0)
+  }
+}
@@ -0,0 +1,93 @@
+//===- routing_report.mlir -------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-create-pathfinder-flows="routing-report=%t.json" %s -o %t.mlir
+// RUN: FileCheck %s < %t.json
+// RUN: aie-visualize %t.mlir --routing-report=%t.json --heatmap=ports | sed 's/\x1b\[[0-9;]*m//g' | FileCheck %s --check-prefix=HEATMAP
+
+// The flows all stay in column 2, and the report covers the switchboxes up to
+// the last column and row with a tile.
+
+// HEATMAP:      Switchbox port usage, 9 = all used
+// HEATMAP-NEXT: 5 ....
+// HEATMAP-NEXT: 4 ....
+// HEATMAP-NEXT: 3 00{{[1-9]}}.
+// HEATMAP-NEXT: 2 00{{[1-9]}}.
+// HEATMAP-NEXT: 1 00{{[1-9]}}.
+// HEATMAP-NEXT: 0 00{{[1-9]}}.
+// HEATMAP-NEXT: 0123
+
+// The packet flows to the same destination are in one packet group, and
+// share the channels they have in common by arbitration.
+
+// CHECK:      "channels": [
+// CHECK:        "circuitFlows": {{[0-9]+}},
+// CHECK-NEXT:   "demand": {{.*}},
+// CHECK-NEXT:   "dst": {
+// CHECK:        "packetFlows": {{[12]}},
+// CHECK-NEXT:   "packetGroups": 1,
+
+// The flows are reported packet flows first, each with the switchbox hops to
+// each destination and in total.
+
+// CHECK:      "flows": [
+// CHECK:        "hops": 1
+// CHECK:        "hops": 1,
+// CHECK-NEXT:   "packet": true,
+// CHECK:        "hops": 2
+// CHECK:        "hops": 2,
+// CHECK-NEXT:   "packet": true,
+// CHECK:        "hops": 1,
+// CHECK-NEXT:   "packet": false,
+// CHECK:        "hops": 1,
+// CHECK-NEXT:   "packet": false,
+// CHECK:        "hops": 2,
+// CHECK-NEXT:   "packet": false,
+// CHECK:        "hops": 2,
+// CHECK-NEXT:   "packet": false,
+
+// CHECK:      "iterations": [
+// CHECK:        "maxDemand": {{.*}},
+// CHECK-NEXT:   "overCapacityChannels": 0,
+// CHECK-NEXT:   "overCapacityHistory": {{[0-9]+}},
+// CHECK-NEXT:   "pathLength": {{[0-9]+}}
+
+// CHECK:      "switchboxes": [
+// CHECK:        "col": 2,
+// CHECK-NEXT:   "links": {{[0-9]+}},
+// CHECK-NEXT:   "maxPacketSharing": {{[0-9]+}},
+// CHECK-NEXT:   "overCapacity": {{[0-9]+}},
+// CHECK-NEXT:   "ports": {{[0-9]+}},
+// CHECK-NEXT:   "row": {{[0-9]+}},
+// CHECK-NEXT:   "usedLinks": {{[0-9]+}},
+// CHECK-NEXT:   "usedPorts": {{[0-9]+}}
+
+module {
+  aie.device(npu1_4col) {
+    %t20 = aie.tile(2, 0)
+    %t21 = aie.tile(2, 1)
+    %t22 = aie.tile(2, 2)
+    %t23 = aie.tile(2, 3)
+
+    aie.packet_flow(0x1) {
+      aie.packet_source<%t22, DMA : 1>
+      aie.packet_dest<%t21, DMA : 1>
+    }
+    aie.packet_flow(0x2) {
+      aie.packet_source<%t23, DMA : 1>
+      aie.packet_dest<%t21, DMA : 1>
+    }
+
+    aie.flow(%t20, DMA : 0, %t21, DMA : 0)
+    aie.flow(%t21, DMA : 0, %t22, DMA : 0)
+    aie.flow(%t21, DMA : 1, %t23, DMA : 0)
+    aie.flow(%t22, DMA : 0, %t20, DMA : 0)
+  }
+}
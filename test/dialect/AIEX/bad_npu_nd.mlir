@@ -11,57 +11,9 @@
 
 // RUN: aie-opt --split-input-file --verify-diagnostics %s
 
-module {
-  aie.device(npu1_4col) {
-    aiex.runtime_sequence(%in : memref<1920x1080xi32>, %buf : memref<32xi32>, %out : memref<1920x1080xi32>) {
-      %c0 = arith.constant 0 : i64
-      %c1 = arith.constant 1 : i64
-      %c1920 = arith.constant 1920 : i64
-      %c1080 = arith.constant 1080 : i64
-      // expected-error@+1 {{Size 0 exceeds the [0:1023] range}}
-      aiex.npu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c1080,%c1920][%c0,%c0,%c1920,%c1]) { metadata = @of_fromMem, id = 0 : i64 } : memref<1920x1080xi32>
-    }
-    aie.shim_dma_allocation @of_fromMem (MM2S, 0, 0)
-  }
-}
-
-// -----
-
-module {
-  aie.device(npu1_4col) {
-    aiex.runtime_sequence(%in : memref<128x4x2x8xi32>, %buf : memref<32xi32>, %out : memref<8192xi32>) {
-      %c0 = arith.constant 0 : i64
-      %c1 = arith.constant 1 : i64
-      %c2 = arith.constant 2 : i64
-      %c4 = arith.constant 4 : i64
-      %c8 = arith.constant 8 : i64
-      %c16 = arith.constant 16 : i64
-      %c32 = arith.constant 32 : i64
-      %c128 = arith.constant 128 : i64
-      // expected-error@+1 {{Size 3 exceeds the [1:64] range}}
-      aiex.npu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c128,%c2,%c2,%c8][%c0,%c16,%c8,%c1]) { metadata = @of_fromMem, id = 0 : i64 } : memref<128x4x2x8xi32>
-    }
-    aie.shim_dma_allocation @of_fromMem (MM2S, 0, 0)
-  }
-}
-
-// -----
-
-module {
-  aie.device(npu1_4col) {
-    aiex.runtime_sequence(%in : memref<8388608xi32>, %buf : memref<32xi32>, %out : memref<8388608xi32>) {
-      %c0 = arith.constant 0 : i64
-      %c1 = arith.constant 1 : i64
-      %c2 = arith.constant 2 : i64
-      %c2097152 = arith.constant 2097152 : i64
-      // expected-error@+1 {{Stride 1 exceeds the [1:1048576] range}}
-      aiex.npu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c2,%c2][%c0,%c0,%c2097152,%c1]) { metadata = @of_fromMem, id = 0 : i64 } : memref<8388608xi32>
-    }
-    aie.shim_dma_allocation @of_fromMem (MM2S, 0, 0)
-  }
-}
-
-// -----
+// Transfers exceeding the ranges of the BD fields are legal here, as
+// aie-split-access-patterns splits them; dma_to_npu_bd_limits.mlir checks that
+// aie-dma-to-npu rejects those left as they are.
 
 // Offsets need to be 4-byte aligned.
 
@@ -103,24 +55,6 @@ module {
 
 // -----
 
-module {
-  aie.device(npu1_4col) {
-    aiex.runtime_sequence(%a : memref<8xi16>) {
-      %c0 = arith.constant 0 : i64
-      %c1 = arith.constant 1 : i64
-      %c2 = arith.constant 2 : i64
-      %c4 = arith.constant 4 : i64
-      %c8 = arith.constant 8 : i64
-      %c2048 = arith.constant 2048 : i64
-      // expected-error@+1 {{Size 0 exceeds the [0:1023] range}}
-      aiex.npu.dma_memcpy_nd (0, 0, %a[%c0,%c0,%c0,%c0][%c1,%c1,%c2,%c2048][%c0,%c0,%c4,%c1]) { metadata = @objectfifo, id = 0 : i64 } : memref<8xi16>
-    }
-    aie.shim_dma_allocation @objectfifo (MM2S, 0, 0)
-  }
-}
-
-// -----
-
 // Strides and sizes are expressed at 4-byte-granularity in hardware, but we express them at memref element type granularity.
 // The following tests make sure the proper errors are generated when this is not possible.
 
@@ -212,27 +146,6 @@ module {
 
 // -----
 
-// first (highest-dimension) stride can go beyond the limit, as long as the corresponding wrap is 1
-
-module {
-  aie.device(npu1_4col) {
-    aiex.runtime_sequence(%a : memref<8xi32>) {
-      %c0 = arith.constant 0 : i64
-      %c1 = arith.constant 1 : i64
-      %c2 = arith.constant 2 : i64
-      %c3 = arith.constant 3 : i64
-      %c8 = arith.constant 8 : i64
-      %c1572864 = arith.constant 1572864 : i64
-      aiex.npu.dma_memcpy_nd (0, 0, %a[%c1,%c0,%c0,%c0][%c1,%c1,%c1,%c2][%c1572864,%c0,%c0,%c1]) { metadata = @objectfifo, id = 0 : i64 } : memref<8xi32>
-      // expected-error@+1 {{Stride 3 exceeds the [1:1048576] range.}}
-      aiex.npu.dma_memcpy_nd (0, 0, %a[%c1,%c0,%c0,%c0][%c2,%c1,%c1,%c2][%c1572864,%c0,%c0,%c1]) { metadata = @objectfifo, id = 1 : i64 } : memref<8xi32>
-    }
-    aie.shim_dma_allocation @objectfifo (MM2S, 0, 0)
-  }
-}
-
-// -----
-
 // packet header id limit
 
 module {
@@ -319,7 +319,10 @@ for c in config.vitis_components:
 
 tools = [
     "aie-opt",
+    "aie-trace-decode",
     "aie-translate",
+    "aie-txn-replay",
+    "aie-visualize",
     "aiecc.py",
     "ld.lld",
     "llc",
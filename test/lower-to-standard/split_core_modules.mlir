@@ -0,0 +1,59 @@
+//===- split_core_modules.mlir ---------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t && aie-opt --aie-split-core-modules="output-dir=%t" %s | FileCheck --check-prefix=DESIGN %s
+// RUN: FileCheck --check-prefixes=CHECKALL,CHECK33 --input-file=%t/core_3_3.mlir %s
+// RUN: FileCheck --check-prefixes=CHECKALL,CHECK43 --input-file=%t/core_4_3.mlir %s
+
+// The design itself is left unchanged.
+// DESIGN:      aie.core(%{{.*}})
+// DESIGN:      aie.core(%{{.*}})
+// DESIGN:      aie.mem(%{{.*}})
+
+// CHECKALL:        memref.global "public" @a : memref<4xi32>
+// CHECKALL-NOT:    aie.mem
+// CHECKALL-NOT:    aie.dma_bd
+
+// CHECK33-LABEL:   func.func @core_3_3() {
+// CHECK33:           %[[A:.*]] = memref.get_global @a : memref<4xi32>
+// CHECK33:           memref.store %{{.*}}, %[[A]][%{{.*}}] : memref<4xi32>
+// CHECK33-NOT:     func.func @core_4_3
+
+// CHECK43-NOT:     func.func @core_3_3
+// CHECK43-LABEL:   func.func @core_4_3() {
+// CHECK43:           %[[A:.*]] = memref.get_global @a : memref<4xi32>
+// CHECK43:           memref.load %[[A]][%{{.*}}] : memref<4xi32>
+
+module @codegen1 {
+ aie.device(xcvc1902) {
+  %t33 = aie.tile(3, 3)
+  %t43 = aie.tile(4, 3)
+  %a = aie.buffer(%t33) { sym_name = "a" } : memref<4xi32>
+  %core33 = aie.core(%t33) {
+    %0 = arith.constant 0 : index
+    %377 = arith.constant 377 : i32
+    memref.store %377, %a[%0] : memref<4xi32>
+    aie.end
+  }
+  %core43 = aie.core(%t43) {
+    %0 = arith.constant 0 : index
+    %1 = memref.load %a[%0] : memref<4xi32>
+    aie.end
+  }
+  %mem33 = aie.mem(%t33) {
+    %dma = aie.dma_start(MM2S, 0, ^bd0, ^end)
+  ^bd0:
+    aie.dma_bd(%a : memref<4xi32>, 0, 4)
+    aie.next_bd ^bd0
+  ^end:
+    aie.end
+  }
+ }
+}
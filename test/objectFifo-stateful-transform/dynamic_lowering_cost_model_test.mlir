@@ -0,0 +1,104 @@
+//===- dynamic_lowering_cost_model_test.mlir --------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-stateful-transform="unroll-budget=16" %s | FileCheck %s
+// RUN: aie-opt --aie-objectFifo-stateful-transform %s | FileCheck %s --check-prefix=UNROLL
+
+// The loop of core_0_2 must be unrolled 6 times for objectFifos of sizes 2 and
+// 3, which does not fit in the budget: its objectFifos are indexed at runtime.
+// The loop of core_0_4 only needs one more copy of its body.
+
+// CHECK:     %core_0_2 = aie.core(%tile_0_2) {
+// CHECK:       scf.for %{{.*}} = %{{.*}} to %{{.*}} step %c1{{.*}} {
+// CHECK:         aie.use_lock(%output_fifo_prod_lock, AcquireGreaterEqual, 1)
+// CHECK:         memref.load %[[INDICES:.*]][%{{.*}}] : memref<2xi32>
+// CHECK:         scf.index_switch
+// CHECK:         case 0 {
+// CHECK:           scf.yield %output_fifo_buff_0 : memref<10xi32>
+// CHECK:         case 1 {
+// CHECK:           scf.yield %output_fifo_buff_1 : memref<10xi32>
+// CHECK:         case 2 {
+// CHECK:           scf.yield %output_fifo_buff_2 : memref<10xi32>
+// CHECK:         aie.use_lock(%input_fifo_cons_cons_lock, AcquireGreaterEqual, 1)
+// CHECK:         memref.load %[[INDICES]][%{{.*}}] : memref<2xi32>
+// CHECK:         scf.index_switch
+// CHECK:         func.call @passthrough_10_i32
+// CHECK-NOT:     func.call @passthrough_10_i32
+// CHECK:       }
+// CHECK:       aie.end
+// CHECK:     }
+// CHECK:     %core_0_4 = aie.core(%tile_0_4) {
+// CHECK-NOT:   scf.index_switch
+// CHECK:       scf.for %{{.*}} = %{{.*}} to %{{.*}} step %c2 {
+// CHECK:         func.call @passthrough_10_i32(%input_fifo2_cons_buff_0, %output_fifo2_buff_0)
+// CHECK:         func.call @passthrough_10_i32(%input_fifo2_cons_buff_1, %output_fifo2_buff_1)
+// CHECK:       }
+
+// Without a budget, the cost model is off and both loops are unrolled.
+
+// UNROLL:     %core_0_2 = aie.core(%tile_0_2) {
+// UNROLL-NOT:   scf.index_switch
+// UNROLL:       scf.for %{{.*}} = %{{.*}} to %{{.*}} step %c6 {
+// UNROLL:     %core_0_4 = aie.core(%tile_0_4) {
+// UNROLL-NOT:   scf.index_switch
+// UNROLL:       scf.for %{{.*}} = %{{.*}} to %{{.*}} step %c2 {
+
+module {
+  aie.device(npu1_1col) {
+    func.func @passthrough_10_i32(%line_in: memref<10xi32>, %line_out: memref<10xi32>) -> () {
+        return
+    }
+
+    %tile_0_0 = aie.tile(0, 0)
+    %tile_0_2 = aie.tile(0, 2)
+    %tile_0_4 = aie.tile(0, 4)
+    aie.objectfifo @input_fifo(%tile_0_0, {%tile_0_2}, 2 : i32) : !aie.objectfifo<memref<10xi32>>
+    aie.objectfifo @output_fifo(%tile_0_2, {%tile_0_0}, [3, 2]) : !aie.objectfifo<memref<10xi32>>
+
+    aie.objectfifo @input_fifo2(%tile_0_0, {%tile_0_4}, 2 : i32) : !aie.objectfifo<memref<10xi32>>
+    aie.objectfifo @output_fifo2(%tile_0_4, {%tile_0_0}, 2 : i32) : !aie.objectfifo<memref<10xi32>>
+
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c12 = arith.constant 12 : index
+
+      scf.for %arg0 = %c0 to %c12 step %c1 {
+        %0 = aie.objectfifo.acquire @output_fifo(Produce, 1) : !aie.objectfifosubview<memref<10xi32>>
+        %1 = aie.objectfifo.subview.access %0[0] : !aie.objectfifosubview<memref<10xi32>> -> memref<10xi32>
+        %2 = aie.objectfifo.acquire @input_fifo(Consume, 1) : !aie.objectfifosubview<memref<10xi32>>
+        %3 = aie.objectfifo.subview.access %2[0] : !aie.objectfifosubview<memref<10xi32>> -> memref<10xi32>
+        func.call @passthrough_10_i32(%3, %1) : (memref<10xi32>, memref<10xi32>) -> ()
+        aie.objectfifo.release @input_fifo(Consume, 1)
+        aie.objectfifo.release @output_fifo(Produce, 1)
+      }
+
+      aie.end
+    }
+
+    %core_0_4 = aie.core(%tile_0_4) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c10 = arith.constant 10 : index
+
+      scf.for %arg0 = %c0 to %c10 step %c1 {
+        %0 = aie.objectfifo.acquire @output_fifo2(Produce, 1) : !aie.objectfifosubview<memref<10xi32>>
+        %1 = aie.objectfifo.subview.access %0[0] : !aie.objectfifosubview<memref<10xi32>> -> memref<10xi32>
+        %2 = aie.objectfifo.acquire @input_fifo2(Consume, 1) : !aie.objectfifosubview<memref<10xi32>>
+        %3 = aie.objectfifo.subview.access %2[0] : !aie.objectfifosubview<memref<10xi32>> -> memref<10xi32>
+        func.call @passthrough_10_i32(%3, %1) : (memref<10xi32>, memref<10xi32>) -> ()
+        aie.objectfifo.release @input_fifo2(Consume, 1)
+        aie.objectfifo.release @output_fifo2(Produce, 1)
+      }
+
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,221 @@
+//===- reuse_buffers_test.mlir ---------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-stateful-transform="reuse-core-objFifo-buffers=true" --split-input-file %s | FileCheck %s
+// RUN: aie-opt --aie-objectFifo-stateful-transform --split-input-file %s | FileCheck %s --check-prefix=NOREUSE
+
+// @layer1 is dead once @layer0 is, so it takes over its buffers. @layer2 has
+// another element type, and @acc is live during the whole core body. @shared
+// is written once @layer0 and @layer1 are dead, and then read through shared
+// memory by a tile without a core, so it takes over one of their buffers
+// although it stays live. @out is read by a DMA and keeps its own buffer.
+
+// CHECK-LABEL:   aie.device(xcve2302) {
+// CHECK-DAG:       %[[L0_0:.*]] = aie.buffer(%{{.*}}) {sym_name = "layer0_buff_0"} : memref<16xi32>
+// CHECK-DAG:       %[[L0_1:.*]] = aie.buffer(%{{.*}}) {sym_name = "layer0_buff_1"} : memref<16xi32>
+// CHECK-DAG:       %[[L2_0:.*]] = aie.buffer(%{{.*}}) {sym_name = "layer2_buff_0"} : memref<8xi32>
+// CHECK-DAG:       %[[ACC_0:.*]] = aie.buffer(%{{.*}}) {sym_name = "acc_buff_0"} : memref<16xi32>
+// CHECK-DAG:       %[[OUT_0:.*]] = aie.buffer(%{{.*}}) {sym_name = "out_buff_0"} : memref<16xi32>
+// CHECK-NOT:       sym_name = "layer1_buff
+// CHECK-NOT:       sym_name = "shared_buff
+// CHECK:           aie.core
+// CHECK:             func.call @compute(%[[L0_0]], %[[ACC_0]])
+// CHECK:             func.call @compute(%[[L0_0]], %[[ACC_0]])
+// CHECK:             func.call @compute(%[[L0_0]], %[[ACC_0]])
+// CHECK:             func.call @compute(%[[L0_0]], %[[ACC_0]])
+// CHECK:             func.call @compute(%[[OUT_0]], %[[ACC_0]])
+// CHECK:             func.call @compute8(%[[L2_0]])
+// CHECK:             aie.end
+
+// NOREUSE-DAG:     aie.buffer(%{{.*}}) {sym_name = "layer1_buff_0"} : memref<16xi32>
+// NOREUSE-DAG:     aie.buffer(%{{.*}}) {sym_name = "layer1_buff_1"} : memref<16xi32>
+// NOREUSE-DAG:     aie.buffer(%{{.*}}) {sym_name = "shared_buff_0"} : memref<16xi32>
+
+module @reuse_buffers {
+  aie.device(xcve2302) {
+    %tile12 = aie.tile(1, 2)
+    %tile13 = aie.tile(1, 3)
+    %tile33 = aie.tile(3, 3)
+
+    aie.objectfifo @acc (%tile12, {%tile12}, 1 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo @layer0 (%tile12, {%tile12}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo @layer1 (%tile12, {%tile12}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo @layer2 (%tile12, {%tile12}, 1 : i32) : !aie.objectfifo<memref<8xi32>>
+    aie.objectfifo @shared (%tile12, {%tile13}, 1 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo @out (%tile12, {%tile33}, 1 : i32) : !aie.objectfifo<memref<16xi32>>
+
+    func.func @compute(%in : memref<16xi32>, %acc : memref<16xi32>) -> () {
+      return
+    }
+    func.func @compute8(%in : memref<8xi32>) -> () {
+      return
+    }
+
+    %core12 = aie.core(%tile12) {
+      %acc_sv = aie.objectfifo.acquire @acc (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %acc_elem = aie.objectfifo.subview.access %acc_sv[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+
+      %sv0 = aie.objectfifo.acquire @layer0 (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %elem0 = aie.objectfifo.subview.access %sv0[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      func.call @compute(%elem0, %acc_elem) : (memref<16xi32>, memref<16xi32>) -> ()
+      aie.objectfifo.release @layer0 (Produce, 1)
+      %sv1 = aie.objectfifo.acquire @layer0 (Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %elem1 = aie.objectfifo.subview.access %sv1[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      func.call @compute(%elem1, %acc_elem) : (memref<16xi32>, memref<16xi32>) -> ()
+      aie.objectfifo.release @layer0 (Consume, 1)
+
+      %sv2 = aie.objectfifo.acquire @layer1 (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %elem2 = aie.objectfifo.subview.access %sv2[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      func.call @compute(%elem2, %acc_elem) : (memref<16xi32>, memref<16xi32>) -> ()
+      aie.objectfifo.release @layer1 (Produce, 1)
+
+      %sv4 = aie.objectfifo.acquire @shared (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %elem4 = aie.objectfifo.subview.access %sv4[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      func.call @compute(%elem4, %acc_elem) : (memref<16xi32>, memref<16xi32>) -> ()
+      aie.objectfifo.release @shared (Produce, 1)
+
+      %sv5 = aie.objectfifo.acquire @out (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %elem5 = aie.objectfifo.subview.access %sv5[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      func.call @compute(%elem5, %acc_elem) : (memref<16xi32>, memref<16xi32>) -> ()
+      aie.objectfifo.release @out (Produce, 1)
+
+      %sv3 = aie.objectfifo.acquire @layer2 (Produce, 1) : !aie.objectfifosubview<memref<8xi32>>
+      %elem3 = aie.objectfifo.subview.access %sv3[0] : !aie.objectfifosubview<memref<8xi32>> -> memref<8xi32>
+      func.call @compute8(%elem3) : (memref<8xi32>) -> ()
+      aie.objectfifo.release @layer2 (Produce, 1)
+
+      aie.objectfifo.release @acc (Produce, 1)
+      aie.end
+    }
+  }
+}
+
+// -----
+
+// All the acquires and releases of @layer0 and @layer1 are in the loop body,
+// which they leave empty at every iteration: @layer1 is dead once @layer0 is
+// in each iteration, so it takes over its buffer.
+
+// CHECK-LABEL:   aie.device(xcve2302) {
+// CHECK:           %[[L0_0:.*]] = aie.buffer(%{{.*}}) {sym_name = "layer0_buff_0"} : memref<16xi32>
+// CHECK-NOT:       sym_name = "layer1_buff
+// CHECK:           aie.core
+// CHECK:             scf.for
+// CHECK:               func.call @compute(%[[L0_0]])
+// CHECK:               func.call @compute(%[[L0_0]])
+// CHECK:               func.call @compute(%[[L0_0]])
+// CHECK:               func.call @compute(%[[L0_0]])
+// CHECK:             aie.end
+
+// NOREUSE-DAG:     aie.buffer(%{{.*}}) {sym_name = "layer1_buff_0"} : memref<16xi32>
+
+module @reuse_buffers_loop {
+  aie.device(xcve2302) {
+    %tile12 = aie.tile(1, 2)
+
+    aie.objectfifo @layer0 (%tile12, {%tile12}, 1 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo @layer1 (%tile12, {%tile12}, 1 : i32) : !aie.objectfifo<memref<16xi32>>
+
+    func.func @compute(%buf : memref<16xi32>) -> () {
+      return
+    }
+
+    %core12 = aie.core(%tile12) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c8 = arith.constant 8 : index
+      scf.for %i = %c0 to %c8 step %c1 {
+        %sv0 = aie.objectfifo.acquire @layer0 (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+        %elem0 = aie.objectfifo.subview.access %sv0[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+        func.call @compute(%elem0) : (memref<16xi32>) -> ()
+        aie.objectfifo.release @layer0 (Produce, 1)
+        %sv1 = aie.objectfifo.acquire @layer0 (Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+        %elem1 = aie.objectfifo.subview.access %sv1[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+        func.call @compute(%elem1) : (memref<16xi32>) -> ()
+        aie.objectfifo.release @layer0 (Consume, 1)
+
+        %sv2 = aie.objectfifo.acquire @layer1 (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+        %elem2 = aie.objectfifo.subview.access %sv2[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+        func.call @compute(%elem2) : (memref<16xi32>) -> ()
+        aie.objectfifo.release @layer1 (Produce, 1)
+        %sv3 = aie.objectfifo.acquire @layer1 (Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+        %elem3 = aie.objectfifo.subview.access %sv3[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+        func.call @compute(%elem3) : (memref<16xi32>) -> ()
+        aie.objectfifo.release @layer1 (Consume, 1)
+      }
+      aie.end
+    }
+  }
+}
+
+// -----
+
+// @in is written by the core of tile(2, 2) in the memory of tile(1, 2), and
+// read by the core of tile(1, 2). @out is written by the core of tile(1, 2) in
+// its own memory, and read by the core of tile(1, 3). The core of tile(1, 2)
+// releases every element of @in that is produced before it first acquires
+// @out, so @out takes over the buffer of @in.
+
+// CHECK-LABEL:   aie.device(xcve2302) {
+// CHECK:           %[[TILE12:.*]] = aie.tile(1, 2)
+// CHECK:           %[[IN_0:.*]] = aie.buffer(%[[TILE12]]) {sym_name = "in_buff_0"} : memref<16xi32>
+// CHECK-NOT:       sym_name = "out_buff
+// CHECK:           aie.core(%{{.*}}) {
+// CHECK:             func.call @compute(%[[IN_0]])
+// CHECK:           aie.core(%{{.*}}) {
+// CHECK:             func.call @compute(%[[IN_0]])
+// CHECK:             func.call @compute(%[[IN_0]])
+// CHECK:           aie.core(%{{.*}}) {
+// CHECK:             func.call @compute(%[[IN_0]])
+
+// NOREUSE-DAG:     aie.buffer(%{{.*}}) {sym_name = "out_buff_0"} : memref<16xi32>
+
+module @reuse_buffers_shared {
+  aie.device(xcve2302) {
+    %tile12 = aie.tile(1, 2)
+    %tile13 = aie.tile(1, 3)
+    %tile22 = aie.tile(2, 2)
+
+    aie.objectfifo @in (%tile22, {%tile12}, 1 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo @out (%tile12, {%tile13}, 1 : i32) : !aie.objectfifo<memref<16xi32>>
+
+    func.func @compute(%buf : memref<16xi32>) -> () {
+      return
+    }
+
+    %core22 = aie.core(%tile22) {
+      %sv0 = aie.objectfifo.acquire @in (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %elem0 = aie.objectfifo.subview.access %sv0[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      func.call @compute(%elem0) : (memref<16xi32>) -> ()
+      aie.objectfifo.release @in (Produce, 1)
+      aie.end
+    }
+
+    %core12 = aie.core(%tile12) {
+      %sv1 = aie.objectfifo.acquire @in (Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %elem1 = aie.objectfifo.subview.access %sv1[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      func.call @compute(%elem1) : (memref<16xi32>) -> ()
+      aie.objectfifo.release @in (Consume, 1)
+      %sv2 = aie.objectfifo.acquire @out (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %elem2 = aie.objectfifo.subview.access %sv2[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      func.call @compute(%elem2) : (memref<16xi32>) -> ()
+      aie.objectfifo.release @out (Produce, 1)
+      aie.end
+    }
+
+    %core13 = aie.core(%tile13) {
+      %sv3 = aie.objectfifo.acquire @out (Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %elem3 = aie.objectfifo.subview.access %sv3[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      func.call @compute(%elem3) : (memref<16xi32>) -> ()
+      aie.objectfifo.release @out (Consume, 1)
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,129 @@
+//===- optimize_npu_writes.mlir --------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --split-input-file -aie-optimize-npu-writes %s | FileCheck %s
+
+// Consecutive write32s are merged up to the next barrier; identical payloads
+// share one global.
+
+// CHECK-LABEL: aie.device(npu1_4col)
+// CHECK:   memref.global "private" constant @blockwrite_data_0 : memref<3xi32> = dense<[1, 2, 3]>
+// CHECK-NOT: memref.global
+// CHECK:   aiex.runtime_sequence
+// CHECK:     %[[D0:.*]] = memref.get_global @blockwrite_data_0 : memref<3xi32>
+// CHECK:     aiex.npu.blockwrite(%[[D0]]) {address = 118784 : ui32} : memref<3xi32>
+// CHECK:     aiex.npu.sync
+// CHECK:     aiex.npu.write32 {address = 118796 : ui32, value = 4 : ui32}
+// CHECK:     %[[D1:.*]] = memref.get_global @blockwrite_data_0 : memref<3xi32>
+// CHECK:     aiex.npu.blockwrite(%[[D1]]) {address = 118784 : ui32, column = 0 : i32, row = 2 : i32} : memref<3xi32>
+// CHECK-NOT: aiex.npu.write32
+module {
+  aie.device(npu1_4col) {
+    aiex.runtime_sequence() {
+      aiex.npu.write32 {address = 0x1D000 : ui32, value = 1 : ui32}
+      aiex.npu.write32 {address = 0x1D004 : ui32, value = 2 : ui32}
+      aiex.npu.write32 {address = 0x1D008 : ui32, value = 3 : ui32}
+      aiex.npu.sync {channel = 0 : i32, column = 0 : i32, column_num = 1 : i32, direction = 0 : i32, row = 0 : i32, row_num = 1 : i32}
+      aiex.npu.write32 {address = 0x1D00C : ui32, value = 4 : ui32}
+      aiex.npu.sync {channel = 0 : i32, column = 0 : i32, column_num = 1 : i32, direction = 0 : i32, row = 0 : i32, row_num = 1 : i32}
+      aiex.npu.write32 {column = 0 : i32, row = 2 : i32, address = 0x1D000 : ui32, value = 1 : ui32}
+      aiex.npu.write32 {address = 0x21D004 : ui32, value = 2 : ui32}
+      aiex.npu.write32 {column = 0 : i32, row = 2 : i32, address = 0x1D008 : ui32, value = 3 : ui32}
+    }
+  }
+}
+
+// -----
+
+// Overwritten writes are dropped and mask writes are folded, but only within
+// a window without barriers.
+
+// CHECK-LABEL: aie.device(npu1_4col)
+// CHECK:   aiex.runtime_sequence
+// CHECK-NEXT: aiex.npu.write32 {address = 118816 : ui32, value = 5 : ui32}
+// CHECK-NEXT: aiex.npu.write32 {address = 118784 : ui32, value = 2 : ui32}
+// CHECK-NEXT: aiex.npu.write32 {address = 118848 : ui32, value = 245 : ui32}
+// CHECK-NEXT: aiex.npu.maskwrite32 {address = 118880 : ui32, mask = 255 : ui32, value = 17 : ui32}
+// CHECK-NEXT: aiex.npu.maskwrite32 {address = 118912 : ui32, mask = 15 : ui32, value = 1 : ui32}
+// CHECK-NEXT: aiex.npu.maskwrite32 {address = 118912 : ui32, mask = 15 : ui32, value = 256 : ui32}
+// CHECK-NEXT: aiex.npu.address_patch
+// CHECK-NEXT: aiex.npu.write32 {address = 118784 : ui32, value = 3 : ui32}
+// CHECK-NEXT: }
+module {
+  aie.device(npu1_4col) {
+    aiex.runtime_sequence() {
+      aiex.npu.write32 {address = 0x1D000 : ui32, value = 1 : ui32}
+      aiex.npu.write32 {address = 0x1D020 : ui32, value = 5 : ui32}
+      aiex.npu.write32 {address = 0x1D000 : ui32, value = 2 : ui32}
+      aiex.npu.write32 {address = 0x1D040 : ui32, value = 0xF0 : ui32}
+      aiex.npu.maskwrite32 {address = 0x1D040 : ui32, value = 0x5 : ui32, mask = 0xF : ui32}
+      aiex.npu.maskwrite32 {address = 0x1D060 : ui32, value = 0x10 : ui32, mask = 0xF0 : ui32}
+      aiex.npu.maskwrite32 {address = 0x1D060 : ui32, value = 0x1 : ui32, mask = 0xF : ui32}
+      aiex.npu.maskwrite32 {address = 0x1D080 : ui32, value = 0x1 : ui32, mask = 0xF : ui32}
+      aiex.npu.maskwrite32 {address = 0x1D080 : ui32, value = 0x100 : ui32, mask = 0xF : ui32}
+      aiex.npu.address_patch {addr = 0x1D004 : ui32, arg_idx = 0 : i32, arg_plus = 0 : i32}
+      aiex.npu.write32 {address = 0x1D000 : ui32, value = 3 : ui32}
+    }
+  }
+}
+
+// -----
+
+// Writes to the DMA task queues are neither dropped nor merged.
+
+// CHECK-LABEL: aie.device(npu1_4col)
+// CHECK-NOT:   memref.global
+// CHECK:       aiex.npu.write32 {address = 119316 : ui32, column = 0 : i32, row = 0 : i32, value = 1 : ui32}
+// CHECK-NEXT:  aiex.npu.write32 {address = 119316 : ui32, column = 0 : i32, row = 0 : i32, value = 1 : ui32}
+// CHECK-NEXT:  aiex.npu.write32 {address = 119320 : ui32, column = 0 : i32, row = 0 : i32, value = 0 : ui32}
+// CHECK-NEXT:  aiex.npu.write32 {address = 119324 : ui32, column = 0 : i32, row = 0 : i32, value = 2 : ui32}
+module {
+  aie.device(npu1_4col) {
+    aiex.runtime_sequence() {
+      aiex.npu.write32 {column = 0 : i32, row = 0 : i32, address = 0x1D214 : ui32, value = 1 : ui32}
+      aiex.npu.write32 {column = 0 : i32, row = 0 : i32, address = 0x1D214 : ui32, value = 1 : ui32}
+      aiex.npu.write32 {column = 0 : i32, row = 0 : i32, address = 0x1D218 : ui32, value = 0 : ui32}
+      aiex.npu.write32 {column = 0 : i32, row = 0 : i32, address = 0x1D21C : ui32, value = 2 : ui32}
+    }
+  }
+}
+
+// -----
+
+// Core control, DMA channel control and event generation writes are pulses or
+// triggers: repeated writes to them are kept, and they are barriers for the
+// writes to the BDs around them.
+
+// CHECK-LABEL: aie.device(npu1_4col)
+// CHECK:       aiex.npu.write32 {address = 2301952 : ui32, value = 0 : ui32}
+// CHECK-NEXT:  aiex.npu.write32 {address = 2301952 : ui32, value = 1 : ui32}
+// CHECK-NEXT:  aiex.npu.write32 {address = 2219520 : ui32, value = 2 : ui32}
+// CHECK-NEXT:  aiex.npu.write32 {address = 2219520 : ui32, value = 0 : ui32}
+// CHECK-NEXT:  aiex.npu.write32 {address = 2310152 : ui32, value = 127 : ui32}
+// CHECK-NEXT:  aiex.npu.write32 {address = 2310152 : ui32, value = 127 : ui32}
+// CHECK-NEXT:  aiex.npu.write32 {address = 2215936 : ui32, value = 1 : ui32}
+// CHECK-NEXT:  aiex.npu.write32 {address = 2301952 : ui32, value = 1 : ui32}
+// CHECK-NEXT:  aiex.npu.write32 {address = 2215936 : ui32, value = 2 : ui32}
+// CHECK-NEXT:  }
+module {
+  aie.device(npu1_4col) {
+    aiex.runtime_sequence() {
+      aiex.npu.write32 {address = 0x232000 : ui32, value = 0 : ui32}
+      aiex.npu.write32 {address = 0x232000 : ui32, value = 1 : ui32}
+      aiex.npu.write32 {address = 0x21DE00 : ui32, value = 2 : ui32}
+      aiex.npu.write32 {address = 0x21DE00 : ui32, value = 0 : ui32}
+      aiex.npu.write32 {address = 0x234008 : ui32, value = 127 : ui32}
+      aiex.npu.write32 {address = 0x234008 : ui32, value = 127 : ui32}
+      aiex.npu.write32 {address = 0x21D000 : ui32, value = 1 : ui32}
+      aiex.npu.write32 {address = 0x232000 : ui32, value = 1 : ui32}
+      aiex.npu.write32 {address = 0x21D000 : ui32, value = 2 : ui32}
+    }
+  }
+}
@@ -0,0 +1,40 @@
+//===- optimize_transaction.mlir -------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// The configuration of a core disables, resets and enables it, and resets and
+// unresets its DMA channels around loading the ELF. None of these writes to
+// the core control register (0x232000) and the control register of the first
+// DMA channel (0x21DE00) may be dropped.
+
+// RUN: aie-opt -convert-aie-to-transaction="elf-dir=%S/../Conversion/AIEToConfiguration/convert_aie_to_ctrl_pkts_elfs/" %s -o %t.txn
+// RUN: aie-opt -aie-optimize-npu-writes %t.txn -o %t.opt
+// RUN: grep -c "{address = 2301952 :" %t.txn > %t.core.txn
+// RUN: grep -c "{address = 2301952 :" %t.opt > %t.core.opt
+// RUN: diff %t.core.txn %t.core.opt
+// RUN: grep -c "{address = 2219520 :" %t.txn > %t.dma.txn
+// RUN: grep -c "{address = 2219520 :" %t.opt > %t.dma.opt
+// RUN: diff %t.dma.txn %t.dma.opt
+// RUN: FileCheck %s < %t.opt
+
+// CHECK:       aiex.runtime_sequence @configure
+// CHECK:       {address = 2219520 : ui32
+// CHECK:       {address = 2219520 : ui32
+// CHECK:       {address = 2301952 : ui32
+// CHECK:       {address = 2301952 : ui32
+aie.device(npu1_1col) {
+  %12 = aie.tile(0, 2)
+  %buf = aie.buffer(%12) : memref<256xi32>
+  %4 = aie.core(%12)  {
+    %0 = arith.constant 0 : i32
+    %1 = arith.constant 0 : index
+    memref.store %0, %buf[%1] : memref<256xi32>
+    aie.end
+  }
+}
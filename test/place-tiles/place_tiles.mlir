@@ -0,0 +1,71 @@
+//===- place_tiles.mlir ----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --pass-pipeline="builtin.module(aie.device(aie-place-tiles{fixed-tiles=0:2}))" %s | FileCheck %s
+// RUN: aie-opt --pass-pipeline="builtin.module(aie.device(aie-place-tiles{fixed-tiles=0:2,3:0}))" %s | FileCheck %s --check-prefix=FIXED
+
+// The shim and mem tiles move to the column of the core.
+
+// CHECK-LABEL: module @column
+// CHECK-DAG:     %[[SHIM:.*]] = aie.tile(0, 0)
+// CHECK-DAG:     %[[MEM:.*]] = aie.tile(0, 1)
+// CHECK-DAG:     %[[CORE:.*]] = aie.tile(0, 2)
+// CHECK:         aie.objectfifo @in(%[[SHIM]], {%[[MEM]]}, 2 : i32)
+// CHECK:         aie.objectfifo @in2(%[[MEM]], {%[[CORE]]}, 2 : i32)
+// CHECK:         aie.objectfifo @out(%[[CORE]], {%[[SHIM]]}, 2 : i32)
+// CHECK:         aie.core(%[[CORE]])
+
+// FIXED-LABEL: module @column
+// FIXED-DAG:     aie.tile(3, 0)
+// FIXED-DAG:     aie.tile(0, 2)
+module @column {
+  aie.device(npu1_4col) {
+    %shim = aie.tile(3, 0)
+    %mem = aie.tile(3, 1)
+    %core = aie.tile(0, 2)
+    aie.objectfifo @in(%shim, {%mem}, 2 : i32) : !aie.objectfifo<memref<256xi32>>
+    aie.objectfifo @in2(%mem, {%core}, 2 : i32) : !aie.objectfifo<memref<256xi32>>
+    aie.objectfifo.link [@in] -> [@in2] ([] [])
+    aie.objectfifo @out(%core, {%shim}, 2 : i32) : !aie.objectfifo<memref<256xi32>>
+    aie.core(%core) {
+      aie.end
+    }
+  }
+}
+
+
+// The core at (0, 3) uses a buffer and a lock of the tile below it, so both
+// stay in place while the shim tile moves to their column.
+
+// CHECK-LABEL: module @shared_memory
+// CHECK-DAG:     %[[SHIM:.*]] = aie.tile(0, 0)
+// CHECK-DAG:     %[[CORE0:.*]] = aie.tile(0, 2)
+// CHECK-DAG:     %[[CORE1:.*]] = aie.tile(0, 3)
+// CHECK:         aie.objectfifo @in(%[[SHIM]], {%[[CORE1]]}, 2 : i32)
+module @shared_memory {
+  aie.device(npu1_4col) {
+    %shim = aie.tile(3, 0)
+    %core0 = aie.tile(0, 2)
+    %core1 = aie.tile(0, 3)
+    %buf = aie.buffer(%core0) : memref<256xi32>
+    %lock = aie.lock(%core0, 0)
+    aie.objectfifo @in(%shim, {%core1}, 2 : i32) : !aie.objectfifo<memref<256xi32>>
+    aie.core(%core0) {
+      aie.end
+    }
+    aie.core(%core1) {
+      aie.use_lock(%lock, AcquireGreaterEqual, 1)
+      %c0 = arith.constant 0 : index
+      %v = memref.load %buf[%c0] : memref<256xi32>
+      aie.use_lock(%lock, Release, 1)
+      aie.end
+    }
+  }
+}
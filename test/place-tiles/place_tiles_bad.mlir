@@ -0,0 +1,46 @@
+//===- place_tiles_bad.mlir ------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --split-input-file --verify-diagnostics --aie-place-tiles %s
+// RUN: not aie-opt --pass-pipeline="builtin.module(aie.device(aie-place-tiles{fixed-tiles=3}))" %s 2>&1 | FileCheck %s --check-prefix=FIXED
+
+// FIXED: expected a tile as <col>:<row> in fixed-tiles, got 3
+
+// The shim tile has two MM2S channels wherever it is placed.
+
+module @channels {
+  // expected-error@+1 {{no placement found within the resources of the device: 1 DMA channels and 0 bytes of memory over}}
+  aie.device(npu1_4col) {
+    %shim = aie.tile(1, 0)
+    %core0 = aie.tile(1, 2)
+    %core1 = aie.tile(1, 3)
+    %core2 = aie.tile(1, 4)
+    aie.objectfifo @a(%shim, {%core0}, 2 : i32) : !aie.objectfifo<memref<256xi32>>
+    aie.objectfifo @b(%shim, {%core1}, 2 : i32) : !aie.objectfifo<memref<256xi32>>
+    aie.objectfifo @c(%shim, {%core2}, 2 : i32) : !aie.objectfifo<memref<256xi32>>
+  }
+}
+
+// -----
+
+// 70400 bytes of buffers and a stack of 1024 bytes do not fit in the 64 KiB
+// of a core tile.
+
+module @memory {
+  // expected-error@+1 {{no placement found within the resources of the device: 0 DMA channels and 5888 bytes of memory over}}
+  aie.device(npu1_4col) {
+    %core = aie.tile(0, 2)
+    %buf = aie.buffer(%core) : memref<17600xi32>
+    aie.core(%core) {
+      aie.end
+    }
+  }
+}
+
@@ -0,0 +1,173 @@
+//===- schedule_runtime_sequence.mlir --------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --split-input-file --aie-schedule-runtime-sequence="assume-distinct-buffers=true" %s | FileCheck %s
+// RUN: aie-opt --split-input-file --aie-schedule-runtime-sequence %s | FileCheck %s --check-prefix=SAFE
+
+// The transfers of the second column do not depend on those of the first, so
+// they are issued before waiting for the first. Unless the arguments are
+// known to be distinct buffers, the second column may read what the first
+// writes, and the wait stays in place.
+
+// CHECK-LABEL: aiex.runtime_sequence
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %arg0
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %arg2
+// CHECK:     aiex.npu.dma_memcpy_nd(1, 0, %arg1
+// CHECK:     aiex.npu.dma_memcpy_nd(1, 0, %arg3
+// CHECK:     aiex.npu.dma_wait {symbol = @out0}
+// CHECK:     aiex.npu.dma_wait {symbol = @out1}
+
+// SAFE-LABEL: aiex.runtime_sequence
+// SAFE:     aiex.npu.dma_memcpy_nd(0, 0, %arg0
+// SAFE:     aiex.npu.dma_memcpy_nd(0, 0, %arg2
+// SAFE:     aiex.npu.dma_wait {symbol = @out0}
+// SAFE:     aiex.npu.dma_memcpy_nd(1, 0, %arg1
+// SAFE:     aiex.npu.dma_memcpy_nd(1, 0, %arg3
+// SAFE:     aiex.npu.dma_wait {symbol = @out1}
+module {
+  aie.device(npu1_4col) {
+    aie.shim_dma_allocation @in0 (MM2S, 0, 0)
+    aie.shim_dma_allocation @out0 (S2MM, 0, 0)
+    aie.shim_dma_allocation @in1 (MM2S, 0, 1)
+    aie.shim_dma_allocation @out1 (S2MM, 0, 1)
+    aiex.runtime_sequence(%arg0: memref<16xi32>, %arg1: memref<16xi32>, %arg2: memref<16xi32>, %arg3: memref<16xi32>) {
+      aiex.npu.dma_memcpy_nd (0, 0, %arg0[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @in0, id = 0 : i64 } : memref<16xi32>
+      aiex.npu.dma_memcpy_nd (0, 0, %arg2[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @out0, id = 1 : i64, issue_token = true } : memref<16xi32>
+      aiex.npu.dma_wait {symbol = @out0}
+      aiex.npu.dma_memcpy_nd (1, 0, %arg1[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @in1, id = 0 : i64 } : memref<16xi32>
+      aiex.npu.dma_memcpy_nd (1, 0, %arg3[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @out1, id = 1 : i64, issue_token = true } : memref<16xi32>
+      aiex.npu.dma_wait {symbol = @out1}
+    }
+  }
+}
+
+// -----
+
+// Waiting on the output is what guarantees that BD 0 of the input is done, so
+// the wait stays before BD 0 is reprogrammed, even on another channel.
+
+// CHECK-LABEL: aiex.runtime_sequence
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %arg0{{.*}}id = 0
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %arg2
+// CHECK:     aiex.npu.dma_wait {symbol = @out0}
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %arg1{{.*}}id = 0
+
+// SAFE-LABEL: aiex.runtime_sequence
+// SAFE:     aiex.npu.dma_wait {symbol = @out0}
+// SAFE:     aiex.npu.dma_memcpy_nd(0, 0, %arg1{{.*}}id = 0
+module {
+  aie.device(npu1_4col) {
+    aie.shim_dma_allocation @in0 (MM2S, 0, 0)
+    aie.shim_dma_allocation @in1 (MM2S, 1, 0)
+    aie.shim_dma_allocation @out0 (S2MM, 0, 0)
+    aiex.runtime_sequence(%arg0: memref<16xi32>, %arg1: memref<16xi32>, %arg2: memref<16xi32>) {
+      aiex.npu.dma_memcpy_nd (0, 0, %arg0[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @in0, id = 0 : i64 } : memref<16xi32>
+      aiex.npu.dma_memcpy_nd (0, 0, %arg2[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @out0, id = 1 : i64, issue_token = true } : memref<16xi32>
+      aiex.npu.dma_wait {symbol = @out0}
+      aiex.npu.dma_memcpy_nd (0, 0, %arg1[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @in1, id = 0 : i64 } : memref<16xi32>
+    }
+  }
+}
+
+// -----
+
+// The wait on the input completes its transfer, so BD 0 may be reprogrammed
+// by a transfer issued before the wait on the output.
+
+// CHECK-LABEL: aiex.runtime_sequence
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %arg0{{.*}}id = 0
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %arg2{{.*}}id = 1
+// CHECK:     aiex.npu.dma_wait {symbol = @in0}
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %arg1{{.*}}id = 0
+// CHECK:     aiex.npu.dma_wait {symbol = @out0}
+
+// SAFE-LABEL: aiex.runtime_sequence
+// SAFE:     aiex.npu.dma_memcpy_nd(0, 0, %arg0{{.*}}id = 0
+// SAFE:     aiex.npu.dma_wait {symbol = @in0}
+// SAFE:     aiex.npu.dma_memcpy_nd(0, 0, %arg2{{.*}}id = 1
+// SAFE:     aiex.npu.dma_wait {symbol = @out0}
+// SAFE:     aiex.npu.dma_memcpy_nd(0, 0, %arg1{{.*}}id = 0
+module {
+  aie.device(npu1_4col) {
+    aie.shim_dma_allocation @in0 (MM2S, 0, 0)
+    aie.shim_dma_allocation @in1 (MM2S, 1, 0)
+    aie.shim_dma_allocation @out0 (S2MM, 0, 0)
+    aiex.runtime_sequence(%arg0: memref<16xi32>, %arg1: memref<16xi32>, %arg2: memref<16xi32>) {
+      aiex.npu.dma_memcpy_nd (0, 0, %arg0[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @in0, id = 0 : i64, issue_token = true } : memref<16xi32>
+      aiex.npu.dma_wait {symbol = @in0}
+      aiex.npu.dma_memcpy_nd (0, 0, %arg2[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @out0, id = 1 : i64, issue_token = true } : memref<16xi32>
+      aiex.npu.dma_wait {symbol = @out0}
+      aiex.npu.dma_memcpy_nd (0, 0, %arg1[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @in1, id = 0 : i64 } : memref<16xi32>
+    }
+  }
+}
+
+// -----
+
+// Reading back a buffer written by the waited transfer, or hitting any op
+// other than a transfer or a wait, keeps the wait in place. The transfer of
+// the second column behind the one reading back the buffer does not depend
+// on the wait, so it is hoisted above it instead, unless it may write what
+// the first column accesses.
+
+// CHECK-LABEL: aiex.runtime_sequence
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %arg1{{.*}}id = 1
+// CHECK:     aiex.npu.dma_memcpy_nd(1, 0, %arg2{{.*}}id = 3
+// CHECK:     aiex.npu.dma_wait {symbol = @out0}
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %arg1{{.*}}id = 2
+// CHECK:     aiex.npu.dma_wait {symbol = @out1}
+// CHECK:     aiex.npu.write32
+// CHECK:     aiex.npu.dma_memcpy_nd(1, 0, %arg3
+
+// SAFE-LABEL: aiex.runtime_sequence
+// SAFE:     aiex.npu.dma_memcpy_nd(0, 0, %arg1{{.*}}id = 1
+// SAFE:     aiex.npu.dma_wait {symbol = @out0}
+// SAFE:     aiex.npu.dma_memcpy_nd(0, 0, %arg1{{.*}}id = 2
+// SAFE:     aiex.npu.dma_memcpy_nd(1, 0, %arg2{{.*}}id = 3
+// SAFE:     aiex.npu.dma_wait {symbol = @out1}
+module {
+  aie.device(npu1_4col) {
+    aie.shim_dma_allocation @in0 (MM2S, 0, 0)
+    aie.shim_dma_allocation @out0 (S2MM, 0, 0)
+    aie.shim_dma_allocation @in1 (MM2S, 0, 1)
+    aie.shim_dma_allocation @out1 (S2MM, 0, 1)
+    aiex.runtime_sequence(%arg0: memref<16xi32>, %arg1: memref<16xi32>, %arg2: memref<16xi32>, %arg3: memref<16xi32>) {
+      aiex.npu.dma_memcpy_nd (0, 0, %arg1[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @out0, id = 1 : i64, issue_token = true } : memref<16xi32>
+      aiex.npu.dma_wait {symbol = @out0}
+      aiex.npu.dma_memcpy_nd (0, 0, %arg1[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @in0, id = 2 : i64 } : memref<16xi32>
+      aiex.npu.dma_memcpy_nd (1, 0, %arg2[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @out1, id = 3 : i64, issue_token = true } : memref<16xi32>
+      aiex.npu.dma_wait {symbol = @out1}
+      aiex.npu.write32 {address = 0x1A000 : ui32, value = 1 : ui32}
+      aiex.npu.dma_memcpy_nd (1, 0, %arg3[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @in1, id = 0 : i64 } : memref<16xi32>
+    }
+  }
+}
+
+// -----
+
+// A view of a buffer overlaps with the buffer, so reading the buffer waits
+// for the transfer writing the view.
+
+// CHECK-LABEL: aiex.runtime_sequence
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %[[VIEW:.*]][
+// CHECK:     aiex.npu.dma_wait {symbol = @out0}
+// CHECK:     aiex.npu.dma_memcpy_nd(1, 0, %arg0
+module {
+  aie.device(npu1_4col) {
+    aie.shim_dma_allocation @out0 (S2MM, 0, 0)
+    aie.shim_dma_allocation @in1 (MM2S, 0, 1)
+    aiex.runtime_sequence(%arg0: memref<16xi32>) {
+      %view = memref.subview %arg0[8] [8] [1] : memref<16xi32> to memref<8xi32, strided<[1], offset: 8>>
+      aiex.npu.dma_memcpy_nd (0, 0, %view[0, 0, 0, 0][1, 1, 1, 8][0, 0, 0, 1]) { metadata = @out0, id = 1 : i64, issue_token = true } : memref<8xi32, strided<[1], offset: 8>>
+      aiex.npu.dma_wait {symbol = @out0}
+      aiex.npu.dma_memcpy_nd (1, 0, %arg0[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @in1, id = 0 : i64 } : memref<16xi32>
+    }
+  }
+}
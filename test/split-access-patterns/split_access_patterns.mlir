@@ -0,0 +1,119 @@
+//===- split_access_patterns.mlir ------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --split-input-file -aie-split-access-patterns %s | FileCheck %s
+
+// Transfers fitting into a BD are left as they are, and contiguous rows fold
+// into a single linear transfer.
+
+// CHECK-LABEL: aiex.runtime_sequence
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %arg0[0, 0, 0, 0][1, 1, 32, 32][0, 0, 64, 1]) {id = 0 : i64
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %arg1[0, 0, 0, 0][1, 1, 1, 2073600][0, 0, 0, 1]) {id = 1 : i64
+// CHECK-NOT: aiex.npu.dma_memcpy_nd
+module {
+  aie.device(npu1_4col) {
+    aie.shim_dma_allocation @in0 (MM2S, 0, 0)
+    aie.shim_dma_allocation @in1 (MM2S, 1, 0)
+    aiex.runtime_sequence(%arg0: memref<64x64xi32>, %arg1: memref<1080x1920xi32>) {
+      aiex.npu.dma_memcpy_nd (0, 0, %arg0[0, 0, 0, 0][1, 1, 32, 32][0, 0, 64, 1]) { metadata = @in0, id = 0 : i64 } : memref<64x64xi32>
+      aiex.npu.dma_memcpy_nd (0, 0, %arg1[0, 0, 0, 0][1, 1, 1080, 1920][0, 0, 1920, 1]) { metadata = @in1, id = 1 : i64 } : memref<1080x1920xi32>
+    }
+  }
+}
+
+// -----
+
+// Rows longer than the wrap of the innermost dimension are split into the
+// longest bursts fitting into it, still in a single BD.
+
+// CHECK-LABEL: aiex.runtime_sequence
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %arg0[0, 0, 0, 0][1, 2048, 2, 550][0, 2048, 550, 1]) {id = 0 : i64
+// CHECK-NOT: aiex.npu.dma_memcpy_nd
+module {
+  aie.device(npu1_4col) {
+    aie.shim_dma_allocation @in0 (MM2S, 0, 0)
+    aiex.runtime_sequence(%arg0: memref<2048x2048xi32>) {
+      aiex.npu.dma_memcpy_nd (0, 0, %arg0[0, 0, 0, 0][1, 1, 2048, 1100][0, 0, 2048, 1]) { metadata = @in0, id = 0 : i64 } : memref<2048x2048xi32>
+    }
+  }
+}
+
+// -----
+
+// Repeats beyond the iteration limit take a second BD.
+
+// CHECK-LABEL: aiex.runtime_sequence
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %arg0[0, 0, 0, 0][64, 1, 1, 32][0, 0, 0, 1]) {id = 0 : i64
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %arg0[0, 0, 0, 0][64, 1, 1, 32][0, 0, 0, 1]) {id = 1 : i64
+// CHECK-NOT: aiex.npu.dma_memcpy_nd
+module {
+  aie.device(npu1_4col) {
+    aie.shim_dma_allocation @in0 (MM2S, 0, 0)
+    aiex.runtime_sequence(%arg0: memref<128x4x2x8xi32>) {
+      aiex.npu.dma_memcpy_nd (0, 0, %arg0[0, 0, 0, 0][128, 2, 2, 8][0, 16, 8, 1]) { metadata = @in0, id = 0 : i64 } : memref<128x4x2x8xi32>
+    }
+  }
+}
+
+// -----
+
+// Strides beyond the step of the BD are unrolled into transfers on BD IDs not
+// used in the column; the queue of the channel is drained before it overflows,
+// and only the last transfer issues the token of the original one.
+
+// CHECK-LABEL: aiex.runtime_sequence
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %arg1
+// CHECK-SAME:  id = 1 : i64
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %arg0[0, 0, 0, 0][1, 1, 1, 256][0, 0, 0, 1]) {id = 0 : i64
+// CHECK-NOT:   issue_token = true
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %arg0[0, 0, 0, 2097152][1, 1, 1, 256][0, 0, 0, 1]) {id = 2 : i64
+// CHECK-NOT:   issue_token = true
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %arg0[0, 0, 0, 4194304][1, 1, 1, 256][0, 0, 0, 1]) {id = 3 : i64
+// CHECK-NOT:   issue_token = true
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %arg0[0, 0, 0, 6291456][1, 1, 1, 256][0, 0, 0, 1]) {id = 4 : i64, issue_token = true
+// CHECK-NEXT: aiex.npu.dma_wait {symbol = @in0}
+// CHECK-NEXT: aiex.npu.dma_memcpy_nd(0, 0, %arg0[0, 0, 0, 8388608][1, 1, 1, 256][0, 0, 0, 1]) {id = 0 : i64
+// CHECK-NOT:   issue_token = true
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %arg0[0, 0, 0, 10485760][1, 1, 1, 256][0, 0, 0, 1]) {id = 2 : i64, issue_token = true
+// CHECK-NEXT: aiex.npu.dma_wait {symbol = @in0}
+module {
+  aie.device(npu1_4col) {
+    aie.shim_dma_allocation @in0 (MM2S, 0, 0)
+    aie.shim_dma_allocation @in1 (MM2S, 1, 0)
+    aiex.runtime_sequence(%arg0: memref<12582912xi32>, %arg1: memref<16xi32>) {
+      aiex.npu.dma_memcpy_nd (0, 0, %arg1[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @in1, id = 1 : i64 } : memref<16xi32>
+      aiex.npu.dma_memcpy_nd (0, 0, %arg0[0, 0, 0, 0][1, 1, 6, 256][0, 0, 2097152, 1]) { metadata = @in0, id = 0 : i64, issue_token = true } : memref<12582912xi32>
+      aiex.npu.dma_wait {symbol = @in0}
+    }
+  }
+}
+
+// -----
+
+// A wait between the transfers could complete the token of an earlier transfer
+// on the channel instead, so transfers needing one are left as they are while
+// such a token is outstanding.
+
+// CHECK-LABEL: aiex.runtime_sequence
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %arg1
+// CHECK:     aiex.npu.dma_memcpy_nd(0, 0, %arg0[0, 0, 0, 0][1, 1, 6, 256][0, 0, 2097152, 1]) {id = 0 : i64, issue_token = true
+// CHECK-NEXT: aiex.npu.dma_wait {symbol = @in0}
+// CHECK-NEXT: aiex.npu.dma_wait {symbol = @in0}
+module {
+  aie.device(npu1_4col) {
+    aie.shim_dma_allocation @in0 (MM2S, 0, 0)
+    aiex.runtime_sequence(%arg0: memref<12582912xi32>, %arg1: memref<16xi32>) {
+      aiex.npu.dma_memcpy_nd (0, 0, %arg1[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @in0, id = 1 : i64, issue_token = true } : memref<16xi32>
+      aiex.npu.dma_memcpy_nd (0, 0, %arg0[0, 0, 0, 0][1, 1, 6, 256][0, 0, 2097152, 1]) { metadata = @in0, id = 0 : i64, issue_token = true } : memref<12582912xi32>
+      aiex.npu.dma_wait {symbol = @in0}
+      aiex.npu.dma_wait {symbol = @in0}
+    }
+  }
+}
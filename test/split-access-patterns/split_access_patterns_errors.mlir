@@ -0,0 +1,59 @@
+//===- split_access_patterns_errors.mlir -----------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --split-input-file --verify-diagnostics -aie-split-access-patterns %s
+
+// The rows of 300 words exceed the 8-bit wrap of a core tile BD.
+
+aie.device(npu1_4col) {
+  %tile_0_2 = aie.tile(0, 2)
+  %buf = aie.buffer(%tile_0_2) : memref<600xi32>
+  %mem = aie.mem(%tile_0_2) {
+    %0 = aie.dma_start(MM2S, 0, ^bb1, ^bb2)
+  ^bb1:
+    // expected-error @below {{access pattern exceeds the wrap and step fields of the BDs of tile (0, 2)}}
+    aie.dma_bd(%buf : memref<600xi32>, 0, 600, [<size = 2, stride = 300>, <size = 300, stride = 1>])
+    aie.next_bd ^bb1
+  ^bb2:
+    aie.end
+  }
+}
+
+// -----
+
+// Steps of a memtile BD are limited to 17 bits, in 32-bit words.
+
+aie.device(npu1_4col) {
+  %tile_0_1 = aie.tile(0, 1)
+  %buf = aie.buffer(%tile_0_1) : memref<262144xi32>
+  %memtile_dma = aie.memtile_dma(%tile_0_1) {
+    %0 = aie.dma_start(MM2S, 0, ^bb1, ^bb2)
+  ^bb1:
+    // expected-error @below {{access pattern exceeds the wrap and step fields of the BDs of tile (0, 1)}}
+    aie.dma_bd(%buf : memref<262144xi32>, 0, 32, [<size = 2, stride = 262000>, <size = 16, stride = 1>])
+    aie.next_bd ^bb1
+  ^bb2:
+    aie.end
+  }
+}
+
+// -----
+
+aie.device(npu1_4col) {
+  aie.shim_dma_allocation @in0 (MM2S, 0, 0)
+  aiex.runtime_sequence(%arg0: memref<8xi32>) {
+    // expected-error @below {{Repeat count exceeds the [0:255] range.}}
+    %t = aiex.dma_configure_task_for @in0 {
+      aie.dma_bd(%arg0 : memref<8xi32>, 0, 8) {bd_id = 0 : i32}
+      aie.end
+    } {repeat_count = 256 : i32}
+    aiex.dma_start_task(%t)
+  }
+}
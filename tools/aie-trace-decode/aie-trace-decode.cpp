@@ -0,0 +1,132 @@
+//===- aie-trace-decode.cpp -------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc. All rights reserved.
+//
+//===----------------------------------------------------------------------===//
+
+// This tool decodes the trace packets an AIE2 design writes to its trace
+// buffer into a Chrome/Perfetto JSON trace, as parse_trace.py does, naming
+// the events from the npu.write32 ops configuring them in the design. The
+// trace is read either raw or as text of hexadecimal words separated by
+// whitespace, e.g. one per line as write_out_trace in python/utils/trace.py
+// writes it, and the events are written as the trace is decoded.
+
+#include "aie/InitialAllDialect.h"
+#include "aie/Targets/AIETraceDecoder.h"
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/ControlFlow/IR/ControlFlow.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/Math/IR/Math.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/IR/OwningOpRef.h"
+#include "mlir/Parser/Parser.h"
+
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <cstring>
+
+using namespace llvm;
+using namespace mlir;
+using namespace xilinx;
+
+static cl::opt<std::string> traceFilename(cl::Positional, cl::Required,
+                                          cl::desc("<trace>"));
+
+static cl::opt<std::string>
+    mlirFilename("mlir", cl::Required,
+                 cl::desc("Design configuring the traced events"));
+
+static cl::opt<int> colShift("colshift",
+                             cl::desc("Column shift of the traced tiles "
+                                      "relative to the design"),
+                             cl::init(0));
+
+static cl::opt<std::string> outputFilename("o", cl::desc("Output filename"),
+                                           cl::value_desc("filename"),
+                                           cl::init("-"));
+
+// Decodes the trace in `data`, as text if it only holds hexadecimal words.
+static LogicalResult decodeTrace(StringRef data, AIE::TraceDecoder &decoder) {
+  bool isText = llvm::all_of(
+      data, [](char c) { return llvm::isHexDigit(c) || llvm::isSpace(c); });
+  if (!isText) {
+    for (size_t i = 0; i + sizeof(uint32_t) <= data.size();
+         i += sizeof(uint32_t)) {
+      uint32_t word;
+      std::memcpy(&word, data.data() + i, sizeof(word));
+      decoder.decode(word);
+    }
+    return success();
+  }
+
+  for (data = data.ltrim(); !data.empty(); data = data.ltrim()) {
+    StringRef token = data.take_front(data.find_first_of(" \t\n\v\f\r"));
+    data = data.drop_front(token.size());
+    uint32_t word;
+    if (token.getAsInteger(16, word))
+      return failure();
+    decoder.decode(word);
+  }
+  return success();
+}
+
+int main(int argc, char *argv[]) {
+  InitLLVM y(argc, argv);
+  cl::ParseCommandLineOptions(argc, argv, "AIE trace decoder\n");
+
+  DialectRegistry registry;
+  registry.insert<arith::ArithDialect, cf::ControlFlowDialect,
+                  func::FuncDialect, math::MathDialect, memref::MemRefDialect,
+                  scf::SCFDialect, vector::VectorDialect>();
+  xilinx::registerAllDialects(registry);
+  MLIRContext context(registry);
+  SourceMgr sourceMgr;
+  OwningOpRef<ModuleOp> module =
+      parseSourceFile<ModuleOp>(mlirFilename, sourceMgr, &context);
+  if (!module)
+    return 1;
+
+  auto trace = MemoryBuffer::getFileOrSTDIN(traceFilename);
+  if (std::error_code ec = trace.getError()) {
+    errs() << "Could not open " << traceFilename << ": " << ec.message()
+           << "\n";
+    return 1;
+  }
+
+  std::error_code ec;
+  ToolOutputFile output(outputFilename, ec, sys::fs::OF_None);
+  if (ec) {
+    errs() << "Could not open " << outputFilename << ": " << ec.message()
+           << "\n";
+    return 1;
+  }
+
+  AIE::TraceDecoder decoder(output.os());
+  decoder.configure(*module, colShift);
+  if (failed(decodeTrace((*trace)->getBuffer(), decoder))) {
+    errs() << "Malformed hexadecimal word in " << traceFilename << "\n";
+    return 1;
+  }
+  decoder.finish();
+  output.keep();
+
+  for (auto [type, tile] : decoder.getUnconfiguredStreams())
+    errs() << "warning: no trace events configured for packet type "
+           << static_cast<unsigned>(type) << " of tile (" << tile.col << ", "
+           << tile.row << "), its packets were skipped\n";
+  return 0;
+}
@@ -0,0 +1,115 @@
+//===- aie-txn-replay.cpp ---------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc. All rights reserved.
+//
+//===----------------------------------------------------------------------===//
+
+// This tool replays NPU transaction binaries, in order, on a register-level
+// model of the device and reports the registers they leave configured, with
+// the BDs and the locks decoded, and what the writes cost. The binaries are
+// read either raw or as text with one hexadecimal word per line, as
+// aie-translate --aie-npu-instgen produces them.
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Targets/AIETransactionReplay.h"
+
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <vector>
+
+using namespace llvm;
+using namespace xilinx;
+
+static cl::list<std::string> inputFilenames(cl::Positional, cl::OneOrMore,
+                                            cl::desc("<transaction binaries>"));
+
+static cl::opt<std::string>
+    deviceName("device",
+               cl::desc("Device the transactions target, by default the npu1 "
+                        "device with as many columns as the first header"),
+               cl::init(""));
+
+// Returns the bytes of a transaction binary, converting it from text if it
+// only holds hexadecimal words.
+static std::optional<std::vector<uint8_t>> readTransaction(StringRef data) {
+  bool isText = llvm::all_of(
+      data, [](char c) { return llvm::isHexDigit(c) || llvm::isSpace(c); });
+  if (!isText)
+    return std::vector<uint8_t>(data.bytes_begin(), data.bytes_end());
+
+  std::vector<uint8_t> bytes;
+  SmallVector<StringRef> words;
+  data.split(words, '\n', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+  for (StringRef word : words) {
+    word = word.trim();
+    if (word.empty())
+      continue;
+    uint32_t value;
+    if (word.getAsInteger(16, value))
+      return std::nullopt;
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(&value);
+    bytes.insert(bytes.end(), p, p + sizeof(value));
+  }
+  return bytes;
+}
+
+int main(int argc, char *argv[]) {
+  InitLLVM y(argc, argv);
+  cl::ParseCommandLineOptions(argc, argv, "AIE transaction replay\n");
+
+  std::vector<std::vector<uint8_t>> transactions;
+  for (const std::string &filename : inputFilenames) {
+    auto buffer = MemoryBuffer::getFileOrSTDIN(filename);
+    if (std::error_code ec = buffer.getError()) {
+      errs() << "Could not open " << filename << ": " << ec.message() << "\n";
+      return 1;
+    }
+    auto transaction = readTransaction((*buffer)->getBuffer());
+    if (!transaction) {
+      errs() << "Malformed hexadecimal word in " << filename << "\n";
+      return 1;
+    }
+    transactions.push_back(std::move(*transaction));
+  }
+
+  std::optional<AIE::AIEDevice> device;
+  if (!deviceName.empty()) {
+    device = AIE::symbolizeAIEDevice(deviceName);
+    if (!device) {
+      errs() << "Unknown device " << deviceName << "\n";
+      return 1;
+    }
+  } else {
+    std::optional<AIE::TransactionHeader> header =
+        AIE::parseTransactionHeader(transactions.front());
+    std::vector<AIE::AIEDevice> devices{
+        AIE::AIEDevice::npu1_1col, AIE::AIEDevice::npu1_2col,
+        AIE::AIEDevice::npu1_3col, AIE::AIEDevice::npu1_4col,
+        AIE::AIEDevice::npu1};
+    if (!header || header->numCols < 1 || header->numCols > devices.size()) {
+      errs() << "Cannot infer the device from the transaction header, use "
+                "--device\n";
+      return 1;
+    }
+    device = devices[header->numCols - 1];
+  }
+
+  AIE::TransactionReplay replay(AIE::getTargetModel(*device));
+  for (auto [filename, transaction] :
+       llvm::zip_equal(inputFilenames, transactions)) {
+    if (failed(replay.replay(transaction))) {
+      errs() << "Failed to replay " << filename << "\n";
+      return 1;
+    }
+  }
+  replay.print(outs());
+  return 0;
+}
@@ -9,7 +9,9 @@
 //===---------------------------------------------------------------------===//
 
 // This tool generates a simple visualization of a design, showing the
-// device layout and highlighting which device tiles are being used.
+// device layout and highlighting which device tiles are being used. Given the
+// routing report of aie-create-pathfinder-flows, it also draws the usage of
+// the switchboxes as a heatmap.
 
 #include "aie/Dialect/AIE/Transforms/AIEPasses.h"
 #include "aie/Dialect/AIEX/Transforms/AIEXPasses.h"
@@ -35,10 +37,12 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/SourceMgr.h"
 
+#include <cmath>
 #include <iostream>
 #include <regex>
 #include <stdlib.h>
@@ -51,6 +55,25 @@ using namespace xilinx;
 cl::opt<std::string> FileName(cl::Positional, cl::desc("<input mlir>"),
                               cl::Required);
 
+cl::opt<std::string> ReportFileName(
+    "routing-report",
+    cl::desc("Routing report of aie-create-pathfinder-flows to draw"),
+    cl::value_desc("filename"));
+
+enum class HeatmapKind { Ports, Links, Sharing, Congestion };
+
+cl::opt<HeatmapKind> Heatmap(
+    "heatmap", cl::desc("Switchbox usage drawn from the routing report"),
+    cl::values(clEnumValN(HeatmapKind::Ports, "ports",
+                          "Fraction of the output ports used"),
+               clEnumValN(HeatmapKind::Links, "links",
+                          "Fraction of the channels to neighbors used"),
+               clEnumValN(HeatmapKind::Sharing, "sharing",
+                          "Most packet flows sharing a channel"),
+               clEnumValN(HeatmapKind::Congestion, "congestion",
+                          "Over capacity history of the channels")),
+    cl::init(HeatmapKind::Links));
+
 const std::string bold("\033[0;1m");
 const std::string dim("\033[0;2m");
 const std::string red("\033[0;31m");
@@ -63,6 +86,126 @@ const std::string bwhite("\033[0;47m");
 const std::string reset("\033[0m");
 const std::string bgray("\033[48;5;239m");
 
+static void printColumnNumbers(int columns) {
+  std::cout << reset << "  ";
+  for (int col = 0; col < columns; col++)
+    std::cout << col % 10;
+  std::cout << "\n";
+
+  std::cout << "  ";
+  for (int col = 0; col < columns; col++) {
+    int coltens = col / 10;
+    if (coltens > 0)
+      std::cout << coltens;
+    else
+      std::cout << " ";
+  }
+  std::cout << "\n";
+}
+
+static const char *heatmapTitle() {
+  switch (Heatmap) {
+  case HeatmapKind::Ports:
+    return "port usage";
+  case HeatmapKind::Links:
+    return "link usage";
+  case HeatmapKind::Sharing:
+    return "packet sharing";
+  case HeatmapKind::Congestion:
+    return "congestion";
+  }
+  llvm_unreachable("unknown heatmap");
+}
+
+// Draw the switchbox usage of the routing report as digits from 0, unused,
+// to 9, fully used or as contended as the most contended switchbox.
+static bool printHeatmap(const AIE::AIETargetModel &model) {
+  auto buffer = MemoryBuffer::getFile(ReportFileName);
+  if (!buffer) {
+    std::cerr << "Could not open " << ReportFileName << "\n";
+    return false;
+  }
+  auto report = json::parse((*buffer)->getBuffer());
+  if (!report) {
+    consumeError(report.takeError());
+    std::cerr << "Malformed routing report " << ReportFileName << "\n";
+    return false;
+  }
+  const json::Object *object = report->getAsObject();
+  const json::Array *switchboxes =
+      object ? object->getArray("switchboxes") : nullptr;
+  if (!switchboxes) {
+    std::cerr << "Malformed routing report " << ReportFileName << "\n";
+    return false;
+  }
+
+  // negative where the report has no switchbox
+  std::vector<double> heat(model.columns() * model.rows(), -1.0);
+  double maxHeat = 0.0;
+  for (const json::Value &value : *switchboxes) {
+    const json::Object *sb = value.getAsObject();
+    if (!sb)
+      continue;
+    int64_t col = sb->getInteger("col").value_or(-1);
+    int64_t row = sb->getInteger("row").value_or(-1);
+    if (col < 0 || col >= model.columns() || row < 0 || row >= model.rows())
+      continue;
+    auto get = [&](StringRef key) {
+      return static_cast<double>(sb->getInteger(key).value_or(0));
+    };
+    auto fraction = [](double used, double total) {
+      return total > 0 ? used / total : 0.0;
+    };
+    double h = 0.0;
+    switch (Heatmap) {
+    case HeatmapKind::Ports:
+      h = fraction(get("usedPorts"), get("ports"));
+      break;
+    case HeatmapKind::Links:
+      h = fraction(get("usedLinks"), get("links"));
+      break;
+    case HeatmapKind::Sharing:
+      h = get("maxPacketSharing");
+      break;
+    case HeatmapKind::Congestion:
+      h = get("overCapacity");
+      break;
+    }
+    heat[col + model.columns() * row] = h;
+    maxHeat = std::max(maxHeat, h);
+  }
+  bool isFraction =
+      Heatmap == HeatmapKind::Ports || Heatmap == HeatmapKind::Links;
+  double scale = isFraction ? 1.0 : maxHeat;
+
+  std::cout << "\nSwitchbox " << heatmapTitle() << ", 9 = "
+            << (isFraction ? "all used" : std::to_string(int64_t(maxHeat)))
+            << "\n";
+  for (int row = model.rows() - 1; row >= 0; row--) {
+    std::cout << reset << row % 10 << " ";
+    for (int col = 0; col < model.columns(); col++) {
+      double h = heat[col + model.columns() * row];
+      if (h < 0) {
+        std::cout << dim << "." << reset;
+        continue;
+      }
+      int level = scale > 0 ? std::min(9, int(std::ceil(9 * h / scale))) : 0;
+      if (level == 0)
+        std::cout << dim;
+      else if (level <= 3)
+        std::cout << green;
+      else if (level <= 6)
+        std::cout << yellow;
+      else
+        std::cout << red;
+      std::cout << level << reset;
+    }
+    std::cout << "\n";
+  }
+  printColumnNumbers(model.columns());
+  return true;
+}
+
 int main(int argc, char *argv[]) {
   cl::ParseCommandLineOptions(argc, argv);
 
@@ -131,20 +274,10 @@ int main(int argc, char *argv[]) {
     std::cout << "\n";
   }
 
-  std::cout << reset << "  ";
-  for (int col = 0; col < model.columns(); col++)
-    std::cout << col % 10;
-  std::cout << "\n";
+  printColumnNumbers(model.columns());
 
-  std::cout << "  ";
-  for (int col = 0; col < model.columns(); col++) {
-    int coltens = col / 10;
-    if (coltens > 0)
-      std::cout << coltens;
-    else
-      std::cout << " ";
-  }
-  std::cout << "\n";
+  if (!ReportFileName.empty() && !printHeatmap(model))
+    return 3;
 
   return 0;
 }
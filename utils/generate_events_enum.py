@@ -1,12 +1,15 @@
 #!/usr/bin/env python3
 
 """
-Takes the xaie_events_aie.h header file from aie-rt and generates an 
+Takes the xaie_events_aie.h header file from aie-rt and generates an
 importable Python file containing an enum of all events.
 
-The generated enum is included in python/utils/trace_events_enum.py and 
+The generated enum is included in python/utils/trace_events_enum.py and
 used by the trace utilities in python/utils/trace.py and in
 programming_examples/utils/parse_trace.py
+
+With --cpp, the events are instead written as the X-macro list in
+include/aie/Targets/AIETraceEvents.inc used by the C++ trace decoder.
 """
 
 import sys, re, argparse, collections
@@ -33,6 +36,32 @@ class MemTileEvent(Enum):
 {mem_tile_items}
 """
 
+cpp_template = """//===- AIETraceEvents.inc ---------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Enumeration of AIE2 trace events
+// Automatically generated from utils/generate_events_enum.py --cpp
+//
+// AIE_TRACE_EVENT(Kind, Name, Code) with Kind one of Core, Mem, PL, MemTile.
+//
+//===----------------------------------------------------------------------===//
+
+{core_items}
+
+{mem_items}
+
+{pl_items}
+
+{mem_tile_items}
+
+#undef AIE_TRACE_EVENT
+"""
+
 core_regex = r"^\s*#define\s+XAIEML_EVENTS_CORE_([a-zA-Z0-9_]+)\s+(\d+)U\s*$"
 mem_regex = r"^\s*#define\s+XAIEML_EVENTS_MEM_(?!TILE)([a-zA-Z0-9_]+)\s+(\d+)U\s*$"
 pl_regex = r"^\s*#define\s+XAIEML_EVENTS_PL_([a-zA-Z0-9_]+)\s+(\d+)U\s*$"
@@ -54,10 +83,20 @@ def write_enum_items(dict):
     return "\n".join("    {} = {}".format(name, num) for num, name in dict.items())
 
 
+def write_cpp_items(kind, dict):
+    return "\n".join(
+        "AIE_TRACE_EVENT({}, {}, {})".format(kind, name, num)
+        for num, name in dict.items()
+    )
+
+
 def main():
     argparser = argparse.ArgumentParser()
     argparser.add_argument("-i", type=argparse.FileType("r"), default=sys.stdin)
     argparser.add_argument("-o", type=argparse.FileType("w"), default=sys.stdout)
+    argparser.add_argument(
+        "--cpp", action="store_true", help="emit the C++ X-macro list instead"
+    )
     args = argparser.parse_args()
 
     lines = args.i.readlines()
@@ -71,6 +110,17 @@ def main():
         parse_event_declaration(pl_regex, pl_events, line)
         parse_event_declaration(mem_tile_regex, mem_tile_events, line)
 
+    if args.cpp:
+        args.o.write(
+            cpp_template.format(
+                core_items=write_cpp_items("Core", core_events),
+                mem_items=write_cpp_items("Mem", mem_events),
+                pl_items=write_cpp_items("PL", pl_events),
+                mem_tile_items=write_cpp_items("MemTile", mem_tile_events),
+            )
+        )
+        return
+
     core_str = write_enum_items(core_events)
     mem_str = write_enum_items(mem_events)
     pl_str = write_enum_items(pl_events)